@@ -0,0 +1,173 @@
+#include "arena.h"
+#include <algorithm>
+#include <new>
+
+namespace bitrpc {
+
+namespace {
+
+// One cached block per thread, handed to the next arena created on that thread
+struct ThreadSlab {
+    void* block = nullptr;
+    ~ThreadSlab() {
+        if (block) {
+            ::operator delete(block);
+        }
+    }
+};
+
+thread_local ThreadSlab thread_slab;
+
+inline uintptr_t align_up(uintptr_t value, size_t alignment) {
+    return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+} // namespace
+
+RpcArena::RpcArena() : RpcArena(Options()) {}
+
+RpcArena::RpcArena(const Options& options)
+    : options_(options),
+      blocks_(nullptr),
+      first_block_(nullptr),
+      cursor_(nullptr),
+      limit_(nullptr),
+      cleanups_(nullptr),
+      next_block_size_(options.initial_block_size),
+      bytes_allocated_(0),
+      bytes_reserved_(0) {
+    if (options_.use_thread_local_slab && thread_slab.block) {
+        Block* block = static_cast<Block*>(thread_slab.block);
+        if (block->size >= options_.initial_block_size) {
+            thread_slab.block = nullptr;
+            use_block(block);
+            next_block_size_ = std::min(options_.initial_block_size * 2, options_.max_block_size);
+        }
+    }
+}
+
+RpcArena::~RpcArena() {
+    run_cleanups();
+    release_blocks(false);
+}
+
+void RpcArena::reset() {
+    run_cleanups();
+    release_blocks(true);
+    bytes_allocated_ = 0;
+    next_block_size_ = std::min(options_.initial_block_size * 2, options_.max_block_size);
+}
+
+void* RpcArena::do_allocate(size_t bytes, size_t alignment) {
+    if (cursor_) {
+        uintptr_t aligned = align_up(reinterpret_cast<uintptr_t>(cursor_), alignment);
+        if (aligned + bytes <= reinterpret_cast<uintptr_t>(limit_)) {
+            cursor_ = reinterpret_cast<uint8_t*>(aligned + bytes);
+            bytes_allocated_ += bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+    return allocate_slow(bytes, alignment);
+}
+
+void RpcArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    // Memory is reclaimed in bulk by reset()/destruction
+    (void)p;
+    (void)bytes;
+    (void)alignment;
+}
+
+bool RpcArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void* RpcArena::allocate_slow(size_t bytes, size_t alignment) {
+    size_t needed = bytes + alignment;
+
+    if (needed > options_.max_block_size && blocks_) {
+        // Oversized allocation gets its own block; keep bumping in the current one
+        Block* block = allocate_block(needed);
+        block->next = blocks_->next;
+        blocks_->next = block;
+        bytes_reserved_ += block->size;
+        bytes_allocated_ += bytes;
+        return reinterpret_cast<void*>(align_up(reinterpret_cast<uintptr_t>(block + 1), alignment));
+    }
+
+    size_t size = std::max(next_block_size_, needed);
+    next_block_size_ = std::min(next_block_size_ * 2, options_.max_block_size);
+    use_block(allocate_block(size));
+    return do_allocate(bytes, alignment);
+}
+
+void RpcArena::add_cleanup(void (*destroy)(void*), void* object) {
+    auto* cleanup = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+    cleanup->destroy = destroy;
+    cleanup->object = object;
+    cleanup->next = cleanups_;
+    cleanups_ = cleanup;
+}
+
+void RpcArena::run_cleanups() {
+    // Reverse creation order
+    while (cleanups_) {
+        Cleanup* cleanup = cleanups_;
+        cleanups_ = cleanup->next;
+        cleanup->destroy(cleanup->object);
+    }
+}
+
+void RpcArena::release_blocks(bool keep_first) {
+    // Only the first regular block survives; growth and oversized blocks go back to the heap
+    Block* first = first_block_;
+    Block* block = blocks_;
+    while (block) {
+        Block* next = block->next;
+        if (block != first) {
+            free_block(block);
+        }
+        block = next;
+    }
+
+    blocks_ = nullptr;
+    first_block_ = nullptr;
+    cursor_ = nullptr;
+    limit_ = nullptr;
+    bytes_reserved_ = 0;
+
+    if (!first) {
+        return;
+    }
+
+    if (keep_first) {
+        use_block(first);
+    } else if (options_.use_thread_local_slab && !thread_slab.block) {
+        thread_slab.block = first;
+    } else {
+        free_block(first);
+    }
+}
+
+void RpcArena::use_block(Block* block) {
+    if (!first_block_ && block->size <= options_.max_block_size) {
+        first_block_ = block;
+    }
+    block->next = blocks_;
+    blocks_ = block;
+    cursor_ = reinterpret_cast<uint8_t*>(block + 1);
+    limit_ = cursor_ + block->size;
+    bytes_reserved_ += block->size;
+}
+
+RpcArena::Block* RpcArena::allocate_block(size_t size) {
+    auto* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+    block->next = nullptr;
+    block->size = size;
+    return block;
+}
+
+void RpcArena::free_block(Block* block) {
+    ::operator delete(block);
+}
+
+} // namespace bitrpc
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace bitrpc {
+
+// Per-call bump allocator.
+// Everything allocated while serving one RPC (request payload, request object,
+// response buffer) comes from the arena and is released in one step when the
+// arena is reset or destroyed. Not thread-safe: one arena per call.
+class RpcArena : public std::pmr::memory_resource {
+public:
+    struct Options {
+        size_t initial_block_size = 16 * 1024;
+        size_t max_block_size = 1024 * 1024;
+        // Reuse the calling thread's first block across calls, so a steady-state
+        // request loop does not touch the global heap at all
+        bool use_thread_local_slab = true;
+    };
+
+    RpcArena();
+    explicit RpcArena(const Options& options);
+    ~RpcArena() override;
+
+    RpcArena(const RpcArena&) = delete;
+    RpcArena& operator=(const RpcArena&) = delete;
+
+    // Construct an object inside the arena. Allocator-aware types (std::pmr containers,
+    // generated messages with allocator_type) receive the arena as their allocator.
+    // Destructors of non-trivial types run on reset()/destruction.
+    template<typename T, typename... Args>
+    T* create(Args&&... args);
+
+    // Destroy created objects and rewind; the first block is kept for reuse,
+    // blocks larger than max_block_size are always freed
+    void reset();
+
+    size_t bytes_allocated() const { return bytes_allocated_; }
+    size_t bytes_reserved() const { return bytes_reserved_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;  // usable bytes following the header
+    };
+
+    struct Cleanup {
+        Cleanup* next;
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    template<typename T>
+    static void destroy_object(void* object) {
+        static_cast<T*>(object)->~T();
+    }
+
+    void* allocate_slow(size_t bytes, size_t alignment);
+    void add_cleanup(void (*destroy)(void*), void* object);
+    void run_cleanups();
+    void release_blocks(bool keep_first);
+    void use_block(Block* block);
+
+    static Block* allocate_block(size_t size);
+    static void free_block(Block* block);
+
+    Options options_;
+    Block* blocks_;  // most recent first
+    Block* first_block_;  // first block no larger than max_block_size; the one reset() keeps
+    uint8_t* cursor_;
+    uint8_t* limit_;
+    Cleanup* cleanups_;
+    size_t next_block_size_;
+    size_t bytes_allocated_;
+    size_t bytes_reserved_;
+};
+
+template<typename T, typename... Args>
+T* RpcArena::create(Args&&... args) {
+    void* memory = allocate(sizeof(T), alignof(T));
+    T* object = static_cast<T*>(memory);
+    std::pmr::polymorphic_allocator<T> allocator(this);
+    allocator.construct(object, std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+        add_cleanup(&RpcArena::destroy_object<T>, object);
+    }
+    return object;
+}
+
+} // namespace bitrpc
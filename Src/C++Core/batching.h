@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bitrpc {
+
+// How a batch method groups concurrent calls
+struct BatchPolicy {
+    // Upper bound on requests handed to one handler invocation
+    size_t max_batch_size = 64;
+    // How long the first request of a batch waits for company. This is added to the
+    // latency of every call that does not fill a batch; zero batches only what is
+    // already queued.
+    std::chrono::microseconds max_delay{1000};
+};
+
+struct BatchStatistics {
+    uint64_t batches = 0;
+    uint64_t requests = 0;
+    size_t largest_batch = 0;
+};
+
+// Type-erased view for statistics lookups
+class MethodBatcherBase {
+public:
+    virtual ~MethodBatcherBase() = default;
+    virtual BatchStatistics statistics() const = 0;
+};
+
+// Groups concurrent calls of one method across connection threads.
+// Each caller blocks in submit(). The first caller without an active leader becomes
+// the leader: it waits until max_batch_size requests are queued or max_delay has
+// passed, takes the batch, releases leadership (so the next batch can form while this
+// one runs) and invokes the handler once for the whole batch. Requests stay owned by
+// their callers, which are blocked until their response is filled in.
+template<typename TRequest, typename TResponse>
+class MethodBatcher : public MethodBatcherBase {
+public:
+    using Handler = std::function<std::vector<TResponse>(const std::vector<const TRequest*>& requests)>;
+
+    MethodBatcher(Handler handler, const BatchPolicy& policy)
+        : handler_(std::move(handler)), policy_(policy) {
+        if (policy_.max_batch_size == 0) {
+            throw std::invalid_argument("max_batch_size must be > 0");
+        }
+    }
+
+    TResponse submit(const TRequest& request);
+
+    BatchStatistics statistics() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+private:
+    struct Slot {
+        const TRequest* request = nullptr;
+        std::optional<TResponse> response;
+        std::exception_ptr error;
+        bool taken = false;
+        bool done = false;
+    };
+
+    // Called with the lock held; returns with it held
+    void lead(std::unique_lock<std::mutex>& lock);
+    void execute(const std::vector<Slot*>& batch);
+
+    Handler handler_;
+    BatchPolicy policy_;
+    mutable std::mutex mutex_;
+    std::condition_variable state_changed_;
+    std::vector<Slot*> pending_;
+    bool leader_active_ = false;
+    BatchStatistics statistics_;
+};
+
+template<typename TRequest, typename TResponse>
+TResponse MethodBatcher<TRequest, TResponse>::submit(const TRequest& request) {
+    Slot slot;
+    slot.request = &request;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.push_back(&slot);
+    if (pending_.size() >= policy_.max_batch_size) {
+        state_changed_.notify_all();
+    }
+
+    while (!slot.done) {
+        if (!leader_active_ && !slot.taken) {
+            lead(lock);
+            continue;
+        }
+        state_changed_.wait(lock);
+    }
+    lock.unlock();
+
+    if (slot.error) {
+        std::rethrow_exception(slot.error);
+    }
+    return std::move(*slot.response);
+}
+
+template<typename TRequest, typename TResponse>
+void MethodBatcher<TRequest, TResponse>::lead(std::unique_lock<std::mutex>& lock) {
+    leader_active_ = true;
+    if (policy_.max_delay.count() > 0) {
+        auto deadline = std::chrono::steady_clock::now() + policy_.max_delay;
+        state_changed_.wait_until(lock, deadline, [this]() { return pending_.size() >= policy_.max_batch_size; });
+    }
+
+    size_t count = std::min(pending_.size(), policy_.max_batch_size);
+    std::vector<Slot*> batch(pending_.begin(), pending_.begin() + count);
+    pending_.erase(pending_.begin(), pending_.begin() + count);
+    for (Slot* slot : batch) {
+        slot->taken = true;
+    }
+
+    statistics_.batches++;
+    statistics_.requests += count;
+    statistics_.largest_batch = std::max(statistics_.largest_batch, count);
+
+    // Whoever is still queued may lead the next batch while this one executes
+    leader_active_ = false;
+    state_changed_.notify_all();
+
+    lock.unlock();
+    execute(batch);
+    lock.lock();
+
+    for (Slot* slot : batch) {
+        slot->done = true;
+    }
+    state_changed_.notify_all();
+}
+
+template<typename TRequest, typename TResponse>
+void MethodBatcher<TRequest, TResponse>::execute(const std::vector<Slot*>& batch) {
+    std::vector<const TRequest*> requests;
+    requests.reserve(batch.size());
+    for (Slot* slot : batch) {
+        requests.push_back(slot->request);
+    }
+
+    try {
+        std::vector<TResponse> responses = handler_(requests);
+        if (responses.size() != batch.size()) {
+            throw std::runtime_error("Batch handler returned " + std::to_string(responses.size()) +
+                                     " responses for " + std::to_string(batch.size()) + " requests");
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batch[i]->response.emplace(std::move(responses[i]));
+        }
+    } catch (...) {
+        auto error = std::current_exception();
+        for (Slot* slot : batch) {
+            slot->error = error;
+        }
+    }
+}
+
+} // namespace bitrpc
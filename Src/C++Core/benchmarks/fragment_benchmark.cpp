@@ -0,0 +1,137 @@
+// FragmentCache benchmark.
+//
+//   fragment_benchmark [iterations] [users]
+//
+// Serializes an EchoResponse-shaped message holding `users` UserInfo entries (50 by
+// default), once with every UserInfo encoded field by field and once through
+// FragmentCache::write as a [fragment_cache] message does. The encoders mirror what the
+// generator emits for the Demo protocol, so the numbers compare the two code paths
+// without needing generated sources.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "fragment_cache.h"
+#include "serialization.h"
+
+using namespace bitrpc;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct UserInfo {
+    int64_t user_id = 0;
+    std::string username;
+    std::string email;
+    std::vector<std::string> roles;
+    bool is_active = false;
+    std::chrono::system_clock::time_point created_at;
+    FragmentIdentity fragment_identity;
+};
+
+struct EchoResponse {
+    std::string message;
+    int64_t timestamp = 0;
+    std::vector<UserInfo> users;
+    std::string server_time;
+};
+
+constexpr int kUserInfoHash = 1876671786;
+
+// Same shape as the generated UserInfoSerializer::write_fields
+void write_user_fields(const UserInfo& obj, StreamWriter& writer) {
+    uint32_t mask0 = 0;
+    if (obj.user_id != 0) mask0 |= (1u << 0);
+    if (!obj.username.empty()) mask0 |= (1u << 1);
+    if (!obj.email.empty()) mask0 |= (1u << 2);
+    if (!obj.roles.empty()) mask0 |= (1u << 3);
+    if (obj.is_active) mask0 |= (1u << 4);
+    if (obj.created_at != std::chrono::system_clock::time_point()) mask0 |= (1u << 5);
+    writer.write_uint32(mask0);
+    if (mask0 & (1u << 0)) { Int64Handler::instance().write(&obj.user_id, writer); }
+    if (mask0 & (1u << 1)) { StringHandler::instance().write(&obj.username, writer); }
+    if (mask0 & (1u << 2)) { StringHandler::instance().write(&obj.email, writer); }
+    if (mask0 & (1u << 3)) {
+        writer.write_vector_items(obj.roles, [&writer](const std::string& x) { StringHandler::instance().write(&x, writer); });
+    }
+    if (mask0 & (1u << 4)) { BoolHandler::instance().write(&obj.is_active, writer); }
+    if (mask0 & (1u << 5)) { DateTimeHandler::instance().write(&obj.created_at, writer); }
+}
+
+void write_user_cached(const UserInfo& obj, StreamWriter& writer) {
+    FragmentCache::instance().write(kUserInfoHash, obj.fragment_identity, writer,
+                                    [&obj](StreamWriter& fragment_writer) { write_user_fields(obj, fragment_writer); });
+}
+
+template<typename TWriteUser>
+void write_echo(const EchoResponse& obj, StreamWriter& writer, TWriteUser write_user) {
+    writer.write_uint32(0xF);
+    StringHandler::instance().write(&obj.message, writer);
+    Int64Handler::instance().write(&obj.timestamp, writer);
+    writer.write_vector_items(obj.users, [&](const UserInfo& user) { write_user(user, writer); });
+    StringHandler::instance().write(&obj.server_time, writer);
+}
+
+EchoResponse make_response(size_t users) {
+    EchoResponse response;
+    response.message = "echo";
+    response.timestamp = 1700000000;
+    response.server_time = "2024-01-01T00:00:00Z";
+    for (size_t i = 0; i < users; ++i) {
+        UserInfo user;
+        user.user_id = static_cast<int64_t>(i + 1);
+        user.username = "user" + std::to_string(i);
+        user.email = "user" + std::to_string(i) + "@example.com";
+        user.roles = {"reader", "writer"};
+        user.is_active = true;
+        user.created_at = std::chrono::system_clock::time_point(std::chrono::seconds(1600000000 + i));
+        user.fragment_identity.id = i + 1;
+        response.users.push_back(std::move(user));
+    }
+    return response;
+}
+
+template<typename TWriteUser>
+double measure(const char* name, const EchoResponse& response, size_t iterations, TWriteUser write_user) {
+    size_t bytes = 0;
+    // Warm-up also fills the fragment cache
+    for (size_t i = 0; i < 1000; ++i) {
+        StreamWriter writer;
+        write_echo(response, writer, write_user);
+        bytes = writer.size();
+    }
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        StreamWriter writer;
+        write_echo(response, writer, write_user);
+        bytes += writer.size();
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    std::printf("%-28s %10.1f ns/message (%zu bytes)\n", name, ns, bytes / (iterations + 1));
+    return ns;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    size_t users = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    EchoResponse response = make_response(users);
+    std::printf("EchoResponse with %zu users, %zu iterations\n", users, iterations);
+    double plain = measure("field-by-field", response, iterations, write_user_fields);
+    double cached = measure("fragment cache (hits)", response, iterations, write_user_cached);
+    std::printf("speedup %.2fx\n", plain / cached);
+
+    auto stats = FragmentCache::instance().stats();
+    std::printf("cache hits %llu misses %llu entries %zu\n", static_cast<unsigned long long>(stats.hits),
+                static_cast<unsigned long long>(stats.misses), stats.entries);
+    return 0;
+}
@@ -0,0 +1,294 @@
+// Handoff benchmarks for lockfree_queue.h and WorkerPool.
+//
+//   queue_benchmark [messages]
+//
+// Reports one-way handoff latency (SPSC ping-pong halved), throughput with and without
+// batching, MPSC throughput for 1/2/4 producers and a mutex + deque baseline. Pin the
+// process to distinct cores (taskset) for stable numbers.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "lockfree_queue.h"
+#include "worker_pool.h"
+
+using namespace bitrpc;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Spins, then yields so the benchmark still makes progress with fewer cores than threads
+void backoff(int& spins) {
+    if (++spins < 1024) {
+        detail::cpu_relax();
+    } else {
+        spins = 0;
+        std::this_thread::yield();
+    }
+}
+
+void report(const char* name, size_t messages, double ns) {
+    std::fflush(stdout);
+    std::printf("%-36s %10.1f ns/msg %10.2f Mmsg/s\n", name, ns / messages, messages * 1e3 / ns);
+}
+
+// Two SPSC rings, one per direction: round trip / 2 is the handoff latency
+void spsc_ping_pong(size_t rounds) {
+    SpscQueue<uint64_t> ping(1024);
+    SpscQueue<uint64_t> pong(1024);
+
+    std::thread echo([&]() {
+        uint64_t value = 0;
+        int spins = 0;
+        for (size_t i = 0; i < rounds; ++i) {
+            while (!ping.try_pop(value)) {
+                backoff(spins);
+            }
+            while (!pong.try_push(value)) {
+                backoff(spins);
+            }
+        }
+    });
+
+    auto start = Clock::now();
+    uint64_t value = 0;
+    int spins = 0;
+    for (size_t i = 0; i < rounds; ++i) {
+        while (!ping.try_push(i)) {
+            backoff(spins);
+        }
+        while (!pong.try_pop(value)) {
+            backoff(spins);
+        }
+    }
+    double ns = elapsed_ns(start);
+    echo.join();
+    std::printf("%-36s %10.1f ns one-way\n", "spsc ping-pong", ns / rounds / 2);
+}
+
+void spsc_throughput(size_t messages, size_t batch) {
+    SpscQueue<uint64_t> queue(4096);
+    std::vector<uint64_t> in(batch);
+    std::vector<uint64_t> out(batch);
+
+    auto start = Clock::now();
+    std::thread consumer([&]() {
+        size_t received = 0;
+        int spins = 0;
+        while (received < messages) {
+            size_t count = queue.pop_batch(out.data(), batch);
+            if (count == 0) {
+                backoff(spins);
+            }
+            received += count;
+        }
+    });
+
+    int spins = 0;
+    for (size_t sent = 0; sent < messages;) {
+        size_t want = std::min(batch, messages - sent);
+        size_t pushed = queue.push_batch(in.data(), want);
+        if (pushed == 0) {
+            backoff(spins);
+        }
+        sent += pushed;
+    }
+    consumer.join();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "spsc batch=%zu", batch);
+    report(name, messages, elapsed_ns(start));
+}
+
+void mpsc_throughput(size_t messages, int producers, size_t batch) {
+    MpscQueue<uint64_t> queue(4096);
+    size_t per_producer = messages / producers;
+    size_t total = per_producer * producers;
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+            std::vector<uint64_t> values(batch);
+            int spins = 0;
+            for (size_t sent = 0; sent < per_producer;) {
+                size_t pushed = queue.push_batch(values.data(), std::min(batch, per_producer - sent));
+                if (pushed == 0) {
+                    backoff(spins);
+                }
+                sent += pushed;
+            }
+        });
+    }
+
+    std::vector<uint64_t> out(64);
+    int spins = 0;
+    for (size_t received = 0; received < total;) {
+        size_t count = queue.pop_batch(out.data(), out.size());
+        if (count == 0) {
+            backoff(spins);
+        }
+        received += count;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "mpsc producers=%d batch=%zu", producers, batch);
+    report(name, total, elapsed_ns(start));
+}
+
+struct Node : MpscNode {
+    uint64_t value = 0;
+};
+
+void intrusive_mpsc_throughput(size_t messages, int producers) {
+    IntrusiveMpscQueue<Node> queue;
+    size_t per_producer = messages / producers;
+    size_t total = per_producer * producers;
+    std::vector<std::unique_ptr<Node[]>> nodes;
+    for (int p = 0; p < producers; ++p) {
+        nodes.emplace_back(new Node[per_producer]);
+    }
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        Node* own = nodes[p].get();
+        threads.emplace_back([&queue, own, per_producer]() {
+            for (size_t i = 0; i < per_producer; ++i) {
+                queue.push(&own[i]);
+            }
+        });
+    }
+
+    int spins = 0;
+    for (size_t received = 0; received < total;) {
+        if (queue.pop()) {
+            ++received;
+        } else {
+            backoff(spins);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "intrusive mpsc producers=%d", producers);
+    report(name, total, elapsed_ns(start));
+}
+
+// Baseline: what the queues replace
+void mutex_deque_throughput(size_t messages, int producers) {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<uint64_t> queue;
+    size_t per_producer = messages / producers;
+    size_t total = per_producer * producers;
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < per_producer; ++i) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queue.push_back(i);
+                }
+                ready.notify_one();
+            }
+        });
+    }
+
+    for (size_t received = 0; received < total;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&]() { return !queue.empty(); });
+        received += queue.size();
+        queue.clear();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "mutex+deque producers=%d", producers);
+    report(name, total, elapsed_ns(start));
+}
+
+// Submit-to-start latency of a WorkerPool task while other threads keep the worker's
+// queue busy
+void worker_pool_latency(size_t rounds, int background) {
+    WorkerPool pool(WorkerPool::Options{1, 1 << 20});
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> noise;
+    for (int i = 0; i < background; ++i) {
+        noise.emplace_back([&]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                pool.submit_to(0, []() {});
+                std::this_thread::sleep_for(std::chrono::microseconds(5));
+            }
+        });
+    }
+
+    std::atomic<int64_t> started{0};
+    double total_ns = 0;
+    for (size_t i = 0; i < rounds; ++i) {
+        started.store(0, std::memory_order_relaxed);
+        auto submitted = Clock::now();
+        pool.submit_to(0, [&started]() {
+            started.store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+        });
+        int64_t at = 0;
+        int spins = 0;
+        while ((at = started.load(std::memory_order_acquire)) == 0) {
+            backoff(spins);
+        }
+        total_ns += std::chrono::duration<double, std::nano>(
+            Clock::time_point(Clock::duration(at)) - submitted).count();
+    }
+
+    stop.store(true);
+    for (auto& thread : noise) {
+        thread.join();
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "worker pool handoff, %d noisy", background);
+    std::printf("%-36s %10.1f ns submit->run\n", name, total_ns / rounds);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    spsc_ping_pong(messages / 10);
+    spsc_throughput(messages, 1);
+    spsc_throughput(messages, 32);
+    for (int producers : {1, 2, 4}) {
+        mpsc_throughput(messages, producers, 1);
+        mpsc_throughput(messages, producers, 32);
+    }
+    for (int producers : {1, 2, 4}) {
+        intrusive_mpsc_throughput(messages, producers);
+    }
+    for (int producers : {1, 4}) {
+        mutex_deque_throughput(messages, producers);
+    }
+    worker_pool_latency(messages / 100, 0);
+    worker_pool_latency(messages / 100, 2);
+    return 0;
+}
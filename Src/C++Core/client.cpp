@@ -1,5 +1,7 @@
 #include "client.h"
 #include "serialization.h"
+#include "timer_wheel.h"
+#include <atomic>
 #include <stdexcept>
 #include <iostream>
 
@@ -22,11 +24,158 @@
 #define closesocket close
 #endif
 
+// Writes to a peer that has gone away (timed out, reaped as idle) must fail with EPIPE
+// rather than raise SIGPIPE
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 namespace bitrpc {
 
+static bool recv_exact(SOCKET sock, char* buf, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        int r = recv(sock, buf + off, static_cast<int>(len - off), 0);
+        if (r <= 0) return false;
+        off += r;
+    }
+    return true;
+}
+
+static bool send_exact(SOCKET sock, const char* buf, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        int s = send(sock, buf + off, static_cast<int>(len - off), MSG_NOSIGNAL);
+        if (s <= 0) return false;
+        off += s;
+    }
+    return true;
+}
+
+// Offers binary frames to the server and returns the protocol it granted
+static FrameProtocol negotiate_frame_protocol(SOCKET sock) {
+    FrameHandshake offer;
+    offer.version = FrameCodec::kVersion;
+    offer.capabilities = FrameCodec::kSupportedCapabilities;
+
+    uint8_t handshake[FrameCodec::kHandshakeSize];
+    FrameCodec::encode_handshake(offer, handshake);
+    if (!send_exact(sock, reinterpret_cast<const char*>(handshake), sizeof(handshake))) {
+        throw ConnectionException("Failed to send frame handshake");
+    }
+    if (!recv_exact(sock, reinterpret_cast<char*>(handshake), sizeof(handshake))) {
+        throw ConnectionException("Connection closed during frame handshake");
+    }
+
+    FrameHandshake answer = FrameCodec::decode_handshake(handshake);
+    return (answer.capabilities & FRAME_CAP_BINARY_FRAMES) ? FrameProtocol::BINARY : FrameProtocol::LEGACY;
+}
+
+static void send_binary_request(SOCKET sock, void* handle, const TransportOptions& options, const std::string& method,
+                                const std::vector<uint8_t>& request, uint64_t request_id,
+                                std::chrono::milliseconds deadline) {
+    FrameHeader header;
+    header.method_id = FrameCodec::method_id(method);
+    header.request_id = request_id;
+    header.deadline_ms = static_cast<uint32_t>(deadline.count());
+    header.payload_length = static_cast<uint32_t>(request.size());
+
+    uint8_t header_bytes[FrameCodec::kMaxHeaderSize];
+    size_t header_size = FrameCodec::encode_header(header, header_bytes);
+
+    if (options.tcp_cork) {
+        SocketTuner::set_cork(handle, true);
+    }
+    bool sent = send_exact(sock, reinterpret_cast<const char*>(header_bytes), header_size) &&
+                send_exact(sock, reinterpret_cast<const char*>(request.data()), request.size());
+    if (options.tcp_cork) {
+        SocketTuner::set_cork(handle, false);
+    }
+    if (!sent) {
+        throw ConnectionException("Failed to send request frame");
+    }
+}
+
+// Reads one binary frame; returns false if the connection closed
+static bool recv_binary_frame(SOCKET sock, FrameHeader& header, std::vector<uint8_t>& payload) {
+    uint8_t header_bytes[FrameCodec::kMaxHeaderSize];
+    size_t received = FrameCodec::kFixedHeaderSize + 1;
+    if (!recv_exact(sock, reinterpret_cast<char*>(header_bytes), received)) {
+        return false;
+    }
+    header = FrameCodec::decode_fixed_header(header_bytes);
+    while (FrameCodec::decode_varint(header_bytes + FrameCodec::kFixedHeaderSize,
+                                     received - FrameCodec::kFixedHeaderSize, header.payload_length) == 0) {
+        if (!recv_exact(sock, reinterpret_cast<char*>(header_bytes + received), 1)) {
+            return false;
+        }
+        ++received;
+    }
+
+    payload.resize(header.payload_length);
+    return header.payload_length == 0 ||
+           recv_exact(sock, reinterpret_cast<char*>(payload.data()), header.payload_length);
+}
+
+static std::vector<uint8_t> recv_binary_response(SOCKET sock, uint64_t request_id) {
+    FrameHeader header;
+    std::vector<uint8_t> payload;
+    if (!recv_binary_frame(sock, header, payload)) {
+        throw ConnectionException("Failed to receive response frame");
+    }
+    if (header.request_id != request_id) {
+        throw ProtocolException("Response frame for request " + std::to_string(header.request_id) +
+                                ", expected " + std::to_string(request_id));
+    }
+    if (header.flags & FRAME_FLAG_DEADLINE_EXCEEDED) {
+        throw TimeoutException(std::string(payload.begin(), payload.end()));
+    }
+    if (header.flags & FRAME_FLAG_ERROR) {
+        throw RpcException(std::string(payload.begin(), payload.end()));
+    }
+    return payload;
+}
+
+// Bounds one blocking call. If the timer fires first it shuts the socket down, which
+// fails the pending send/recv; the caller then reports a timeout instead of the I/O error.
+class CallTimer {
+public:
+    CallTimer(SOCKET sock, std::chrono::milliseconds timeout) {
+        if (timeout.count() > 0) {
+            handle_ = TimerService::fine().schedule(timeout, [sock, expired = &expired_]() {
+                expired->store(true);
+#ifdef _WIN32
+                shutdown(sock, SD_BOTH);
+#else
+                shutdown(sock, SHUT_RDWR);
+#endif
+            });
+        }
+    }
+
+    ~CallTimer() { disarm(); }
+
+    // Returns true if the timer fired; once this returns it can no longer touch the socket
+    bool disarm() {
+        if (handle_.valid()) {
+            TimerService::fine().cancel_and_wait(handle_);
+            handle_ = TimerHandle();
+        }
+        return expired_.load();
+    }
+
+private:
+    TimerHandle handle_;
+    std::atomic<bool> expired_{false};
+};
+
 BaseClient::BaseClient(std::shared_ptr<IRpcClient> client) : client_(client) {}
 
-TcpRpcClient::TcpRpcClient() : socket_(nullptr), connected_(false) {
+TcpRpcClient::TcpRpcClient() : TcpRpcClient(TransportOptions()) {}
+
+TcpRpcClient::TcpRpcClient(const TransportOptions& transport_options)
+    : transport_options_(transport_options), socket_(nullptr), connected_(false) {
+    transport_options_.validate();
 #ifdef _WIN32
     initialize_network();
 #endif
@@ -70,13 +219,27 @@ void TcpRpcClient::connect(const std::string& host, int port) {
 
     memcpy(&server_addr.sin_addr, host_info->h_addr_list[0], host_info->h_length);
 
+    void* handle = reinterpret_cast<void*>(static_cast<intptr_t>(sock));
+    SocketTuner::apply_pre_connect(handle, transport_options_);
+
     if (::connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) != 0) {
         closesocket(sock);
         throw ConnectionException("Failed to connect to server");
     }
 
-    socket_ = reinterpret_cast<void*>(static_cast<intptr_t>(sock));
+    effective_options_ = SocketTuner::apply_connected(handle, transport_options_);
+    frame_protocol_ = FrameProtocol::LEGACY;
+    if (requested_protocol_ == FrameProtocol::BINARY) {
+        try {
+            frame_protocol_ = negotiate_frame_protocol(sock);
+        } catch (...) {
+            closesocket(sock);
+            throw;
+        }
+    }
+    socket_ = handle;
     connected_ = true;
+    frames_sent_ = false;
 }
 
 void TcpRpcClient::disconnect() {
@@ -94,6 +257,22 @@ bool TcpRpcClient::is_connected() const {
     return connected_;
 }
 
+void TcpRpcClient::set_frame_protocol(FrameProtocol protocol) {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    requested_protocol_ = protocol;
+    if (protocol == FrameProtocol::LEGACY) {
+        // A connection that already negotiated binary frames keeps them
+        return;
+    }
+    if (connected_ && socket_ && frame_protocol_ != FrameProtocol::BINARY) {
+        // The server only looks for the handshake in the first bytes of a connection
+        if (frames_sent_) {
+            throw ProtocolException("Frame protocol can only change before the first call; reconnect to apply it");
+        }
+        frame_protocol_ = negotiate_frame_protocol(reinterpret_cast<SOCKET>(socket_));
+    }
+}
+
 std::vector<uint8_t> TcpRpcClient::call(const std::string& method, const std::vector<uint8_t>& request) {
     std::lock_guard<std::mutex> lock(socket_mutex_);
 
@@ -101,7 +280,45 @@ std::vector<uint8_t> TcpRpcClient::call(const std::string& method, const std::ve
         throw ConnectionException("Not connected to server");
     }
 
+    CallTimer timer(reinterpret_cast<SOCKET>(socket_), call_timeout_);
+    std::vector<uint8_t> response;
+    try {
+        response = exchange(method, request);
+    } catch (const RpcException&) {
+        if (timer.disarm()) {
+            close_socket();
+            throw TimeoutException("Call timed out: " + method);
+        }
+        throw;
+    }
+    if (timer.disarm()) {
+        // Fired just as the response arrived; the socket is already shut down
+        close_socket();
+    }
+    return response;
+}
+
+void TcpRpcClient::close_socket() {
+    if (socket_) {
+        closesocket(reinterpret_cast<SOCKET>(socket_));
+        socket_ = nullptr;
+    }
+    connected_ = false;
+}
+
+std::vector<uint8_t> TcpRpcClient::exchange(const std::string& method, const std::vector<uint8_t>& request) {
     SOCKET sock = reinterpret_cast<SOCKET>(socket_);
+    frames_sent_ = true;
+
+    if (frame_protocol_ == FrameProtocol::BINARY) {
+        uint64_t request_id = ++next_request_id_;
+        send_binary_request(sock, socket_, transport_options_, method, request, request_id, call_deadline_);
+        auto response = recv_binary_response(sock, request_id);
+        if (transport_options_.tcp_quickack) {
+            SocketTuner::rearm_quickack(socket_);
+        }
+        return response;
+    }
 
     // Create combined payload: method_name + serialized_request (aligned with C#)
     std::vector<uint8_t> combined_payload;
@@ -111,8 +328,14 @@ std::vector<uint8_t> TcpRpcClient::call(const std::string& method, const std::ve
 
     // Send combined payload length and data (C# compatible format)
     uint32_t payload_length = static_cast<uint32_t>(combined_payload.size());
-    send(sock, reinterpret_cast<const char*>(&payload_length), sizeof(payload_length), 0);
-    send(sock, reinterpret_cast<const char*>(combined_payload.data()), static_cast<int>(combined_payload.size()), 0);
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(socket_, true);
+    }
+    send(sock, reinterpret_cast<const char*>(&payload_length), sizeof(payload_length), MSG_NOSIGNAL);
+    send(sock, reinterpret_cast<const char*>(combined_payload.data()), static_cast<int>(combined_payload.size()), MSG_NOSIGNAL);
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(socket_, false);
+    }
 
     // Receive response length
     uint32_t response_length = 0;
@@ -133,11 +356,19 @@ std::vector<uint8_t> TcpRpcClient::call(const std::string& method, const std::ve
         total_received += bytes_received;
     }
 
+    if (transport_options_.tcp_quickack) {
+        SocketTuner::rearm_quickack(socket_);
+    }
+
     return response;
 }
 
 // TcpRpcClientAsync implementation
-TcpRpcClientAsync::TcpRpcClientAsync() : socket_(nullptr), connected_(false) {
+TcpRpcClientAsync::TcpRpcClientAsync() : TcpRpcClientAsync(TransportOptions()) {}
+
+TcpRpcClientAsync::TcpRpcClientAsync(const TransportOptions& transport_options)
+    : transport_options_(transport_options), socket_(nullptr), connected_(false) {
+    transport_options_.validate();
 #ifdef _WIN32
     initialize_network();
 #endif
@@ -181,13 +412,27 @@ void TcpRpcClientAsync::connect(const std::string& host, int port) {
 
     memcpy(&server_addr.sin_addr, host_info->h_addr_list[0], host_info->h_length);
 
+    void* handle = reinterpret_cast<void*>(static_cast<intptr_t>(sock));
+    SocketTuner::apply_pre_connect(handle, transport_options_);
+
     if (::connect(sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) != 0) {
         closesocket(sock);
         throw ConnectionException("Failed to connect to server");
     }
 
-    socket_ = reinterpret_cast<void*>(static_cast<intptr_t>(sock));
+    effective_options_ = SocketTuner::apply_connected(handle, transport_options_);
+    frame_protocol_ = FrameProtocol::LEGACY;
+    if (requested_protocol_ == FrameProtocol::BINARY) {
+        try {
+            frame_protocol_ = negotiate_frame_protocol(sock);
+        } catch (...) {
+            closesocket(sock);
+            throw;
+        }
+    }
+    socket_ = handle;
     connected_ = true;
+    frames_sent_ = false;
     host_ = host;
     port_ = port;
 }
@@ -207,6 +452,22 @@ bool TcpRpcClientAsync::is_connected() const {
     return connected_;
 }
 
+void TcpRpcClientAsync::set_frame_protocol(FrameProtocol protocol) {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    requested_protocol_ = protocol;
+    if (protocol == FrameProtocol::LEGACY) {
+        // A connection that already negotiated binary frames keeps them
+        return;
+    }
+    if (connected_ && socket_ && frame_protocol_ != FrameProtocol::BINARY) {
+        // The server only looks for the handshake in the first bytes of a connection
+        if (frames_sent_) {
+            throw ProtocolException("Frame protocol can only change before the first call; reconnect to apply it");
+        }
+        frame_protocol_ = negotiate_frame_protocol(reinterpret_cast<SOCKET>(socket_));
+    }
+}
+
 std::future<std::vector<uint8_t>> TcpRpcClientAsync::call_async(const std::string& method, const std::vector<uint8_t>& request) {
     return std::async(std::launch::async, [this, method, request]() {
         return make_rpc_call(method, request);
@@ -225,7 +486,7 @@ std::shared_ptr<StreamResponseReader> TcpRpcClientAsync::stream_async(const std:
 
     // Create stream reader - pass the socket and serializer
     auto& serializer = BufferSerializer::instance();
-    auto reader = std::make_shared<TcpStreamResponseReader>(socket_, 0, serializer);
+    auto reader = std::make_shared<TcpStreamResponseReader>(socket_, 0, serializer, frame_protocol_);
 
     return reader;
 }
@@ -233,6 +494,12 @@ std::shared_ptr<StreamResponseReader> TcpRpcClientAsync::stream_async(const std:
 
 void TcpRpcClientAsync::send_stream_request(const std::string& method, const std::vector<uint8_t>& request) {
     SOCKET sock = reinterpret_cast<SOCKET>(socket_);
+    frames_sent_ = true;
+
+    if (frame_protocol_ == FrameProtocol::BINARY) {
+        send_binary_request(sock, socket_, transport_options_, method, request, ++next_request_id_, call_deadline_);
+        return;
+    }
 
     // Create combined payload: method_name + serialized_request (aligned with C#)
     // No special STREAM prefix - server will detect streaming via method registration
@@ -243,8 +510,14 @@ void TcpRpcClientAsync::send_stream_request(const std::string& method, const std
 
     // Send combined payload length and data (C# compatible format)
     uint32_t payload_length = static_cast<uint32_t>(combined_payload.size());
-    send(sock, reinterpret_cast<const char*>(&payload_length), sizeof(payload_length), 0);
-    send(sock, reinterpret_cast<const char*>(combined_payload.data()), static_cast<int>(combined_payload.size()), 0);
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(socket_, true);
+    }
+    send(sock, reinterpret_cast<const char*>(&payload_length), sizeof(payload_length), MSG_NOSIGNAL);
+    send(sock, reinterpret_cast<const char*>(combined_payload.data()), static_cast<int>(combined_payload.size()), MSG_NOSIGNAL);
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(socket_, false);
+    }
 }
 
 void TcpRpcClientAsync::initialize_network() {
@@ -269,7 +542,45 @@ std::vector<uint8_t> TcpRpcClientAsync::make_rpc_call(const std::string& method,
         throw ConnectionException("Not connected to server");
     }
 
+    CallTimer timer(reinterpret_cast<SOCKET>(socket_), call_timeout_);
+    std::vector<uint8_t> response;
+    try {
+        response = exchange(method, request);
+    } catch (const RpcException&) {
+        if (timer.disarm()) {
+            close_socket();
+            throw TimeoutException("Call timed out: " + method);
+        }
+        throw;
+    }
+    if (timer.disarm()) {
+        // Fired just as the response arrived; the socket is already shut down
+        close_socket();
+    }
+    return response;
+}
+
+void TcpRpcClientAsync::close_socket() {
+    if (socket_) {
+        closesocket(reinterpret_cast<SOCKET>(socket_));
+        socket_ = nullptr;
+    }
+    connected_ = false;
+}
+
+std::vector<uint8_t> TcpRpcClientAsync::exchange(const std::string& method, const std::vector<uint8_t>& request) {
     SOCKET sock = reinterpret_cast<SOCKET>(socket_);
+    frames_sent_ = true;
+
+    if (frame_protocol_ == FrameProtocol::BINARY) {
+        uint64_t request_id = ++next_request_id_;
+        send_binary_request(sock, socket_, transport_options_, method, request, request_id, call_deadline_);
+        auto response = recv_binary_response(sock, request_id);
+        if (transport_options_.tcp_quickack) {
+            SocketTuner::rearm_quickack(socket_);
+        }
+        return response;
+    }
 
     // Create combined payload: method_name + serialized_request (aligned with C#)
     std::vector<uint8_t> combined_payload;
@@ -279,8 +590,14 @@ std::vector<uint8_t> TcpRpcClientAsync::make_rpc_call(const std::string& method,
 
     // Send combined payload length and data (C# compatible format)
     uint32_t payload_length = static_cast<uint32_t>(combined_payload.size());
-    send(sock, reinterpret_cast<const char*>(&payload_length), sizeof(payload_length), 0);
-    send(sock, reinterpret_cast<const char*>(combined_payload.data()), static_cast<int>(combined_payload.size()), 0);
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(socket_, true);
+    }
+    send(sock, reinterpret_cast<const char*>(&payload_length), sizeof(payload_length), MSG_NOSIGNAL);
+    send(sock, reinterpret_cast<const char*>(combined_payload.data()), static_cast<int>(combined_payload.size()), MSG_NOSIGNAL);
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(socket_, false);
+    }
 
     // Receive response length
     uint32_t response_length = 0;
@@ -301,19 +618,25 @@ std::vector<uint8_t> TcpRpcClientAsync::make_rpc_call(const std::string& method,
         total_received += bytes_received;
     }
 
+    if (transport_options_.tcp_quickack) {
+        SocketTuner::rearm_quickack(socket_);
+    }
+
     return response;
 }
 
-std::shared_ptr<TcpRpcClientAsync> RpcClientFactory::create_tcp_client_async(const std::string& host, int port) {
-    auto client = std::make_shared<TcpRpcClientAsync>();
+std::shared_ptr<TcpRpcClientAsync> RpcClientFactory::create_tcp_client_async(const std::string& host, int port,
+                                                                            const TransportOptions& options) {
+    auto client = std::make_shared<TcpRpcClientAsync>(options);
     client->connect(host, port);
     return client;
 }
 
 // TcpStreamResponseReader implementation
-TcpStreamResponseReader::TcpStreamResponseReader(void* socket, int response_type_hash, BufferSerializer& serializer)
+TcpStreamResponseReader::TcpStreamResponseReader(void* socket, int response_type_hash, BufferSerializer& serializer,
+                                                 FrameProtocol protocol)
     : socket_(socket), response_type_hash_(response_type_hash), serializer_(serializer),
-      stream_ended_(false), has_error_(false), connection_closed_(false) {
+      stream_ended_(false), has_error_(false), connection_closed_(false), protocol_(protocol) {
 }
 
 TcpStreamResponseReader::~TcpStreamResponseReader() {
@@ -392,6 +715,10 @@ std::string TcpStreamResponseReader::get_error_message() const {
 }
 
 bool TcpStreamResponseReader::read_next_frame(std::vector<uint8_t>& data) {
+    if (protocol_ == FrameProtocol::BINARY) {
+        return read_next_binary_frame(data);
+    }
+
     SOCKET sock = reinterpret_cast<SOCKET>(socket_);
 
     // Read frame length (C# compatible format) with timeout handling
@@ -440,6 +767,24 @@ bool TcpStreamResponseReader::read_next_frame(std::vector<uint8_t>& data) {
     return true;
 }
 
+bool TcpStreamResponseReader::read_next_binary_frame(std::vector<uint8_t>& data) {
+    FrameHeader header;
+    if (!recv_binary_frame(reinterpret_cast<SOCKET>(socket_), header, data)) {
+        connection_closed_ = true;
+        mark_error("Connection closed while reading stream frame");
+        return false;
+    }
+    if (header.flags & (FRAME_FLAG_ERROR | FRAME_FLAG_DEADLINE_EXCEEDED)) {
+        mark_error(std::string(data.begin(), data.end()));
+        return false;
+    }
+    if (header.flags & FRAME_FLAG_END_OF_STREAM) {
+        stream_ended_ = true;
+        return false;
+    }
+    return true;
+}
+
 void TcpStreamResponseReader::mark_error(const std::string& error) {
     has_error_ = true;
     error_message_ = error;
@@ -488,7 +833,7 @@ void TcpStreamResponseWriter::close() {
         // Send end marker (zero-length frame, aligned with C#)
         SOCKET sock = reinterpret_cast<SOCKET>(socket_);
         uint32_t zero_length = 0;
-        send(sock, reinterpret_cast<const char*>(&zero_length), sizeof(zero_length), 0);
+        send(sock, reinterpret_cast<const char*>(&zero_length), sizeof(zero_length), MSG_NOSIGNAL);
         stream_ended_ = true;
     }
 }
@@ -513,7 +858,7 @@ bool TcpStreamResponseWriter::write_frame(const std::vector<uint8_t>& data) {
     }
 
     // Write frame length (C# compatible format)
-    int bytes_sent = send(sock, reinterpret_cast<const char*>(&frame_length), sizeof(frame_length), 0);
+    int bytes_sent = send(sock, reinterpret_cast<const char*>(&frame_length), sizeof(frame_length), MSG_NOSIGNAL);
     if (bytes_sent != sizeof(frame_length)) {
         mark_error("Failed to send frame length: connection may be broken");
         return false;
@@ -524,7 +869,7 @@ bool TcpStreamResponseWriter::write_frame(const std::vector<uint8_t>& data) {
     while (total_sent < data.size()) {
 		size_t remaining = data.size() - total_sent;
 		int chunk_size = remaining < 8192 ? static_cast<int>(remaining) : 8192;
-        bytes_sent = send(sock, reinterpret_cast<const char*>(data.data() + total_sent), chunk_size, 0);
+        bytes_sent = send(sock, reinterpret_cast<const char*>(data.data() + total_sent), chunk_size, MSG_NOSIGNAL);
         if (bytes_sent <= 0) {
             mark_error("Failed to send frame data: connection may be broken");
             return false;
@@ -544,14 +889,16 @@ void TcpStreamResponseWriter::mark_error(const std::string& error) {
     // The connection will simply be closed
 }
 
-std::shared_ptr<IRpcClient> RpcClientFactory::create_tcp_client(const std::string& host, int port) {
-    auto tcp_client = std::make_shared<TcpRpcClientAsync>();
+std::shared_ptr<IRpcClient> RpcClientFactory::create_tcp_client(const std::string& host, int port,
+                                                               const TransportOptions& options) {
+    auto tcp_client = std::make_shared<TcpRpcClientAsync>(options);
     tcp_client->connect(host, port);
     return tcp_client;
 }
 
-std::shared_ptr<TcpRpcClient> RpcClientFactory::create_tcp_client_native(const std::string& host, int port) {
-    auto client = std::make_shared<TcpRpcClient>();
+std::shared_ptr<TcpRpcClient> RpcClientFactory::create_tcp_client_native(const std::string& host, int port,
+                                                                        const TransportOptions& options) {
+    auto client = std::make_shared<TcpRpcClient>(options);
     client->connect(host, port);
     return client;
 }
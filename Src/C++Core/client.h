@@ -1,5 +1,6 @@
 #pragma once
 
+#include <any>
 #include <memory>
 #include <future>
 #include <string>
@@ -10,7 +11,10 @@
 #include <functional>
 #include <typeinfo>
 #include <stdexcept>
+#include <chrono>
 #include "serialization.h"
+#include "transport_options.h"
+#include "frame.h"
 
 namespace bitrpc {
 
@@ -71,6 +75,15 @@ public:
     virtual void connect(const std::string& host, int port) = 0;
     virtual void disconnect() = 0;
     virtual bool is_connected() const = 0;
+
+    // Object mode (in-process transports): the typed handler for method, holding a
+    // std::function<TResponse(const TRequest&)>, or nullptr to go through call_async
+    virtual const std::any* object_method(const std::string& method) { (void)method; return nullptr; }
+    // Runs an object-mode call; the default runs it on the calling thread
+    virtual void post(std::function<void()> task) { task(); }
+    // Whether post() runs tasks on the calling thread, letting synchronous object-mode
+    // calls invoke the handler directly
+    virtual bool posts_inline() const { return true; }
 };
 
 // Base client class for generated service clients
@@ -83,6 +96,11 @@ protected:
     template<typename TRequest, typename TResponse>
     std::future<TResponse> call_async(const std::string& method, const TRequest& request);
 
+    // Blocking call. In object mode with an inline transport the typed handler runs
+    // directly, without the promise, shared state and request copy of call_async.
+    template<typename TRequest, typename TResponse>
+    TResponse call(const std::string& method, const TRequest& request);
+
     template<typename TRequest>
     std::shared_ptr<StreamResponseReader> stream_async(const std::string& method, const TRequest& request);
 
@@ -95,6 +113,7 @@ private:
 class TcpRpcClient : public RpcClient {
 public:
     TcpRpcClient();
+    explicit TcpRpcClient(const TransportOptions& transport_options);
     ~TcpRpcClient() override;
 
     void connect(const std::string& host, int port) override;
@@ -102,7 +121,31 @@ public:
     bool is_connected() const override;
     std::vector<uint8_t> call(const std::string& method, const std::vector<uint8_t>& request) override;
 
+    const TransportOptions& transport_options() const { return transport_options_; }
+    // Options as reported by the connected socket
+    EffectiveSocketOptions effective_socket_options() const { return effective_options_; }
+
+    // BINARY requires a server that understands the handshake. Applied on connect(), or
+    // immediately on a connection that has not carried a call yet; after that it throws
+    // ProtocolException and applies from the next connect(). Stays LEGACY if the server
+    // does not grant it.
+    void set_frame_protocol(FrameProtocol protocol);
+    FrameProtocol frame_protocol() const { return frame_protocol_; }
+    // Relative deadline carried by binary frames; zero means none
+    void set_call_deadline(std::chrono::milliseconds deadline) { call_deadline_ = deadline; }
+    // Local bound on a unary call; zero means none. A call that runs out throws
+    // TimeoutException and closes the connection, since its response may still arrive.
+    void set_call_timeout(std::chrono::milliseconds timeout) { call_timeout_ = timeout; }
+
 private:
+    TransportOptions transport_options_;
+    EffectiveSocketOptions effective_options_;
+    FrameProtocol requested_protocol_ = FrameProtocol::LEGACY;
+    FrameProtocol frame_protocol_ = FrameProtocol::LEGACY;
+    bool frames_sent_ = false;  // the connection carried a frame, so the handshake can no longer be sent
+    std::chrono::milliseconds call_deadline_{0};
+    std::chrono::milliseconds call_timeout_{0};
+    uint64_t next_request_id_ = 0;
 #ifdef _WIN32
     void* socket_; // Platform-specific socket handle
 #else
@@ -113,12 +156,16 @@ private:
 
     void initialize_network();
     void cleanup_network();
+    // Request/response exchange on the connected socket; socket_mutex_ held
+    std::vector<uint8_t> exchange(const std::string& method, const std::vector<uint8_t>& request);
+    void close_socket();
 };
 
 // TCP RPC Client implementation with async support
 class TcpRpcClientAsync : public IRpcClient {
 public:
     TcpRpcClientAsync();
+    explicit TcpRpcClientAsync(const TransportOptions& transport_options);
     ~TcpRpcClientAsync() override;
 
     void connect(const std::string& host, int port) override;
@@ -127,7 +174,31 @@ public:
     std::future<std::vector<uint8_t>> call_async(const std::string& method, const std::vector<uint8_t>& request) override;
     std::shared_ptr<StreamResponseReader> stream_async(const std::string& method, const std::vector<uint8_t>& request) override;
 
+    const TransportOptions& transport_options() const { return transport_options_; }
+    // Options as reported by the connected socket
+    EffectiveSocketOptions effective_socket_options() const { return effective_options_; }
+
+    // BINARY requires a server that understands the handshake. Applied on connect(), or
+    // immediately on a connection that has not carried a call yet; after that it throws
+    // ProtocolException and applies from the next connect(). Stays LEGACY if the server
+    // does not grant it.
+    void set_frame_protocol(FrameProtocol protocol);
+    FrameProtocol frame_protocol() const { return frame_protocol_; }
+    // Relative deadline carried by binary frames; zero means none
+    void set_call_deadline(std::chrono::milliseconds deadline) { call_deadline_ = deadline; }
+    // Local bound on a unary call; zero means none. A call that runs out throws
+    // TimeoutException and closes the connection, since its response may still arrive.
+    void set_call_timeout(std::chrono::milliseconds timeout) { call_timeout_ = timeout; }
+
 private:
+    TransportOptions transport_options_;
+    EffectiveSocketOptions effective_options_;
+    FrameProtocol requested_protocol_ = FrameProtocol::LEGACY;
+    FrameProtocol frame_protocol_ = FrameProtocol::LEGACY;
+    bool frames_sent_ = false;  // the connection carried a frame, so the handshake can no longer be sent
+    std::chrono::milliseconds call_deadline_{0};
+    std::chrono::milliseconds call_timeout_{0};
+    uint64_t next_request_id_ = 0;
     void* socket_;
     bool connected_;
     std::mutex socket_mutex_;
@@ -137,13 +208,17 @@ private:
     void initialize_network();
     void cleanup_network();
     std::vector<uint8_t> make_rpc_call(const std::string& method, const std::vector<uint8_t>& request);
+    // Request/response exchange on the connected socket; socket_mutex_ held
+    std::vector<uint8_t> exchange(const std::string& method, const std::vector<uint8_t>& request);
+    void close_socket();
     void send_stream_request(const std::string& method, const std::vector<uint8_t>& request);
 };
 
 // TCP Stream Response Reader implementation
 class TcpStreamResponseReader : public StreamResponseReader {
 public:
-    TcpStreamResponseReader(void* socket, int response_type_hash, BufferSerializer& serializer);
+    TcpStreamResponseReader(void* socket, int response_type_hash, BufferSerializer& serializer,
+                            FrameProtocol protocol = FrameProtocol::LEGACY);
     ~TcpStreamResponseReader() override;
 
     std::vector<uint8_t> read_next() override;
@@ -161,8 +236,10 @@ private:
     bool has_error_;
     std::string error_message_;
     bool connection_closed_;
+    FrameProtocol protocol_;
 
     bool read_next_frame(std::vector<uint8_t>& data);
+    bool read_next_binary_frame(std::vector<uint8_t>& data);
     void mark_error(const std::string& error);
 };
 
@@ -209,14 +286,34 @@ public:
 // RPC Client Factory
 class RpcClientFactory {
 public:
-    static std::shared_ptr<IRpcClient> create_tcp_client(const std::string& host, int port);
-    static std::shared_ptr<TcpRpcClient> create_tcp_client_native(const std::string& host, int port);
-    static std::shared_ptr<TcpRpcClientAsync> create_tcp_client_async(const std::string& host, int port);
+    static std::shared_ptr<IRpcClient> create_tcp_client(const std::string& host, int port,
+                                                         const TransportOptions& options = TransportOptions());
+    static std::shared_ptr<TcpRpcClient> create_tcp_client_native(const std::string& host, int port,
+                                                                  const TransportOptions& options = TransportOptions());
+    static std::shared_ptr<TcpRpcClientAsync> create_tcp_client_async(const std::string& host, int port,
+                                                                      const TransportOptions& options = TransportOptions());
 };
 
 // Template implementations
 template<typename TRequest, typename TResponse>
 std::future<TResponse> BaseClient::call_async(const std::string& method, const TRequest& request) {
+    // Object mode: hand the request object to the handler without encoding it
+    if (const std::any* binding = client_->object_method(method)) {
+        using Invoker = std::function<TResponse(const TRequest&)>;
+        if (const Invoker* invoker = std::any_cast<Invoker>(binding)) {
+            auto promise = std::make_shared<std::promise<TResponse>>();
+            auto future = promise->get_future();
+            client_->post([invoker, request, promise]() {
+                try {
+                    promise->set_value((*invoker)(request));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+            return future;
+        }
+    }
+
     // Serialize request
     auto& serializer = BufferSerializer::instance();
     StreamWriter writer;
@@ -235,6 +332,19 @@ std::future<TResponse> BaseClient::call_async(const std::string& method, const T
     });
 }
 
+template<typename TRequest, typename TResponse>
+TResponse BaseClient::call(const std::string& method, const TRequest& request) {
+    if (client_->posts_inline()) {
+        if (const std::any* binding = client_->object_method(method)) {
+            using Invoker = std::function<TResponse(const TRequest&)>;
+            if (const Invoker* invoker = std::any_cast<Invoker>(binding)) {
+                return (*invoker)(request);
+            }
+        }
+    }
+    return call_async<TRequest, TResponse>(method, request).get();
+}
+
 template<typename TRequest>
 std::shared_ptr<StreamResponseReader> BaseClient::stream_async(const std::string& method, const TRequest& request) {
     // Serialize request
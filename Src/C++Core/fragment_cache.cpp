@@ -0,0 +1,57 @@
+#include "fragment_cache.h"
+#include <cstring>
+
+namespace bitrpc {
+
+FragmentCache& FragmentCache::instance() {
+    static FragmentCache cache;
+    return cache;
+}
+
+FragmentCache::FragmentCache() {
+    configure(Options());
+}
+
+void FragmentCache::configure(const Options& options) {
+    ShardedLruCache::Options cache_options;
+    cache_options.max_bytes = options.max_bytes;
+    cache_options.shard_count = options.shard_count;
+
+    std::lock_guard<std::mutex> lock(configure_mutex_);
+    caches_.push_back(std::make_unique<ShardedLruCache>(cache_options));
+    ShardedLruCache* previous = cache_.exchange(caches_.back().get(), std::memory_order_acq_rel);
+    enabled_.store(options.enabled, std::memory_order_relaxed);
+    if (previous) {
+        previous->clear();
+    }
+}
+
+void FragmentCache::make_key(int type_hash, const FragmentIdentity& identity, char* key) {
+    int32_t hash = type_hash;
+    std::memcpy(key, &hash, sizeof(hash));
+    std::memcpy(key + sizeof(hash), &identity.id, sizeof(identity.id));
+    std::memcpy(key + sizeof(hash) + sizeof(identity.id), &identity.version, sizeof(identity.version));
+}
+
+void FragmentCache::invalidate(int type_hash, uint64_t id) {
+    // Same layout as make_key without the version
+    char prefix[sizeof(int32_t) + sizeof(uint64_t)];
+    int32_t hash = type_hash;
+    std::memcpy(prefix, &hash, sizeof(hash));
+    std::memcpy(prefix + sizeof(hash), &id, sizeof(id));
+    std::string_view prefix_view(prefix, sizeof(prefix));
+
+    cache_.load(std::memory_order_acquire)->erase_if([prefix_view](std::string_view key) {
+        return key.size() == kKeySize && key.substr(0, prefix_view.size()) == prefix_view;
+    });
+}
+
+void FragmentCache::clear() {
+    cache_.load(std::memory_order_acquire)->clear();
+}
+
+ShardedLruCache::Stats FragmentCache::stats() const {
+    return cache_.load(std::memory_order_acquire)->stats();
+}
+
+} // namespace bitrpc
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "response_cache.h"
+#include "serialization.h"
+
+namespace bitrpc {
+
+// Identity of a message instance whose encoding may be reused (PDL: message X [fragment_cache]).
+// id 0 means "no identity": the message is always encoded. Whoever mutates an identified
+// object must bump its version, otherwise readers keep getting the old bytes.
+struct FragmentIdentity {
+    uint64_t id = 0;
+    uint64_t version = 0;
+
+    bool valid() const { return id != 0; }
+    void bump() { ++version; }
+};
+
+// Process-wide cache of encoded message fragments keyed by (type, id, version).
+// Generated serializers of [fragment_cache] messages encode an identified object once and
+// splice the cached bytes into every later parent message (LoginResponse.user,
+// EchoResponse.users, ...). Superseded versions are never looked up again and age out
+// through the LRU.
+class FragmentCache {
+public:
+    struct Options {
+        bool enabled = true;
+        size_t max_bytes = 8 * 1024 * 1024;
+        size_t shard_count = 16;
+    };
+
+    static FragmentCache& instance();
+
+    // Replaces the cache, dropping its contents. Safe while other threads serialize: the
+    // replaced cache is emptied but kept alive, so configure() is meant for setup, not
+    // for a hot loop.
+    void configure(const Options& options);
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Splice the cached encoding, or encode with encode(writer) and remember the bytes
+    template<typename TEncode>
+    void write(int type_hash, const FragmentIdentity& identity, StreamWriter& writer, TEncode encode);
+
+    // Drops every cached version of one object
+    void invalidate(int type_hash, uint64_t id);
+    void clear();
+
+    ShardedLruCache::Stats stats() const;
+
+private:
+    static constexpr size_t kKeySize = sizeof(int32_t) + 2 * sizeof(uint64_t);
+
+    FragmentCache();
+    static void make_key(int type_hash, const FragmentIdentity& identity, char* key);
+
+    std::atomic<bool> enabled_{false};
+    // Current cache; writers load it without locking
+    std::atomic<ShardedLruCache*> cache_{nullptr};
+    // Every cache configure() created, so a writer still holding a replaced one stays valid
+    std::vector<std::unique_ptr<ShardedLruCache>> caches_;
+    std::mutex configure_mutex_;
+};
+
+template<typename TEncode>
+void FragmentCache::write(int type_hash, const FragmentIdentity& identity, StreamWriter& writer, TEncode encode) {
+    if (!enabled() || !identity.valid()) {
+        encode(writer);
+        return;
+    }
+    ShardedLruCache* cache = cache_.load(std::memory_order_acquire);
+
+    char key[kKeySize];
+    make_key(type_hash, identity, key);
+    std::string_view key_view(key, kKeySize);
+
+    if (auto cached = cache->get(key_view)) {
+        writer.write_raw(cached->data(), cached->size());
+        return;
+    }
+
+    // Encode in place, then copy the fragment out of the writer
+    size_t start = writer.size();
+    encode(writer);
+    cache->put(key_view,
+               std::make_shared<const std::vector<uint8_t>>(writer.data() + start, writer.data() + writer.size()),
+               std::chrono::milliseconds(0));
+}
+
+} // namespace bitrpc
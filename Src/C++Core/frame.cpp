@@ -0,0 +1,123 @@
+#include "frame.h"
+#include "client.h"
+#include <algorithm>
+#include <cstring>
+
+namespace bitrpc {
+
+namespace {
+
+constexpr uint8_t kHandshakeMagic[4] = {'B', 'R', 'P', 'C'};
+
+} // namespace
+
+uint32_t FrameCodec::method_id(std::string_view qualified_method) {
+    uint32_t hash = 2166136261u;
+    for (char c : qualified_method) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t FrameCodec::method_id(std::string_view service_name, std::string_view method_name) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](std::string_view part) {
+        for (char c : part) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+    };
+    mix(service_name);
+    mix(".");
+    mix(method_name);
+    return hash;
+}
+
+size_t FrameCodec::encode_header(const FrameHeader& header, uint8_t* out) {
+    uint16_t magic = kMagic;
+    std::memcpy(out, &magic, 2);
+    out[2] = header.version ? header.version : kVersion;
+    out[3] = header.flags;
+    std::memcpy(out + 4, &header.method_id, 4);
+    std::memcpy(out + 8, &header.request_id, 8);
+    std::memcpy(out + 16, &header.deadline_ms, 4);
+    return kFixedHeaderSize + encode_varint(header.payload_length, out + kFixedHeaderSize);
+}
+
+FrameHeader FrameCodec::decode_fixed_header(const uint8_t* data) {
+    uint16_t magic = 0;
+    std::memcpy(&magic, data, 2);
+    if (magic != kMagic) {
+        throw ProtocolException("Invalid frame magic");
+    }
+
+    FrameHeader header;
+    header.version = data[2];
+    if (header.version == 0 || header.version > kVersion) {
+        throw ProtocolException("Unsupported frame version: " + std::to_string(header.version));
+    }
+    header.flags = data[3];
+    std::memcpy(&header.method_id, data + 4, 4);
+    std::memcpy(&header.request_id, data + 8, 8);
+    std::memcpy(&header.deadline_ms, data + 16, 4);
+    return header;
+}
+
+size_t FrameCodec::encode_varint(uint32_t value, uint8_t* out) {
+    size_t i = 0;
+    while (value >= 0x80) {
+        out[i++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[i++] = static_cast<uint8_t>(value);
+    return i;
+}
+
+size_t FrameCodec::decode_varint(const uint8_t* data, size_t size, uint32_t& value) {
+    uint32_t result = 0;
+    for (size_t i = 0; i < std::min(size, kMaxVarintSize); ++i) {
+        uint8_t byte = data[i];
+        if (i == kMaxVarintSize - 1 && byte > 0x0F) {
+            throw ProtocolException("Frame length varint overflows 32 bits");
+        }
+        result |= static_cast<uint32_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+void FrameCodec::encode_handshake(const FrameHandshake& handshake, uint8_t* out) {
+    std::memcpy(out, kHandshakeMagic, 4);
+    out[4] = handshake.version;
+    out[5] = 0;
+    out[6] = 0;
+    out[7] = 0;
+    std::memcpy(out + 8, &handshake.capabilities, 4);
+}
+
+bool FrameCodec::is_handshake(const uint8_t* data) {
+    return std::memcmp(data, kHandshakeMagic, 4) == 0;
+}
+
+FrameHandshake FrameCodec::decode_handshake(const uint8_t* data) {
+    if (!is_handshake(data)) {
+        throw ProtocolException("Invalid handshake");
+    }
+    FrameHandshake handshake;
+    handshake.version = data[4];
+    std::memcpy(&handshake.capabilities, data + 8, 4);
+    return handshake;
+}
+
+FrameHandshake FrameCodec::negotiate(const FrameHandshake& offer) {
+    FrameHandshake answer;
+    answer.version = std::min(offer.version, kVersion);
+    answer.capabilities = answer.version == 0 ? 0 : (offer.capabilities & kSupportedCapabilities);
+    return answer;
+}
+
+} // namespace bitrpc
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace bitrpc {
+
+// Wire format used on a TCP connection
+enum class FrameProtocol {
+    // [u32 length][method name][request]; the server sniffs the method name
+    LEGACY,
+    // Fixed-layout binary header, negotiated by a handshake when the connection opens
+    BINARY
+};
+
+// Binary frame header (v1), little-endian, fixed offsets:
+//    0  u16 magic ("BR")
+//    2  u8  version
+//    3  u8  flags (FrameFlags)
+//    4  u32 method_id    FNV-1a of "Service.Method"
+//    8  u64 request_id   echoed in the response frame
+//   16  u32 deadline_ms  relative budget, 0 = none
+//   20  varint payload length (1-5 bytes)
+// followed by the payload (request bytes, serialized response or error message).
+struct FrameHeader {
+    uint8_t version = 0;
+    uint8_t flags = 0;
+    uint32_t method_id = 0;
+    uint64_t request_id = 0;
+    uint32_t deadline_ms = 0;
+    uint32_t payload_length = 0;
+};
+
+enum FrameFlags : uint8_t {
+    FRAME_FLAG_RESPONSE = 0x01,
+    FRAME_FLAG_ERROR = 0x02,              // payload is an error message
+    FRAME_FLAG_DEADLINE_EXCEEDED = 0x04,
+    FRAME_FLAG_STREAM_ITEM = 0x08,
+    FRAME_FLAG_END_OF_STREAM = 0x10
+};
+
+// Capability bits exchanged in the handshake; the server answers with the subset it supports
+enum FrameCapabilities : uint32_t {
+    FRAME_CAP_BINARY_FRAMES = 0x01,
+    FRAME_CAP_DEADLINES = 0x02
+};
+
+// Connection handshake, sent once by the client before the first frame:
+//   "BRPC" [u8 version][u8 reserved][u16 reserved][u32 capabilities]
+// The server replies with the same layout carrying the negotiated version and
+// capabilities. Legacy clients never send it: their first four bytes are a frame
+// length, which a "BRPC" prefix would only match for a ~1.1 GB frame.
+struct FrameHandshake {
+    uint8_t version = 0;
+    uint32_t capabilities = 0;
+};
+
+// Encoding/decoding of binary frame headers and the handshake
+class FrameCodec {
+public:
+    static constexpr uint16_t kMagic = 0x5242;  // "BR"
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kFixedHeaderSize = 20;
+    static constexpr size_t kMaxVarintSize = 5;
+    static constexpr size_t kMaxHeaderSize = kFixedHeaderSize + kMaxVarintSize;
+    static constexpr size_t kHandshakeSize = 12;
+    static constexpr uint32_t kSupportedCapabilities = FRAME_CAP_BINARY_FRAMES | FRAME_CAP_DEADLINES;
+
+    // 32-bit FNV-1a of the qualified method name ("Service.Method")
+    static uint32_t method_id(std::string_view qualified_method);
+    static uint32_t method_id(std::string_view service_name, std::string_view method_name);
+
+    // Writes the header into out (kMaxHeaderSize bytes available); returns bytes written
+    static size_t encode_header(const FrameHeader& header, uint8_t* out);
+    // Reads the fixed part (kFixedHeaderSize bytes); payload_length is left at 0.
+    // Throws ProtocolException on a bad magic or unsupported version.
+    static FrameHeader decode_fixed_header(const uint8_t* data);
+
+    static size_t encode_varint(uint32_t value, uint8_t* out);
+    // Returns bytes consumed, or 0 when more bytes are needed.
+    // Throws ProtocolException when the value does not fit 32 bits.
+    static size_t decode_varint(const uint8_t* data, size_t size, uint32_t& value);
+
+    static void encode_handshake(const FrameHandshake& handshake, uint8_t* out);
+    // True when the first four bytes are the "BRPC" handshake magic
+    static bool is_handshake(const uint8_t* data);
+    // Decodes a full kHandshakeSize message; throws ProtocolException if it is not one
+    static FrameHandshake decode_handshake(const uint8_t* data);
+    // Server side of the negotiation
+    static FrameHandshake negotiate(const FrameHandshake& offer);
+};
+
+} // namespace bitrpc
@@ -0,0 +1,150 @@
+#include "inprocess_client.h"
+
+namespace bitrpc {
+
+namespace {
+
+// Keeps the arena that holds the request alive for as long as the stream is read
+class InProcessStreamReader : public StreamResponseReader {
+public:
+    InProcessStreamReader(std::shared_ptr<RpcArena> arena, std::shared_ptr<std::vector<uint8_t>> request,
+                          std::shared_ptr<StreamResponseReader> inner)
+        : arena_(std::move(arena)), request_(std::move(request)), inner_(std::move(inner)) {}
+
+    std::vector<uint8_t> read_next() override { return inner_ ? inner_->read_next() : std::vector<uint8_t>(); }
+    bool has_more() const override { return inner_ && inner_->has_more(); }
+    void close() override {
+        if (inner_) inner_->close();
+    }
+    bool has_error() const override { return inner_ && inner_->has_error(); }
+    std::string get_error_message() const override { return inner_ ? inner_->get_error_message() : std::string(); }
+
+private:
+    std::shared_ptr<RpcArena> arena_;
+    std::shared_ptr<std::vector<uint8_t>> request_;
+    std::shared_ptr<StreamResponseReader> inner_;
+};
+
+} // namespace
+
+InProcessRpcClient::InProcessRpcClient(ServiceManager& services, const InProcessOptions& options)
+    : services_(services), options_(options), connected_(true) {}
+
+void InProcessRpcClient::connect(const std::string& host, int port) {
+    (void)host;
+    (void)port;
+    connected_.store(true, std::memory_order_release);
+}
+
+void InProcessRpcClient::disconnect() {
+    connected_.store(false, std::memory_order_release);
+}
+
+bool InProcessRpcClient::is_connected() const {
+    return connected_.load(std::memory_order_acquire);
+}
+
+const InProcessRpcClient::Route& InProcessRpcClient::resolve(const std::string& qualified_method) {
+    std::lock_guard<std::mutex> lock(routes_mutex_);
+    auto it = routes_.find(qualified_method);
+    if (it != routes_.end()) {
+        return it->second;
+    }
+
+    size_t dot = qualified_method.find('.');
+    if (dot == std::string::npos) {
+        throw RpcException("Invalid method name: " + qualified_method);
+    }
+    Route route;
+    route.service = services_.get_service(qualified_method.substr(0, dot));
+    if (!route.service) {
+        throw RpcException("Service not found: " + qualified_method.substr(0, dot));
+    }
+    route.method = qualified_method.substr(dot + 1);
+    route.object_method = route.service->object_method(route.method);
+
+    // Node-based map: the reference stays valid as more routes are added
+    return routes_.emplace(qualified_method, std::move(route)).first->second;
+}
+
+std::vector<uint8_t> InProcessRpcClient::call(const std::string& method, const std::vector<uint8_t>& request) {
+    if (!connected_) {
+        throw ConnectionException("In-process client is disconnected");
+    }
+    const Route& route = resolve(method);
+
+    RpcArena arena(options_.arena_options);
+    RpcCallContext context;
+    context.request_data = request.data();
+    context.request_size = request.size();
+    context.arena = &arena;
+
+    RpcResponseBuffer* response = nullptr;
+    if (route.service->has_method(route.method)) {
+        response = route.service->call_method(route.method, context);
+    } else if (route.service->has_async_method(route.method)) {
+        response = route.service->call_method_async(route.method, context).get();
+    } else {
+        throw RpcException("Method not found: " + method);
+    }
+
+    auto bytes = response_bytes(context, response);
+    return std::vector<uint8_t>(bytes.data, bytes.data + bytes.size);
+}
+
+std::future<std::vector<uint8_t>> InProcessRpcClient::call_async(const std::string& method,
+                                                                 const std::vector<uint8_t>& request) {
+    auto promise = std::make_shared<std::promise<std::vector<uint8_t>>>();
+    auto future = promise->get_future();
+    auto task = [this, method, request, promise]() {
+        try {
+            promise->set_value(call(method, request));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    };
+    post(std::move(task));
+    return future;
+}
+
+std::shared_ptr<StreamResponseReader> InProcessRpcClient::stream_async(const std::string& method,
+                                                                      const std::vector<uint8_t>& request) {
+    if (!connected_) {
+        throw ConnectionException("In-process client is disconnected");
+    }
+    const Route& route = resolve(method);
+    if (!route.service->has_stream_method(route.method)) {
+        throw RpcException("Stream method not found: " + method);
+    }
+
+    auto arena = std::make_shared<RpcArena>(options_.arena_options);
+    auto request_copy = std::make_shared<std::vector<uint8_t>>(request);
+    RpcCallContext context;
+    context.request_data = request_copy->data();
+    context.request_size = request_copy->size();
+    context.arena = arena.get();
+
+    auto inner = route.service->call_stream_method(route.method, context);
+    return std::make_shared<InProcessStreamReader>(std::move(arena), std::move(request_copy), std::move(inner));
+}
+
+const std::any* InProcessRpcClient::object_method(const std::string& method) {
+    if (options_.mode != InProcessMode::OBJECTS || !connected_) {
+        return nullptr;
+    }
+    try {
+        return resolve(method).object_method;
+    } catch (const RpcException&) {
+        return nullptr;  // the byte path reports the error through the future
+    }
+}
+
+void InProcessRpcClient::post(std::function<void()> task) {
+    if (options_.executor) {
+        options_.executor(std::move(task));
+    } else {
+        task();
+    }
+}
+
+} // namespace bitrpc
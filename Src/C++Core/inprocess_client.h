@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "client.h"
+#include "server.h"
+
+namespace bitrpc {
+
+enum class InProcessMode {
+    // Requests and responses are still encoded, so caller and service share no objects
+    BYTES,
+    // Generated stubs pass request/response objects straight to the typed handler.
+    // Methods without a typed handler (cached, stream) fall back to BYTES.
+    OBJECTS
+};
+
+struct InProcessOptions {
+    InProcessMode mode = InProcessMode::OBJECTS;
+    // Runs calls somewhere else (e.g. WorkerPool::executor()); empty = the caller's thread
+    std::function<void(std::function<void()>)> executor;
+    RpcArena::Options arena_options;
+};
+
+// IRpcClient bound directly to a ServiceManager: colocated services call each other
+// without sockets. The ServiceManager must outlive the client; services it resolves are
+// kept alive by the client.
+class InProcessRpcClient : public IRpcClient {
+public:
+    explicit InProcessRpcClient(ServiceManager& services, const InProcessOptions& options = InProcessOptions());
+    ~InProcessRpcClient() override = default;
+
+    // No-ops apart from the connected flag; there is nothing to connect to
+    void connect(const std::string& host, int port) override;
+    void disconnect() override;
+    bool is_connected() const override;
+
+    std::future<std::vector<uint8_t>> call_async(const std::string& method, const std::vector<uint8_t>& request) override;
+    std::shared_ptr<StreamResponseReader> stream_async(const std::string& method, const std::vector<uint8_t>& request) override;
+
+    const std::any* object_method(const std::string& method) override;
+    void post(std::function<void()> task) override;
+    bool posts_inline() const override { return !options_.executor; }
+
+    // Byte-mode call on the calling thread
+    std::vector<uint8_t> call(const std::string& method, const std::vector<uint8_t>& request);
+
+    const InProcessOptions& options() const { return options_; }
+
+private:
+    struct Route {
+        std::shared_ptr<BaseService> service;
+        std::string method;
+        const std::any* object_method = nullptr;
+    };
+
+    // "Service.Method" -> route, cached; throws RpcException for unknown services
+    const Route& resolve(const std::string& qualified_method);
+
+    ServiceManager& services_;
+    InProcessOptions options_;
+    std::unordered_map<std::string, Route> routes_;
+    std::mutex routes_mutex_;
+    std::atomic<bool> connected_;
+};
+
+} // namespace bitrpc
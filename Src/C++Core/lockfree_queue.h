@@ -0,0 +1,367 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace bitrpc {
+
+// In-process queues for handing work between threads (receive loop -> workers,
+// submitters -> executor). Producer and consumer indices live on separate cache lines
+// so the two sides do not invalidate each other's lines on every operation.
+constexpr size_t kCacheLineSize = 64;
+
+namespace detail {
+
+inline size_t round_up_to_power_of_two(size_t value) {
+    if (value < 2) {
+        return 2;
+    }
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Spin-wait hint: lets the sibling hyper-thread run and avoids a memory-order
+// pipeline flush when the awaited store arrives
+inline void cpu_relax() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace detail
+
+// Bounded single-producer/single-consumer ring. Capacity is rounded up to a power of
+// two. T must be default-constructible and move-assignable; popped slots keep a
+// moved-from value until they are overwritten.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : mask_(detail::round_up_to_power_of_two(capacity) - 1), slots_(mask_ + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool try_push(T&& value) { return push_batch(&value, 1) == 1; }
+    bool try_push(const T& value) {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+    // Moves up to count items out of values; returns how many fit. One release store
+    // publishes the whole batch.
+    size_t push_batch(T* values, size_t count);
+
+    // Consumer side
+    bool try_pop(T& value) { return pop_batch(&value, 1) == 1; }
+    // Moves up to max_count items into out; returns how many were taken
+    size_t pop_batch(T* out, size_t max_count);
+    bool empty() const { return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return mask_ + 1; }
+    size_t size_approx() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    // Consumer-owned line
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+    // Producer-owned line
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    alignas(kCacheLineSize) const size_t mask_;
+    std::vector<T> slots_;
+};
+
+template<typename T>
+size_t SpscQueue<T>::push_batch(T* values, size_t count) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t free_slots = capacity() - (tail - cached_head_);
+    if (free_slots < count) {
+        // Only re-read the consumer's index when the cached copy says we are short
+        cached_head_ = head_.load(std::memory_order_acquire);
+        free_slots = capacity() - (tail - cached_head_);
+    }
+    size_t n = count < free_slots ? count : free_slots;
+    for (size_t i = 0; i < n; ++i) {
+        slots_[(tail + i) & mask_] = std::move(values[i]);
+    }
+    if (n > 0) {
+        tail_.store(tail + n, std::memory_order_release);
+    }
+    return n;
+}
+
+template<typename T>
+size_t SpscQueue<T>::pop_batch(T* out, size_t max_count) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t available = cached_tail_ - head;
+    if (available < max_count) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        available = cached_tail_ - head;
+    }
+    size_t n = max_count < available ? max_count : available;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = std::move(slots_[(head + i) & mask_]);
+    }
+    if (n > 0) {
+        head_.store(head + n, std::memory_order_release);
+    }
+    return n;
+}
+
+// Bounded multi-producer/single-consumer ring (per-cell sequence numbers, after
+// Vyukov's bounded queue). Producers claim positions with a CAS on the tail and publish
+// each cell separately, so a slow producer only holds up the consumer at its own cell.
+// Same requirements on T as SpscQueue.
+template<typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity)
+        : mask_(detail::round_up_to_power_of_two(capacity) - 1), cells_(mask_ + 1) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, any number of threads
+    bool try_push(T&& value);
+    bool try_push(const T& value) {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+    // Claims as many consecutive cells as are free (up to count) with a single CAS
+    size_t push_batch(T* values, size_t count);
+
+    // Consumer side, one thread
+    bool try_pop(T& value) { return pop_batch(&value, 1) == 1; }
+    size_t pop_batch(T* out, size_t max_count);
+    bool empty() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        return cells_[head & mask_].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    alignas(kCacheLineSize) const size_t mask_;
+    std::vector<Cell> cells_;
+};
+
+template<typename T>
+bool MpscQueue<T>::try_push(T&& value) {
+    size_t position = tail_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[position & mask_];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;  // full: the consumer has not released this cell yet
+        } else {
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+size_t MpscQueue<T>::push_batch(T* values, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t position = tail_.load(std::memory_order_relaxed);
+    size_t n;
+    for (;;) {
+        // head_ only moves forward, so a stale value under-reports free cells
+        size_t used = position - head_.load(std::memory_order_acquire);
+        size_t free_cells = used < capacity() ? capacity() - used : 0;
+        n = count < free_cells ? count : free_cells;
+        if (n == 0) {
+            return 0;
+        }
+        if (tail_.compare_exchange_weak(position, position + n, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        Cell& cell = cells_[(position + i) & mask_];
+        cell.value = std::move(values[i]);
+        cell.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    return n;
+}
+
+template<typename T>
+size_t MpscQueue<T>::pop_batch(T* out, size_t max_count) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t n = 0;
+    while (n < max_count) {
+        Cell& cell = cells_[(head + n) & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head + n + 1) {
+            break;  // empty, or the producer of this cell has not finished writing it
+        }
+        out[n] = std::move(cell.value);
+        cell.sequence.store(head + n + capacity(), std::memory_order_release);
+        ++n;
+    }
+    if (n > 0) {
+        head_.store(head + n, std::memory_order_release);
+    }
+    return n;
+}
+
+// Link for IntrusiveMpscQueue; derive queued types from it
+struct MpscNode {
+    std::atomic<MpscNode*> mpsc_next{nullptr};
+};
+
+// Unbounded multi-producer/single-consumer queue of caller-owned nodes (Vyukov's
+// intrusive queue). push is one atomic exchange and never allocates; a chain of nodes
+// is pushed with the same single exchange. A node must not be pushed again before it
+// has been popped.
+template<typename T>
+class IntrusiveMpscQueue {
+public:
+    IntrusiveMpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    IntrusiveMpscQueue(const IntrusiveMpscQueue&) = delete;
+    IntrusiveMpscQueue& operator=(const IntrusiveMpscQueue&) = delete;
+
+    // Producer side
+    void push(T* node) { push_chain(node, node); }
+    void push_batch(T* const* nodes, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        for (size_t i = 0; i + 1 < count; ++i) {
+            nodes[i]->mpsc_next.store(nodes[i + 1], std::memory_order_relaxed);
+        }
+        push_chain(nodes[0], nodes[count - 1]);
+    }
+
+    // Consumer side. Returns nullptr when empty, and also for the short window in which
+    // a producer has swapped the head but not yet linked its node; empty() then reports
+    // false so the consumer retries instead of going to sleep.
+    T* pop();
+    bool empty() const {
+        // tail_ is the next node to hand out unless it is the stub
+        if (tail_ != &stub_) {
+            return false;
+        }
+        return stub_.mpsc_next.load(std::memory_order_acquire) == nullptr &&
+               head_.load(std::memory_order_acquire) == &stub_;
+    }
+
+private:
+    void push_chain(MpscNode* first, MpscNode* last) {
+        last->mpsc_next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* previous = head_.exchange(last, std::memory_order_acq_rel);
+        previous->mpsc_next.store(first, std::memory_order_release);
+    }
+
+    alignas(kCacheLineSize) std::atomic<MpscNode*> head_;  // producers
+    alignas(kCacheLineSize) MpscNode* tail_;               // consumer
+    MpscNode stub_;
+};
+
+template<typename T>
+T* IntrusiveMpscQueue<T>::pop() {
+    MpscNode* tail = tail_;
+    MpscNode* next = tail->mpsc_next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+        if (!next) {
+            return nullptr;
+        }
+        tail_ = next;
+        tail = next;
+        next = next->mpsc_next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail_ = next;
+        return static_cast<T*>(tail);
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+        return nullptr;  // a push is in progress
+    }
+    // tail is the last node: put the stub behind it so tail can be handed out
+    push_chain(&stub_, &stub_);
+    next = tail->mpsc_next.load(std::memory_order_acquire);
+    if (next) {
+        tail_ = next;
+        return static_cast<T*>(tail);
+    }
+    return nullptr;
+}
+
+// Lets a consumer sleep on an empty queue without producers taking a lock on every
+// push: notify() only locks when the consumer has announced that it is about to sleep.
+// Producers call notify() after pushing; the consumer calls wait() after finding its
+// queue empty (usually after spinning for a while).
+class QueueWaiter {
+public:
+    // Sleeps until notify(), ready() or the timeout; ready() is re-checked after the
+    // sleep is announced, so a push racing with wait() is never missed
+    template<typename Ready>
+    void wait(Ready ready, std::chrono::milliseconds timeout) {
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready()) {
+            sleeping_.store(false, std::memory_order_relaxed);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait_for(lock, timeout, [this]() { return !sleeping_.load(std::memory_order_relaxed); });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                sleeping_.store(false, std::memory_order_relaxed);
+            }
+            wakeup_.notify_one();
+        }
+    }
+
+private:
+    std::atomic<bool> sleeping_{false};
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+};
+
+} // namespace bitrpc
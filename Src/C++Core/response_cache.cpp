@@ -0,0 +1,162 @@
+#include "response_cache.h"
+#include <algorithm>
+
+namespace bitrpc {
+
+namespace {
+// Approximate bookkeeping cost of an entry beyond key and value bytes
+constexpr size_t kEntryOverhead = 96;
+}
+
+ShardedLruCache::ShardedLruCache() : ShardedLruCache(Options()) {}
+
+ShardedLruCache::ShardedLruCache(const Options& options) : options_(options) {
+    options_.shard_count = std::max<size_t>(1, options_.shard_count);
+    shard_budget_ = std::max<size_t>(1, options_.max_bytes / options_.shard_count);
+    shards_.reserve(options_.shard_count);
+    for (size_t i = 0; i < options_.shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+ShardedLruCache::Shard& ShardedLruCache::shard_for(std::string_view key) {
+    return *shards_[std::hash<std::string_view>()(key) % shards_.size()];
+}
+
+ShardedLruCache::Value ShardedLruCache::get(std::string_view key) {
+    Shard& shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        ++shard.stats.misses;
+        return nullptr;
+    }
+
+    auto it = found->second;
+    // Entries without a ttl (e.g. encoded fragments) skip the clock read
+    if (it->expires_at != Clock::time_point::max() && Clock::now() >= it->expires_at) {
+        ++shard.stats.expirations;
+        ++shard.stats.misses;
+        remove_locked(shard, it);
+        return nullptr;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it);
+    ++shard.stats.hits;
+    return it->value;
+}
+
+void ShardedLruCache::put(std::string_view key, Value value, std::chrono::milliseconds ttl) {
+    insert(key, std::move(value), ttl, nullptr);
+}
+
+bool ShardedLruCache::put_if_generation(std::string_view key, Value value, std::chrono::milliseconds ttl,
+                                        uint64_t generation) {
+    return insert(key, std::move(value), ttl, &generation);
+}
+
+bool ShardedLruCache::insert(std::string_view key, Value value, std::chrono::milliseconds ttl,
+                             const uint64_t* generation) {
+    if (!value) {
+        return false;
+    }
+
+    size_t charge = key.size() + value->size() + kEntryOverhead;
+    if (charge > shard_budget_) {
+        return false;  // would evict the whole shard for a single entry
+    }
+
+    auto expires_at = ttl.count() > 0 ? Clock::now() + ttl : Clock::time_point::max();
+
+    Shard& shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Invalidations advance the generation before taking any shard lock, so checking it
+    // under the lock either sees the change or runs before the invalidation reaches this shard
+    if (generation && generation_.load(std::memory_order_acquire) != *generation) {
+        return false;
+    }
+
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        remove_locked(shard, found->second);
+    }
+
+    shard.lru.push_front(Entry{std::string(key), std::move(value), expires_at, charge});
+    shard.index.emplace(std::string_view(shard.lru.front().key), shard.lru.begin());
+    shard.bytes += charge;
+    ++shard.stats.insertions;
+
+    while (shard.bytes > shard_budget_ && !shard.lru.empty()) {
+        remove_locked(shard, std::prev(shard.lru.end()));
+        ++shard.stats.evictions;
+    }
+    return true;
+}
+
+bool ShardedLruCache::erase(std::string_view key) {
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    Shard& shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        return false;
+    }
+    remove_locked(shard, found->second);
+    return true;
+}
+
+size_t ShardedLruCache::erase_if(const std::function<bool(std::string_view key)>& predicate) {
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    size_t erased = 0;
+    for (auto& shard_ptr : shards_) {
+        Shard& shard = *shard_ptr;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+            auto next = std::next(it);
+            if (predicate(it->key)) {
+                remove_locked(shard, it);
+                ++erased;
+            }
+            it = next;
+        }
+    }
+    return erased;
+}
+
+void ShardedLruCache::clear() {
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    for (auto& shard_ptr : shards_) {
+        Shard& shard = *shard_ptr;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+ShardedLruCache::Stats ShardedLruCache::stats() const {
+    Stats total;
+    for (const auto& shard_ptr : shards_) {
+        const Shard& shard = *shard_ptr;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total.hits += shard.stats.hits;
+        total.misses += shard.stats.misses;
+        total.insertions += shard.stats.insertions;
+        total.evictions += shard.stats.evictions;
+        total.expirations += shard.stats.expirations;
+        total.entries += shard.lru.size();
+        total.bytes += shard.bytes;
+    }
+    return total;
+}
+
+void ShardedLruCache::remove_locked(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->charge;
+    shard.index.erase(std::string_view(it->key));
+    shard.lru.erase(it);
+}
+
+} // namespace bitrpc
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace bitrpc {
+
+// Per-method result caching, set at registration (PDL: [cacheable ttl=5s])
+struct CachePolicy {
+    bool enabled = false;
+    std::chrono::milliseconds ttl{0};  // 0: entries leave only through LRU eviction or invalidation
+    size_t max_bytes = 16 * 1024 * 1024;
+    size_t shard_count = 16;
+
+    static CachePolicy cacheable(std::chrono::milliseconds ttl) {
+        CachePolicy policy;
+        policy.enabled = true;
+        policy.ttl = ttl;
+        return policy;
+    }
+};
+
+// Byte-bounded LRU cache split into independently locked shards.
+// Keys are raw byte strings (e.g. encoded requests), values are immutable byte buffers
+// shared with readers, so a hit never copies under the shard lock.
+class ShardedLruCache {
+public:
+    using Value = std::shared_ptr<const std::vector<uint8_t>>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        size_t shard_count = 16;
+        size_t max_bytes = 16 * 1024 * 1024;  // total budget across all shards
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    ShardedLruCache();
+    explicit ShardedLruCache(const Options& options);
+
+    // Returns nullptr on miss or if the entry has expired
+    Value get(std::string_view key);
+    void put(std::string_view key, Value value, std::chrono::milliseconds ttl);
+    // Stores only if no erase/erase_if/clear ran since generation() returned `generation`,
+    // so a value computed before an invalidation cannot resurrect stale data.
+    // Returns whether the value was stored.
+    bool put_if_generation(std::string_view key, Value value, std::chrono::milliseconds ttl,
+                           uint64_t generation);
+    bool erase(std::string_view key);
+    size_t erase_if(const std::function<bool(std::string_view key)>& predicate);
+    void clear();
+
+    // Advanced by every invalidation (erase, erase_if, clear)
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        Value value;
+        Clock::time_point expires_at;  // time_point::max() if no ttl
+        size_t charge;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;  // most recently used first
+        // Keys view into Entry::key; list nodes are stable
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        Stats stats;
+    };
+
+    Shard& shard_for(std::string_view key);
+    bool insert(std::string_view key, Value value, std::chrono::milliseconds ttl, const uint64_t* generation);
+    void remove_locked(Shard& shard, std::list<Entry>::iterator it);
+
+    Options options_;
+    size_t shard_budget_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace bitrpc
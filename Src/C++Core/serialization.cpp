@@ -83,6 +83,11 @@ namespace bitrpc {
         return new int32_t(value);
     }
 
+    bool Int32Handler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<int32_t*>(obj) = reader.read_int32();
+        return true;
+    }
+
     // Int64Handler implementation
     void Int64Handler::write(const void* obj, StreamWriter& writer) const {
         auto value = static_cast<const int64_t*>(obj);
@@ -94,6 +99,11 @@ namespace bitrpc {
         return new int64_t(value);
     }
 
+    bool Int64Handler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<int64_t*>(obj) = reader.read_int64();
+        return true;
+    }
+
     // FloatHandler implementation
     void FloatHandler::write(const void* obj, StreamWriter& writer) const {
         auto value = static_cast<const float*>(obj);
@@ -105,6 +115,11 @@ namespace bitrpc {
         return new float(value);
     }
 
+    bool FloatHandler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<float*>(obj) = reader.read_float();
+        return true;
+    }
+
     // DoubleHandler implementation
     void DoubleHandler::write(const void* obj, StreamWriter& writer) const {
         auto value = static_cast<const double*>(obj);
@@ -116,6 +131,11 @@ namespace bitrpc {
         return new double(value);
     }
 
+    bool DoubleHandler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<double*>(obj) = reader.read_double();
+        return true;
+    }
+
     // BoolHandler implementation
     void BoolHandler::write(const void* obj, StreamWriter& writer) const {
         auto value = static_cast<const bool*>(obj);
@@ -127,6 +147,11 @@ namespace bitrpc {
         return new bool(value);
     }
 
+    bool BoolHandler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<bool*>(obj) = reader.read_bool();
+        return true;
+    }
+
     // StringHandler implementation
     void StringHandler::write(const void* obj, StreamWriter& writer) const {
         auto value = static_cast<const std::string*>(obj);
@@ -138,6 +163,11 @@ namespace bitrpc {
         return new std::string(std::move(value));
     }
 
+    bool StringHandler::read_into(StreamReader& reader, void* obj) const {
+        reader.read_string_into(*static_cast<std::string*>(obj));
+        return true;
+    }
+
     // BytesHandler implementation
     void BytesHandler::write(const void* obj, StreamWriter& writer) const {
         auto value = static_cast<const std::vector<uint8_t>*>(obj);
@@ -149,6 +179,11 @@ namespace bitrpc {
         return new std::vector<uint8_t>(std::move(value));
     }
 
+    bool BytesHandler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<std::vector<uint8_t>*>(obj) = reader.read_bytes();
+        return true;
+    }
+
     // DateTimeHandler implementation
     void DateTimeHandler::write(const void* obj, StreamWriter& writer) const {
         auto time_point = static_cast<const std::chrono::system_clock::time_point*>(obj);
@@ -162,6 +197,11 @@ namespace bitrpc {
         return new std::chrono::system_clock::time_point(time_point);
     }
 
+    bool DateTimeHandler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<std::chrono::system_clock::time_point*>(obj) = reader.read_datetime();
+        return true;
+    }
+
     // Vector3Handler implementation
     void Vector3Handler::write(const void* obj, StreamWriter& writer) const {
         auto vec = static_cast<const Vector3*>(obj);
@@ -178,6 +218,11 @@ namespace bitrpc {
         return vec;
     }
 
+    bool Vector3Handler::read_into(StreamReader& reader, void* obj) const {
+        *static_cast<Vector3*>(obj) = reader.read_vector3();
+        return true;
+    }
+
     // StreamWriter additional methods
     void StreamWriter::write_datetime(const std::chrono::system_clock::time_point& time) {
         auto timestamp = std::chrono::system_clock::to_time_t(time);
@@ -282,6 +327,8 @@ namespace bitrpc {
     // StreamWriter core implementation
     StreamWriter::StreamWriter() : position_(0) {}
 
+    StreamWriter::StreamWriter(std::pmr::memory_resource* resource) : buffer_(resource), position_(0) {}
+
     void StreamWriter::write_int32(int32_t value) {
         buffer_.resize(buffer_.size() + sizeof(int32_t));
         std::memcpy(buffer_.data() + position_, &value, sizeof(int32_t));
@@ -318,7 +365,7 @@ namespace bitrpc {
         position_ += sizeof(bool);
     }
 
-    void StreamWriter::write_string(const std::string& value) {
+    void StreamWriter::write_string(std::string_view value) {
         write_int32(static_cast<int32_t>(value.size()));
         buffer_.resize(buffer_.size() + value.size());
         std::memcpy(buffer_.data() + position_, value.data(), value.size());
@@ -332,6 +379,13 @@ namespace bitrpc {
         position_ += bytes.size();
     }
 
+    void StreamWriter::write_raw(const uint8_t* data, size_t size) {
+        if (size == 0) return;
+        buffer_.resize(buffer_.size() + size);
+        std::memcpy(buffer_.data() + position_, data, size);
+        position_ += size;
+    }
+
     void StreamWriter::write_object(const void* obj, size_t type_hash) {
         auto hash = BufferSerializer::instance().get_handler(type_hash)->hash_code();
 		write_int32(static_cast<int32_t>(hash));
@@ -339,88 +393,99 @@ namespace bitrpc {
     }
 
     std::vector<uint8_t> StreamWriter::to_array() const {
-        return buffer_;
+        return std::vector<uint8_t>(buffer_.begin(), buffer_.end());
+    }
+
+    std::pmr::vector<uint8_t> StreamWriter::release_buffer() {
+        std::pmr::vector<uint8_t> result(std::move(buffer_));
+        buffer_ = std::pmr::vector<uint8_t>(result.get_allocator());
+        position_ = 0;
+        return result;
     }
 
     // StreamReader core implementation
-    StreamReader::StreamReader(const std::vector<uint8_t>& data) : data_(data), position_(0) {}
+    StreamReader::StreamReader(const std::vector<uint8_t>& data)
+        : data_(data.data()), size_(data.size()), position_(0) {}
+
+    StreamReader::StreamReader(const uint8_t* data, size_t size)
+        : data_(data), size_(size), position_(0) {}
 
     int32_t StreamReader::read_int32() {
-        if (position_ + sizeof(int32_t) > data_.size()) {
+        if (position_ + sizeof(int32_t) > size_) {
             throw std::runtime_error("Buffer underflow");
         }
         int32_t value;
-        std::memcpy(&value, data_.data() + position_, sizeof(int32_t));
+        std::memcpy(&value, data_ + position_, sizeof(int32_t));
         position_ += sizeof(int32_t);
         return value;
     }
 
     int64_t StreamReader::read_int64() {
-        if (position_ + sizeof(int64_t) > data_.size()) {
+        if (position_ + sizeof(int64_t) > size_) {
             throw std::runtime_error("Buffer underflow");
         }
         int64_t value;
-        std::memcpy(&value, data_.data() + position_, sizeof(int64_t));
+        std::memcpy(&value, data_ + position_, sizeof(int64_t));
         position_ += sizeof(int64_t);
         return value;
     }
 
     uint32_t StreamReader::read_uint32() {
-        if (position_ + sizeof(uint32_t) > data_.size()) {
+        if (position_ + sizeof(uint32_t) > size_) {
             throw std::runtime_error("Buffer underflow");
         }
         uint32_t value;
-        std::memcpy(&value, data_.data() + position_, sizeof(uint32_t));
+        std::memcpy(&value, data_ + position_, sizeof(uint32_t));
         position_ += sizeof(uint32_t);
         return value;
     }
 
     float StreamReader::read_float() {
-        if (position_ + sizeof(float) > data_.size()) {
+        if (position_ + sizeof(float) > size_) {
             throw std::runtime_error("Buffer underflow");
         }
         float value;
-        std::memcpy(&value, data_.data() + position_, sizeof(float));
+        std::memcpy(&value, data_ + position_, sizeof(float));
         position_ += sizeof(float);
         return value;
     }
 
     double StreamReader::read_double() {
-        if (position_ + sizeof(double) > data_.size()) {
+        if (position_ + sizeof(double) > size_) {
             throw std::runtime_error("Buffer underflow");
         }
         double value;
-        std::memcpy(&value, data_.data() + position_, sizeof(double));
+        std::memcpy(&value, data_ + position_, sizeof(double));
         position_ += sizeof(double);
         return value;
     }
 
     bool StreamReader::read_bool() {
-        if (position_ + sizeof(bool) > data_.size()) {
+        if (position_ + sizeof(bool) > size_) {
             throw std::runtime_error("Buffer underflow");
         }
         bool value;
-        std::memcpy(&value, data_.data() + position_, sizeof(bool));
+        std::memcpy(&value, data_ + position_, sizeof(bool));
         position_ += sizeof(bool);
         return value;
     }
 
     std::string StreamReader::read_string() {
         int32_t length = read_int32();
-        if (position_ + length > data_.size()) {
+        if (position_ + length > size_) {
             throw std::runtime_error("Buffer underflow");
         }
-        std::string value(data_.data() + position_, data_.data() + position_ + length);
+        std::string value(data_ + position_, data_ + position_ + length);
         position_ += length;
         return value;
     }
 
     std::vector<uint8_t> StreamReader::read_bytes() {
         int32_t length = read_int32();
-        if (position_ + length > data_.size()) {
+        if (position_ + length > size_) {
             throw std::runtime_error("Buffer underflow");
         }
-        std::vector<uint8_t> value(data_.data() + position_, data_.data() + position_ + length);
+        std::vector<uint8_t> value(data_ + position_, data_ + position_ + length);
         position_ += length;
         return value;
     }
@@ -432,7 +497,8 @@ namespace bitrpc {
 
         uint32_t type_hash = read_uint32();
 
-        auto* handler = BufferSerializer::instance().get_handler(type_hash);
+        // The wire carries the handler's hash code, not the C++ typeid hash
+        auto* handler = BufferSerializer::instance().get_handler_by_hash_code(static_cast<int>(type_hash));
         if (!handler) {
             throw std::runtime_error("No TypeHandler registered for type hash: " + std::to_string(type_hash));
         }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <cstdint>
 #include <unordered_map>
@@ -89,6 +92,10 @@ namespace bitrpc {
         virtual void write(const void* obj, StreamWriter& writer) const = 0;
         virtual void* read(StreamReader& reader) const = 0;
 
+        // Read into an existing object instead of allocating a new one.
+        // Returns false if the handler does not support in-place reads.
+        virtual bool read_into(StreamReader& reader, void* obj) const { (void)reader; (void)obj; return false; }
+
         // Static is_default method to be implemented by each concrete handler
         virtual bool is_default(const void* obj) const = 0;
 
@@ -126,6 +133,8 @@ namespace bitrpc {
     class StreamWriter {
     public:
         StreamWriter();
+        // Buffer storage is drawn from the given resource (e.g. a per-call RpcArena)
+        explicit StreamWriter(std::pmr::memory_resource* resource);
 
         void write_int32(int32_t value);
         void write_int64(int64_t value);
@@ -133,8 +142,10 @@ namespace bitrpc {
         void write_float(float value);
         void write_double(double value);
         void write_bool(bool value);
-        void write_string(const std::string& value);
+        void write_string(std::string_view value);
         void write_bytes(const std::vector<uint8_t>& bytes);
+        // Append already-encoded bytes as they are (no length prefix)
+        void write_raw(const uint8_t* data, size_t size);
 
         // Enhanced write methods
         void write_datetime(const std::chrono::system_clock::time_point& time);
@@ -154,19 +165,38 @@ namespace bitrpc {
             }
         }
 
+        // Vector writing without std::function; works for std::vector and std::pmr::vector
+        template<typename TContainer, typename TWriteItem>
+        void write_vector_items(const TContainer& items, TWriteItem write_item) {
+            write_int32(static_cast<int32_t>(items.size()));
+            for (const auto& item : items) {
+                write_item(item);
+            }
+        }
+
         void write_object(const void* obj, size_t type_hash);
 
+        void reserve(size_t capacity) { buffer_.reserve(capacity); }
+        const uint8_t* data() const { return buffer_.data(); }
+        size_t size() const { return buffer_.size(); }
+
         std::vector<uint8_t> to_array() const;
 
+        // Hand the buffer over without copying; the writer is left empty
+        std::pmr::vector<uint8_t> release_buffer();
+
     private:
-        std::vector<uint8_t> buffer_;
+        std::pmr::vector<uint8_t> buffer_;
         size_t position_;
     };
 
-    // Stream reader for deserialization
+    // Stream reader for deserialization.
+    // The reader does not copy its input: the data must outlive the reader.
     class StreamReader {
     public:
         explicit StreamReader(const std::vector<uint8_t>& data);
+        explicit StreamReader(std::vector<uint8_t>&& data) = delete;
+        StreamReader(const uint8_t* data, size_t size);
 
         int32_t read_int32();
         int64_t read_int64();
@@ -197,14 +227,42 @@ namespace bitrpc {
             return result;
         }
 
+        // Read a string into an existing string object (std::string or std::pmr::string)
+        template<typename TString>
+        void read_string_into(TString& out) {
+            int32_t length = read_int32();
+            if (length < 0 || static_cast<size_t>(length) > available_data()) {
+                throw std::runtime_error("Buffer underflow");
+            }
+            out.assign(reinterpret_cast<const char*>(data_ + position_), static_cast<size_t>(length));
+            position_ += static_cast<size_t>(length);
+        }
+
+        // Read a vector in place; items are default-constructed in the container (so
+        // allocator-aware containers propagate their allocator) and filled by read_item
+        template<typename TContainer, typename TReadItem>
+        void read_vector_into(TContainer& out, TReadItem read_item) {
+            int32_t size = read_int32();
+            out.clear();
+            // The count comes off the wire: reserve no more than the remaining bytes could
+            // hold, so a corrupt length cannot force a huge allocation up front
+            size_t reserve_limit = available_data() / sizeof(typename TContainer::value_type);
+            out.reserve(size > 0 ? std::min(static_cast<size_t>(size), reserve_limit) : 0);
+            for (int32_t i = 0; i < size; ++i) {
+                out.emplace_back();
+                read_item(out.back());
+            }
+        }
+
         void* read_object();
 
         // Check if more data is available
-        bool has_more_data() const { return position_ < data_.size(); }
-        size_t available_data() const { return data_.size() - position_; }
+        bool has_more_data() const { return position_ < size_; }
+        size_t available_data() const { return size_ - position_; }
 
     private:
-        std::vector<uint8_t> data_;
+        const uint8_t* data_;
+        size_t size_;
         size_t position_;
     };
 
@@ -333,6 +391,7 @@ namespace bitrpc {
         int hash_code() const override { return 101; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -350,6 +409,7 @@ namespace bitrpc {
         int hash_code() const override { return 102; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -367,6 +427,7 @@ namespace bitrpc {
         int hash_code() const override { return 103; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -384,6 +445,7 @@ namespace bitrpc {
         int hash_code() const override { return 104; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -401,6 +463,7 @@ namespace bitrpc {
         int hash_code() const override { return 105; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -418,6 +481,7 @@ namespace bitrpc {
         int hash_code() const override { return 106; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -435,6 +499,7 @@ namespace bitrpc {
         int hash_code() const override { return 107; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -453,6 +518,7 @@ namespace bitrpc {
         int hash_code() const override { return 201; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -470,6 +536,7 @@ namespace bitrpc {
         int hash_code() const override { return 202; }
         void write(const void* obj, StreamWriter& writer) const override;
         void* read(StreamReader& reader) const override;
+        bool read_into(StreamReader& reader, void* obj) const override;
         bool is_default(const void* obj) const override;
 
         // Singleton instance
@@ -1,8 +1,11 @@
 #include "server.h"
 #include "serialization.h"
+#include "client.h"
+#include "timer_wheel.h"
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <cstring>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -20,6 +23,12 @@
 #define closesocket close
 #endif
 
+// Writes to a peer that has gone away (timed out, reaped as idle) must fail with EPIPE
+// rather than raise SIGPIPE
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 namespace bitrpc {
 
 ServiceManager::ServiceManager() = default;
@@ -27,12 +36,32 @@ ServiceManager::~ServiceManager() = default;
 
 void ServiceManager::register_service(std::shared_ptr<BaseService> service) {
     std::lock_guard<std::mutex> lock(services_mutex_);
-    services_[service->service_name()] = service;
+    std::string service_name = service->service_name();
+
+    // Method ids are 32-bit hashes; refuse a service whose ids clash with another method
+    std::vector<std::pair<uint32_t, std::string>> ids;
+    for (const auto& method_name : service->method_names()) {
+        uint32_t id = FrameCodec::method_id(service_name, method_name);
+        auto it = method_ids_.find(id);
+        if (it != method_ids_.end() && it->second.first != service_name) {
+            throw std::runtime_error("Method id collision between " + service_name + "." + method_name +
+                                     " and " + it->second.first + "." + it->second.second);
+        }
+        ids.emplace_back(id, method_name);
+    }
+
+    services_[service_name] = service;
+    for (auto& entry : ids) {
+        method_ids_[entry.first] = {service_name, std::move(entry.second)};
+    }
 }
 
 void ServiceManager::unregister_service(const std::string& service_name) {
     std::lock_guard<std::mutex> lock(services_mutex_);
     services_.erase(service_name);
+    for (auto it = method_ids_.begin(); it != method_ids_.end();) {
+        it = (it->second.first == service_name) ? method_ids_.erase(it) : std::next(it);
+    }
 }
 
 std::shared_ptr<BaseService> ServiceManager::get_service(const std::string& service_name) const {
@@ -56,8 +85,59 @@ std::vector<std::string> ServiceManager::get_service_names() const {
     return names;
 }
 
+bool ServiceManager::resolve_method_id(uint32_t method_id, std::string& service_name, std::string& method_name) const {
+    std::lock_guard<std::mutex> lock(services_mutex_);
+    auto it = method_ids_.find(method_id);
+    if (it == method_ids_.end()) {
+        // Unknown ids are cheap to reject: the services are only rescanned when a method
+        // has been registered since the last scan
+        uint64_t generation = BaseService::registration_generation();
+        if (generation == indexed_generation_) {
+            return false;
+        }
+        index_new_methods_locked();
+        indexed_generation_ = generation;
+        it = method_ids_.find(method_id);
+        if (it == method_ids_.end()) {
+            return false;
+        }
+    }
+    service_name = it->second.first;
+    method_name = it->second.second;
+    return true;
+}
+
+void ServiceManager::index_new_methods_locked() const {
+    // Methods are never removed from a service, so existing entries stay; an id that
+    // clashes with another method is refused, as at registration
+    for (const auto& pair : services_) {
+        for (const auto& method_name : pair.second->method_names()) {
+            uint32_t id = FrameCodec::method_id(pair.first, method_name);
+            auto it = method_ids_.find(id);
+            if (it == method_ids_.end()) {
+                method_ids_.emplace(id, std::make_pair(pair.first, method_name));
+            } else if (it->second.first != pair.first || it->second.second != method_name) {
+                std::cerr << "Method id collision between " << pair.first << "." << method_name << " and "
+                          << it->second.first << "." << it->second.second << "; not reachable by id" << std::endl;
+            }
+        }
+    }
+}
+
+std::atomic<uint64_t> BaseService::registration_generation_{0};
+
 BaseService::BaseService(const std::string& name) : name_(name) {}
 
+std::vector<std::string> BaseService::method_names() const {
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    std::vector<std::string> names;
+    names.reserve(methods_.size() + async_methods_.size() + stream_methods_.size());
+    for (const auto& pair : methods_) names.push_back(pair.first);
+    for (const auto& pair : async_methods_) names.push_back(pair.first);
+    for (const auto& pair : stream_methods_) names.push_back(pair.first);
+    return names;
+}
+
 bool BaseService::has_method(const std::string& method_name) const {
     std::lock_guard<std::mutex> lock(methods_mutex_);
     return methods_.find(method_name) != methods_.end();
@@ -73,39 +153,108 @@ bool BaseService::has_stream_method(const std::string& method_name) const {
     return stream_methods_.find(method_name) != stream_methods_.end();
 }
 
-void* BaseService::call_method(const std::string& method_name, void* request) {
-    std::lock_guard<std::mutex> lock(methods_mutex_);
-    auto it = methods_.find(method_name);
-    if (it != methods_.end()) {
-        return it->second(request);
+// The lock only covers the lookup: handlers of different connections run concurrently
+// (batch methods depend on it). Methods are registered while the service is being set
+// up and never erased, so the wrapper stays valid after unlocking.
+template<typename TMap>
+static typename TMap::mapped_type* find_method(TMap& methods, const std::string& method_name, std::mutex& mutex) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = methods.find(method_name);
+    return it != methods.end() ? &it->second : nullptr;
+}
+
+RpcResponseBuffer* BaseService::call_method(const std::string& method_name, RpcCallContext& context) {
+    if (auto* method = find_method(methods_, method_name, methods_mutex_)) {
+        return (*method)(context);
     }
     throw std::runtime_error("Method not found: " + method_name);
 }
 
-std::future<void*> BaseService::call_method_async(const std::string& method_name, void* request) {
-    std::lock_guard<std::mutex> lock(methods_mutex_);
-    auto it = async_methods_.find(method_name);
-    if (it != async_methods_.end()) {
-        return it->second(request);
+std::future<RpcResponseBuffer*> BaseService::call_method_async(const std::string& method_name, RpcCallContext& context) {
+    if (auto* method = find_method(async_methods_, method_name, methods_mutex_)) {
+        return (*method)(context);
     }
     throw std::runtime_error("Async method not found: " + method_name);
 }
 
 std::shared_ptr<StreamResponseReader> BaseService::call_stream_method(const std::string& method_name,
-                                                                     const std::vector<uint8_t>& request_bytes) {
-    std::lock_guard<std::mutex> lock(methods_mutex_);
-    auto it = stream_methods_.find(method_name);
-    if (it != stream_methods_.end()) {
-        // We pass bytes pointer to registered wrapper which deserializes
-        return it->second(const_cast<void*>(static_cast<const void*>(&request_bytes)));
+                                                                     RpcCallContext& context) {
+    if (auto* method = find_method(stream_methods_, method_name, methods_mutex_)) {
+        // The registered wrapper deserializes from the context bytes
+        return (*method)(context);
     }
     throw std::runtime_error("Stream method not found: " + method_name);
 }
 
-TcpRpcServer::TcpRpcServer()
+void BaseService::invalidate_cache(const std::string& method_name) {
+    auto cache = method_cache(method_name);
+    if (cache) {
+        cache->clear();
+    }
+}
+
+void BaseService::invalidate_cache(const std::string& method_name, const std::vector<uint8_t>& request_bytes) {
+    auto cache = method_cache(method_name);
+    if (cache) {
+        cache->erase(std::string_view(reinterpret_cast<const char*>(request_bytes.data()), request_bytes.size()));
+    }
+}
+
+void BaseService::invalidate_all_caches() {
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    for (auto& entry : method_caches_) {
+        entry.second->clear();
+    }
+}
+
+std::shared_ptr<ShardedLruCache> BaseService::method_cache(const std::string& method_name) const {
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    auto it = method_caches_.find(method_name);
+    return (it != method_caches_.end()) ? it->second : nullptr;
+}
+
+const std::any* BaseService::object_method(const std::string& method_name) const {
+    // Same stability argument as find_method: entries are never erased while serving
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    auto it = object_methods_.find(method_name);
+    return (it != object_methods_.end()) ? &it->second : nullptr;
+}
+
+BatchStatistics BaseService::batch_statistics(const std::string& method_name) const {
+    std::shared_ptr<MethodBatcherBase> batcher;
+    {
+        std::lock_guard<std::mutex> lock(methods_mutex_);
+        auto it = method_batchers_.find(method_name);
+        if (it == method_batchers_.end()) {
+            return BatchStatistics();
+        }
+        batcher = it->second;
+    }
+    return batcher->statistics();
+}
+
+std::shared_ptr<ShardedLruCache> BaseService::create_method_cache_locked(const std::string& method_name,
+                                                                         const CachePolicy& cache_policy) {
+    if (!cache_policy.enabled) {
+        method_caches_.erase(method_name);
+        return nullptr;
+    }
+    ShardedLruCache::Options cache_options;
+    cache_options.shard_count = cache_policy.shard_count;
+    cache_options.max_bytes = cache_policy.max_bytes;
+    auto cache = std::make_shared<ShardedLruCache>(cache_options);
+    method_caches_[method_name] = cache;
+    return cache;
+}
+
+TcpRpcServer::TcpRpcServer() : TcpRpcServer(TransportOptions()) {}
+
+TcpRpcServer::TcpRpcServer(const TransportOptions& transport_options)
     : service_manager_(std::make_shared<ServiceManager>()),
+      transport_options_(transport_options),
       server_socket_(nullptr),
       is_running_(false) {
+    transport_options_.validate();
 #ifdef _WIN32
     initialize_network();
 #endif
@@ -148,6 +297,8 @@ void TcpRpcServer::start_async(const std::string& host, int port) {
 #else
     setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 #endif
+    // Buffer sizes set on the listener are inherited by accepted sockets
+    SocketTuner::apply_pre_connect(reinterpret_cast<void*>(static_cast<intptr_t>(server_sock)), transport_options_);
 
     struct sockaddr_in server_addr;
     server_addr.sin_family = AF_INET;
@@ -159,12 +310,13 @@ void TcpRpcServer::start_async(const std::string& host, int port) {
         throw std::runtime_error("Failed to bind server socket");
     }
 
-    if (listen(server_sock, SOMAXCONN) != 0) {
+    if (listen(server_sock, SocketTuner::listen_backlog(transport_options_)) != 0) {
         closesocket(server_sock);
         throw std::runtime_error("Failed to listen on server socket");
     }
 
     server_socket_ = reinterpret_cast<void*>(static_cast<intptr_t>(server_sock));
+    effective_listener_options_ = SocketTuner::query(server_socket_);
     is_running_ = true;
 
     // Start accept thread
@@ -209,6 +361,15 @@ ServiceManager& TcpRpcServer::service_manager() {
     return *service_manager_;
 }
 
+EffectiveSocketOptions TcpRpcServer::effective_socket_options() const {
+    return effective_listener_options_;
+}
+
+EffectiveSocketOptions TcpRpcServer::last_connection_socket_options() const {
+    std::lock_guard<std::mutex> lock(connection_options_mutex_);
+    return last_connection_options_;
+}
+
 void TcpRpcServer::accept_connections() {
     while (is_running_) {
         SOCKET server_sock = reinterpret_cast<SOCKET>(server_socket_);
@@ -229,6 +390,17 @@ void TcpRpcServer::accept_connections() {
             continue;
         }
 
+        EffectiveSocketOptions effective =
+            SocketTuner::apply_connected(reinterpret_cast<void*>(static_cast<intptr_t>(client_sock)), transport_options_);
+        if ((transport_options_.tcp_nodelay && !effective.tcp_nodelay) ||
+            (transport_options_.keepalive && !effective.keepalive)) {
+            std::cerr << "Connection socket options not fully applied: " << effective.to_string() << std::endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connection_options_mutex_);
+            last_connection_options_ = effective;
+        }
+
         // Start client handler thread
         client_threads_.emplace_back([this, client_sock]() {
             handle_client(reinterpret_cast<void*>(static_cast<intptr_t>(client_sock)));
@@ -246,6 +418,16 @@ static bool recv_all_helper(SOCKET sock, char* buf, size_t len) {
     return true;
 }
 
+static bool send_all_helper(SOCKET sock, const char* buf, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        int s = send(sock, buf + off, static_cast<int>(len - off), MSG_NOSIGNAL);
+        if (s <= 0) return false;
+        off += s;
+    }
+    return true;
+}
+
 static bool is_printable_ascii(const uint8_t* data, size_t len) {
     for (size_t i = 0; i < len; ++i) {
         uint8_t c = data[i];
@@ -254,136 +436,298 @@ static bool is_printable_ascii(const uint8_t* data, size_t len) {
     return true;
 }
 
+void TcpRpcServer::send_reply(void* client_socket, const FrameHeader* request_frame, uint8_t flags,
+                              const uint8_t* data, size_t size) {
+    SOCKET sock = reinterpret_cast<SOCKET>(client_socket);
+
+    // Multi-part writes leave as one segment when corking is enabled
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(client_socket, true);
+    }
+
+    if (!request_frame) {
+        // Legacy framing has no status: errors and end-of-stream are a zero-length frame
+        if (flags & (FRAME_FLAG_ERROR | FRAME_FLAG_DEADLINE_EXCEEDED | FRAME_FLAG_END_OF_STREAM)) {
+            size = 0;
+        }
+        uint32_t length = static_cast<uint32_t>(size);
+        send_all_helper(sock, reinterpret_cast<const char*>(&length), sizeof(length));
+    } else {
+        FrameHeader header;
+        header.flags = static_cast<uint8_t>(flags | FRAME_FLAG_RESPONSE);
+        header.method_id = request_frame->method_id;
+        header.request_id = request_frame->request_id;
+        header.payload_length = static_cast<uint32_t>(size);
+        uint8_t header_bytes[FrameCodec::kMaxHeaderSize];
+        size_t header_size = FrameCodec::encode_header(header, header_bytes);
+        send_all_helper(sock, reinterpret_cast<const char*>(header_bytes), header_size);
+    }
+
+    if (size > 0) {
+        send_all_helper(sock, reinterpret_cast<const char*>(data), size);
+    }
+
+    if (transport_options_.tcp_cork) {
+        SocketTuner::set_cork(client_socket, false);
+    }
+}
+
+// Closes a connection that stays between calls for longer than the idle timeout.
+// Calls only update two atomics; the timer wakes once per timeout period, re-arms
+// itself for the remaining time and shuts the socket down once the connection has
+// really been idle, which ends the blocking recv in the serve loop.
+class TcpRpcServer::IdleTimer {
+public:
+    IdleTimer(SOCKET sock, std::chrono::milliseconds timeout) : sock_(sock), timeout_(timeout) {
+        if (timeout_.count() <= 0) {
+            return;
+        }
+        end_call();
+        std::lock_guard<std::mutex> lock(mutex_);
+        handle_ = TimerService::coarse().schedule(timeout_, [this]() { check(); });
+    }
+
+    ~IdleTimer() { disarm(); }
+
+    // Call before closing the socket: waits out a running check(), so it cannot shut
+    // down a reused socket number
+    void disarm() {
+        if (handle_.valid()) {
+            TimerService::coarse().cancel_and_wait(handle_);
+            handle_ = TimerHandle();
+        }
+    }
+
+    void begin_call() { busy_.store(true, std::memory_order_relaxed); }
+    void end_call() {
+        last_activity_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        busy_.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    void check() {
+        std::lock_guard<std::mutex> lock(mutex_);  // handle_ is assigned
+        auto idle_for = std::chrono::steady_clock::now().time_since_epoch() -
+                        std::chrono::steady_clock::duration(last_activity_.load(std::memory_order_relaxed));
+        if (busy_.load(std::memory_order_relaxed)) {
+            TimerService::coarse().restart(handle_, timeout_);
+        } else if (idle_for < timeout_) {
+            TimerService::coarse().restart(handle_, timeout_ - idle_for);
+        } else {
+#ifdef _WIN32
+            shutdown(sock_, SD_BOTH);
+#else
+            shutdown(sock_, SHUT_RDWR);
+#endif
+        }
+    }
+
+    SOCKET sock_;
+    std::chrono::milliseconds timeout_;
+    std::atomic<bool> busy_{false};
+    std::atomic<std::chrono::steady_clock::rep> last_activity_{0};
+    std::mutex mutex_;
+    TimerHandle handle_;
+};
+
 void TcpRpcServer::handle_client(void* client_socket) {
     SOCKET sock = reinterpret_cast<SOCKET>(client_socket);
+    IdleTimer idle(sock, idle_timeout_);
 
     try {
-        while (is_running_) {
-            // Payload: either [payload_len][method_len][method][request]
-            // or [payload_len][method (ASCII)][request]
-            uint32_t payload_length = 0;
-            if (!recv_all_helper(sock, reinterpret_cast<char*>(&payload_length), sizeof(payload_length))) break;
-            if (payload_length == 0) continue;
-
-            std::vector<uint8_t> payload(payload_length);
-            if (!recv_all_helper(sock, reinterpret_cast<char*>(payload.data()), payload.size())) break;
-
-            std::string method_name;
-            std::vector<uint8_t> request_bytes;
-
-            // Try format A: explicit method length prefix inside payload
-            if (payload.size() >= 4) {
-                uint32_t mlen = *reinterpret_cast<const uint32_t*>(payload.data());
-                if (mlen > 0 && 4 + mlen <= payload.size() && is_printable_ascii(payload.data() + 4, mlen)) {
-                    method_name.assign(reinterpret_cast<const char*>(payload.data() + 4), mlen);
-                    request_bytes.assign(payload.begin() + 4 + mlen, payload.end());
-                }
+        // The first four bytes are either the binary protocol handshake or the
+        // length prefix of the first legacy frame
+        uint8_t prefix[4];
+        if (recv_all_helper(sock, reinterpret_cast<char*>(prefix), sizeof(prefix))) {
+            if (FrameCodec::is_handshake(prefix)) {
+                serve_binary(client_socket, prefix, idle);
+            } else {
+                uint32_t first_length = 0;
+                std::memcpy(&first_length, prefix, sizeof(first_length));
+                serve_legacy(client_socket, &first_length, idle);
             }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error in client handler: " << e.what() << std::endl;
+    }
+
+    idle.disarm();
+    closesocket(sock);
+}
+
+void TcpRpcServer::serve_legacy(void* client_socket, const uint32_t* first_length, IdleTimer& idle) {
+    SOCKET sock = reinterpret_cast<SOCKET>(client_socket);
 
-            // Fallback format B: ASCII prefix until first non-printable
-            if (method_name.empty()) {
-                size_t i = 0;
-                while (i < payload.size()) {
-                    unsigned char c = payload[i];
-                    if (c < 32 || c > 126) break;
-                    ++i;
-                }
-                method_name.assign(reinterpret_cast<const char*>(payload.data()), i);
-                request_bytes.assign(payload.begin() + i, payload.end());
+    while (is_running_) {
+        // Payload: either [payload_len][method_len][method][request]
+        // or [payload_len][method (ASCII)][request]
+        uint32_t payload_length = 0;
+        if (first_length) {
+            payload_length = *first_length;
+            first_length = nullptr;
+        } else if (!recv_all_helper(sock, reinterpret_cast<char*>(&payload_length), sizeof(payload_length))) {
+            break;
+        }
+        if (payload_length == 0) continue;
+
+        // Everything for this call (payload, request object, response) lives in the
+        // arena and is released together at the end of the iteration
+        RpcArena arena(arena_options_);
+        auto* payload = static_cast<uint8_t*>(arena.allocate(payload_length, 1));
+        if (!recv_all_helper(sock, reinterpret_cast<char*>(payload), payload_length)) break;
+        if (transport_options_.tcp_quickack) {
+            SocketTuner::rearm_quickack(client_socket);
+        }
+
+        std::string method_name;
+        RpcCallContext context;
+        context.arena = &arena;
+
+        // Try format A: explicit method length prefix inside payload
+        if (payload_length >= 4) {
+            uint32_t mlen = 0;
+            std::memcpy(&mlen, payload, sizeof(mlen));
+            if (mlen > 0 && 4 + static_cast<size_t>(mlen) <= payload_length && is_printable_ascii(payload + 4, mlen)) {
+                method_name.assign(reinterpret_cast<const char*>(payload + 4), mlen);
+                context.request_data = payload + 4 + mlen;
+                context.request_size = payload_length - 4 - mlen;
             }
+        }
 
-            auto method_pair = parse_method_name(method_name);
-            auto& service_name = method_pair.first;
-            auto& method = method_pair.second;
-            auto service = service_manager_->get_service(service_name);
-
-            if (!service) {
-                std::cerr << "Service not found: " << service_name << std::endl;
-                // Respond with empty
-                uint32_t response_length = 0;
-                send(sock, reinterpret_cast<const char*>(&response_length), sizeof(response_length), 0);
-                continue;
+        // Fallback format B: ASCII prefix until first non-printable
+        if (method_name.empty()) {
+            size_t i = 0;
+            while (i < payload_length) {
+                unsigned char c = payload[i];
+                if (c < 32 || c > 126) break;
+                ++i;
             }
+            method_name.assign(reinterpret_cast<const char*>(payload), i);
+            context.request_data = payload + i;
+            context.request_size = payload_length - i;
+        }
 
-            try {
-                if (service->has_stream_method(method)) {
-                    // Handle streaming using the service-provided StreamResponseReader
-                    auto reader = service->call_stream_method(method, request_bytes);
-                    if (!reader) {
-                        uint32_t zero = 0; // end-of-stream
-                        send(sock, reinterpret_cast<const char*>(&zero), sizeof(zero), 0);
-                        continue;
-                    }
-
-                    while (reader->has_more()) {
-                        auto frame = reader->read_next();
-                        uint32_t flen = static_cast<uint32_t>(frame.size());
-                        // write frame
-                        send(sock, reinterpret_cast<const char*>(&flen), sizeof(flen), 0);
-                        if (flen) {
-                            size_t off = 0; while (off < frame.size()) {
-                                int s = send(sock, reinterpret_cast<const char*>(frame.data() + off),
-                                              static_cast<int>(frame.size() - off), 0);
-                                if (s <= 0) { break; }
-                                off += s;
-                            }
-                        }
-                        if (flen == 0) break; // end marker by reader
-                    }
-                    // Explicit end marker (0) to align with client
-                    uint32_t zero = 0; send(sock, reinterpret_cast<const char*>(&zero), sizeof(zero), 0);
-                    continue;
-                }
-
-                if (service->has_method(method)) {
-                    // Synchronous method wrapper (already serializes response with type hash)
-                    void* response = service->call_method(method, static_cast<void*>(&request_bytes));
-
-                    if (response) {
-                        auto response_vector = static_cast<std::vector<uint8_t>*>(response);
-                        uint32_t response_length = static_cast<uint32_t>(response_vector->size());
-                        send(sock, reinterpret_cast<const char*>(&response_length), sizeof(response_length), 0);
-                        if (response_length > 0) {
-                            send(sock, reinterpret_cast<const char*>(response_vector->data()), response_length, 0);
-                        }
-                        delete response_vector;
-                    } else {
-                        uint32_t response_length = 0;
-                        send(sock, reinterpret_cast<const char*>(&response_length), sizeof(response_length), 0);
-                    }
-                    continue;
-                }
-
-                if (service->has_async_method(method)) {
-                    // Async method
-                    void* dummy = static_cast<void*>(&request_bytes);
-                    auto future_response = service->call_method_async(method, dummy);
-                    auto response_ptr = future_response.get();
-                    if (response_ptr) {
-                        auto response_vector = static_cast<std::vector<uint8_t>*>(response_ptr);
-                        uint32_t response_length = static_cast<uint32_t>(response_vector->size());
-                        send(sock, reinterpret_cast<const char*>(&response_length), sizeof(response_length), 0);
-                        if (response_length > 0) {
-                            send(sock, reinterpret_cast<const char*>(response_vector->data()), response_length, 0);
-                        }
-                        delete response_vector;
-                    } else {
-                        uint32_t response_length = 0;
-                        send(sock, reinterpret_cast<const char*>(&response_length), sizeof(response_length), 0);
-                    }
-                    continue;
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Error handling RPC call: " << e.what() << std::endl;
-                uint32_t response_length = 0;
-                send(sock, reinterpret_cast<const char*>(&response_length), sizeof(response_length), 0);
+        auto method_pair = parse_method_name(method_name);
+        idle.begin_call();
+        dispatch_call(client_socket, method_pair.first, method_pair.second, context, nullptr);
+        idle.end_call();
+    }
+}
+
+void TcpRpcServer::serve_binary(void* client_socket, const uint8_t* handshake_prefix, IdleTimer& idle) {
+    SOCKET sock = reinterpret_cast<SOCKET>(client_socket);
+
+    uint8_t handshake[FrameCodec::kHandshakeSize];
+    std::memcpy(handshake, handshake_prefix, 4);
+    if (!recv_all_helper(sock, reinterpret_cast<char*>(handshake + 4), sizeof(handshake) - 4)) return;
+
+    FrameHandshake answer = FrameCodec::negotiate(FrameCodec::decode_handshake(handshake));
+    FrameCodec::encode_handshake(answer, handshake);
+    if (!send_all_helper(sock, reinterpret_cast<const char*>(handshake), sizeof(handshake))) return;
+
+    if (!(answer.capabilities & FRAME_CAP_BINARY_FRAMES)) {
+        serve_legacy(client_socket, nullptr, idle);
+        return;
+    }
+
+    uint8_t header_bytes[FrameCodec::kMaxHeaderSize];
+    while (is_running_) {
+        // Fixed part plus the first varint byte, then one byte at a time for longer lengths
+        size_t received = FrameCodec::kFixedHeaderSize + 1;
+        if (!recv_all_helper(sock, reinterpret_cast<char*>(header_bytes), received)) break;
+
+        FrameHeader header = FrameCodec::decode_fixed_header(header_bytes);
+        while (FrameCodec::decode_varint(header_bytes + FrameCodec::kFixedHeaderSize,
+                                         received - FrameCodec::kFixedHeaderSize, header.payload_length) == 0) {
+            if (!recv_all_helper(sock, reinterpret_cast<char*>(header_bytes + received), 1)) return;
+            ++received;
+        }
+
+        RpcArena arena(arena_options_);
+        auto* payload = static_cast<uint8_t*>(arena.allocate(header.payload_length ? header.payload_length : 1, 1));
+        if (header.payload_length > 0 &&
+            !recv_all_helper(sock, reinterpret_cast<char*>(payload), header.payload_length)) {
+            break;
+        }
+        if (transport_options_.tcp_quickack) {
+            SocketTuner::rearm_quickack(client_socket);
+        }
+
+        RpcCallContext context;
+        context.arena = &arena;
+        context.request_data = payload;
+        context.request_size = header.payload_length;
+        if (header.deadline_ms > 0 && (answer.capabilities & FRAME_CAP_DEADLINES)) {
+            context.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(header.deadline_ms);
+        }
+
+        std::string service_name;
+        std::string method;
+        if (!service_manager_->resolve_method_id(header.method_id, service_name, method)) {
+            std::string message = "Unknown method id: " + std::to_string(header.method_id);
+            send_reply(client_socket, &header, FRAME_FLAG_ERROR,
+                       reinterpret_cast<const uint8_t*>(message.data()), message.size());
+            continue;
+        }
+
+        idle.begin_call();
+        dispatch_call(client_socket, service_name, method, context, &header);
+        idle.end_call();
+    }
+}
+
+void TcpRpcServer::dispatch_call(void* client_socket, const std::string& service_name, const std::string& method,
+                                 RpcCallContext& context, const FrameHeader* request_frame) {
+    auto send_error = [&](uint8_t flags, const std::string& message) {
+        send_reply(client_socket, request_frame, flags,
+                   reinterpret_cast<const uint8_t*>(message.data()), message.size());
+    };
+
+    auto service = service_manager_->get_service(service_name);
+    if (!service) {
+        std::cerr << "Service not found: " << service_name << std::endl;
+        send_error(FRAME_FLAG_ERROR, "Service not found: " + service_name);
+        return;
+    }
+
+    // Skip work the caller has already given up on
+    if (context.deadline != std::chrono::steady_clock::time_point() &&
+        std::chrono::steady_clock::now() >= context.deadline) {
+        send_error(FRAME_FLAG_DEADLINE_EXCEEDED, "Deadline exceeded: " + service_name + "." + method);
+        return;
+    }
+
+    try {
+        if (service->has_stream_method(method)) {
+            // Handle streaming using the service-provided StreamResponseReader
+            auto reader = service->call_stream_method(method, context);
+            while (reader && reader->has_more()) {
+                auto frame = reader->read_next();
+                if (frame.empty()) break; // end marker by reader
+                send_reply(client_socket, request_frame, FRAME_FLAG_STREAM_ITEM, frame.data(), frame.size());
             }
+            // Explicit end marker (a zero-length frame for legacy clients)
+            send_reply(client_socket, request_frame, FRAME_FLAG_END_OF_STREAM, nullptr, 0);
+            return;
+        }
+
+        RpcResponseBuffer* response = nullptr;
+        if (service->has_method(method)) {
+            // Synchronous method wrapper (already serializes response with type hash)
+            response = service->call_method(method, context);
+        } else if (service->has_async_method(method)) {
+            response = service->call_method_async(method, context).get();
+        } else {
+            send_error(FRAME_FLAG_ERROR, "Method not found: " + service_name + "." + method);
+            return;
         }
+
+        auto bytes = response_bytes(context, response);
+        send_reply(client_socket, request_frame, 0, bytes.data, bytes.size);
     } catch (const std::exception& e) {
-        std::cerr << "Error in client handler: " << e.what() << std::endl;
+        std::cerr << "Error handling RPC call: " << e.what() << std::endl;
+        send_error(FRAME_FLAG_ERROR, e.what());
     }
-
-    closesocket(sock);
 }
 
 std::pair<std::string, std::string> TcpRpcServer::parse_method_name(const std::string& method) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <any>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -9,7 +10,14 @@
 #include <atomic>
 #include <functional>
 #include <future>
+#include <chrono>
 #include "serialization.h"
+#include "arena.h"
+#include "frame.h"
+#include "response_cache.h"
+#include "batching.h"
+#include "transport_options.h"
+#include "client.h"
 
 namespace bitrpc {
 
@@ -40,6 +48,44 @@ using RpcServer = IRpcServer;
 template<typename TRequest, typename TResponse>
 using ServiceMethod = std::function<TResponse*(const TRequest*)>;
 
+// Batch handler: one response per request, in the same order
+template<typename TRequest, typename TResponse>
+using BatchServiceMethod = std::function<std::vector<TResponse>(const std::vector<const TRequest*>& requests)>;
+
+// Serialized response, owned by the call arena
+using RpcResponseBuffer = std::pmr::vector<uint8_t>;
+
+// Raw request handed to registered method wrappers. The request bytes are not
+// copied out of the transport buffer; request objects and response buffers are
+// allocated from the arena, which must outlive the call.
+struct RpcCallContext {
+    const uint8_t* request_data = nullptr;
+    size_t request_size = 0;
+    RpcArena* arena = nullptr;
+    // Set from the binary frame header; a default-constructed time point means no deadline
+    std::chrono::steady_clock::time_point deadline{};
+    // Set on a result-cache hit instead of returning an arena buffer, so the shared cached
+    // bytes are written out without a copy. Read the result through response_bytes()
+    ShardedLruCache::Value cached_response;
+};
+
+// Serialized result of a finished call: the cached bytes on a cache hit, otherwise the
+// returned arena buffer (empty when it is nullptr)
+struct RpcResponseBytes {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+inline RpcResponseBytes response_bytes(const RpcCallContext& context, const RpcResponseBuffer* response) {
+    if (context.cached_response) {
+        return {context.cached_response->data(), context.cached_response->size()};
+    }
+    if (response) {
+        return {response->data(), response->size()};
+    }
+    return {};
+}
+
 // Base service class with method registration
 class BaseService {
 public:
@@ -47,23 +93,49 @@ public:
     virtual ~BaseService() = default;
 
     std::string service_name() const { return name_; }
+    // Names of all registered methods (unary, async and stream)
+    std::vector<std::string> method_names() const;
     virtual bool has_method(const std::string& method_name) const;
     virtual bool has_async_method(const std::string& method_name) const;
-    virtual void* call_method(const std::string& method_name, void* request);
-    virtual std::future<void*> call_method_async(const std::string& method_name, void* request);
+    virtual RpcResponseBuffer* call_method(const std::string& method_name, RpcCallContext& context);
+    virtual std::future<RpcResponseBuffer*> call_method_async(const std::string& method_name, RpcCallContext& context);
 
     // Streaming support
     virtual bool has_stream_method(const std::string& method_name) const;
     virtual std::shared_ptr<StreamResponseReader> call_stream_method(const std::string& method_name,
-                                                                     const std::vector<uint8_t>& request_bytes);
+                                                                     RpcCallContext& context);
+
+    // Typed handler (std::function<TResponse(const TRequest&)>) for in-process object-mode
+    // calls; nullptr for stream methods and cached methods, which need the byte path
+    const std::any* object_method(const std::string& method_name) const;
+
+    // Result cache invalidation for methods registered with a CachePolicy
+    void invalidate_cache(const std::string& method_name);
+    void invalidate_cache(const std::string& method_name, const std::vector<uint8_t>& request_bytes);
+    template<typename TRequest>
+    void invalidate_cache_for(const std::string& method_name, const TRequest& request);
+    void invalidate_all_caches();
+    std::shared_ptr<ShardedLruCache> method_cache(const std::string& method_name) const;
+
+    // Grouping counters for methods registered with register_batch_method
+    BatchStatistics batch_statistics(const std::string& method_name) const;
 
 protected:
     template<typename TRequest, typename TResponse>
-    void register_method(const std::string& method_name, ServiceMethod<TRequest, TResponse> method);
+    void register_method(const std::string& method_name, ServiceMethod<TRequest, TResponse> method,
+                         const CachePolicy& cache_policy = CachePolicy());
 
     template<typename TRequest, typename TResponse>
     void register_async_method(const std::string& method_name,
-                               std::function<std::future<TResponse>(const TRequest&)> method);
+                               std::function<std::future<TResponse>(const TRequest&)> method,
+                               const CachePolicy& cache_policy = CachePolicy());
+
+    // Concurrent calls of this method (from any connection) are grouped and handed to the
+    // handler together; callers still use the plain unary method. Takes precedence over an
+    // async registration of the same name.
+    template<typename TRequest, typename TResponse>
+    void register_batch_method(const std::string& method_name, BatchServiceMethod<TRequest, TResponse> method,
+                               const BatchPolicy& batch_policy = BatchPolicy());
 
     template<typename TRequest>
     void register_stream_method(const std::string& method_name,
@@ -71,10 +143,25 @@ protected:
 
 protected:
     std::string name_;
-    std::unordered_map<std::string, std::function<void*(void*)>> methods_;
-    std::unordered_map<std::string, std::function<std::future<void*>(void*)>> async_methods_;
-    std::unordered_map<std::string, std::function<std::shared_ptr<StreamResponseReader>(void*)>> stream_methods_;
+    std::unordered_map<std::string, std::function<RpcResponseBuffer*(RpcCallContext&)>> methods_;
+    std::unordered_map<std::string, std::function<std::future<RpcResponseBuffer*>(RpcCallContext&)>> async_methods_;
+    std::unordered_map<std::string, std::function<std::shared_ptr<StreamResponseReader>(RpcCallContext&)>> stream_methods_;
+    std::unordered_map<std::string, std::shared_ptr<ShardedLruCache>> method_caches_;
+    std::unordered_map<std::string, std::shared_ptr<MethodBatcherBase>> method_batchers_;
+    std::unordered_map<std::string, std::any> object_methods_;
     mutable std::mutex methods_mutex_;
+
+public:
+    // Bumped by every method registration, in any service; lets ServiceManager tell whether
+    // its method-id index can be missing anything
+    static uint64_t registration_generation() { return registration_generation_.load(std::memory_order_acquire); }
+
+private:
+    static std::atomic<uint64_t> registration_generation_;
+
+    // Caller holds methods_mutex_; returns nullptr when caching is disabled
+    std::shared_ptr<ShardedLruCache> create_method_cache_locked(const std::string& method_name,
+                                                                const CachePolicy& cache_policy);
 };
 
 // Service Manager for managing multiple services
@@ -89,8 +176,16 @@ public:
     bool has_service(const std::string& service_name) const;
     std::vector<std::string> get_service_names() const;
 
+    // Maps a binary-frame method id (FrameCodec::method_id of "Service.Method") back to names
+    bool resolve_method_id(uint32_t method_id, std::string& service_name, std::string& method_name) const;
+
 private:
+    // Adds methods registered since the last indexing; caller holds services_mutex_
+    void index_new_methods_locked() const;
+
     std::unordered_map<std::string, std::shared_ptr<BaseService>> services_;
+    mutable std::unordered_map<uint32_t, std::pair<std::string, std::string>> method_ids_;
+    mutable uint64_t indexed_generation_ = 0;  // BaseService::registration_generation() when last indexed
     mutable std::mutex services_mutex_;
 };
 
@@ -98,6 +193,7 @@ private:
 class TcpRpcServer : public IRpcServer {
 public:
     TcpRpcServer();
+    explicit TcpRpcServer(const TransportOptions& transport_options);
     ~TcpRpcServer() override;
 
     void start(int port) override;
@@ -106,16 +202,46 @@ public:
     bool is_running() const override;
     ServiceManager& service_manager() override;
 
+    // Arena sizing for per-call allocations; applies to connections accepted afterwards
+    void set_arena_options(const RpcArena::Options& options) { arena_options_ = options; }
+    // Connections with no call in progress for this long are closed (checked on the coarse
+    // timer service, so with ~100 ms slack); zero keeps them open. Applies to connections
+    // accepted afterwards.
+    void set_idle_timeout(std::chrono::milliseconds timeout) { idle_timeout_ = timeout; }
+
+    const TransportOptions& transport_options() const { return transport_options_; }
+    // Options as reported by the listening socket (valid after start)
+    EffectiveSocketOptions effective_socket_options() const;
+    // Options as reported by the most recently accepted connection
+    EffectiveSocketOptions last_connection_socket_options() const;
+
 private:
     std::shared_ptr<ServiceManager> service_manager_;
+    RpcArena::Options arena_options_;
+    std::chrono::milliseconds idle_timeout_{0};
+    TransportOptions transport_options_;
+    EffectiveSocketOptions effective_listener_options_;
+    EffectiveSocketOptions last_connection_options_;
+    mutable std::mutex connection_options_mutex_;
     void* server_socket_;
     std::atomic<bool> is_running_;
     std::vector<std::thread> client_threads_;
     std::thread accept_thread_;
     std::mutex server_mutex_;
 
+    // Idle tracking of one connection, see set_idle_timeout
+    class IdleTimer;
+
     void accept_connections();
     void handle_client(void* client_socket);
+    // first_length: length prefix already consumed while probing for the handshake
+    void serve_legacy(void* client_socket, const uint32_t* first_length, IdleTimer& idle);
+    void serve_binary(void* client_socket, const uint8_t* handshake_prefix, IdleTimer& idle);
+    // request_frame is null for legacy connections
+    void dispatch_call(void* client_socket, const std::string& service_name, const std::string& method,
+                       RpcCallContext& context, const FrameHeader* request_frame);
+    void send_reply(void* client_socket, const FrameHeader* request_frame, uint8_t flags,
+                    const uint8_t* data, size_t size);
     std::pair<std::string, std::string> parse_method_name(const std::string& method);
     void initialize_network();
     void cleanup_network();
@@ -123,51 +249,155 @@ private:
 
 
 // Template implementations
+namespace detail {
+
+// Deserialize a request straight into an arena-owned object
+template<typename TRequest>
+TRequest* read_request(RpcCallContext& context) {
+    auto* handler = BufferSerializer::instance().get_handler(typeid(TRequest).hash_code());
+    if (!handler) {
+        throw std::runtime_error("No serializer for request type");
+    }
+    StreamReader reader(context.request_data, context.request_size);
+    TRequest* request = context.arena->create<TRequest>();
+    if (!handler->read_into(reader, request)) {
+        std::unique_ptr<TRequest> boxed(static_cast<TRequest*>(handler->read(reader)));
+        *request = std::move(*boxed);
+    }
+    return request;
+}
+
+// Serialize a response (with type hash) into an arena-owned buffer
+template<typename TResponse>
+RpcResponseBuffer* write_response(const TResponse* response, RpcArena& arena) {
+    StreamWriter writer(&arena);
+    writer.write_object(response, typeid(TResponse).hash_code());
+    return arena.create<RpcResponseBuffer>(writer.release_buffer());
+}
+
+// Cache lookups key on the raw request bytes, before any deserialization
+inline std::string_view request_key(const RpcCallContext& context) {
+    return std::string_view(reinterpret_cast<const char*>(context.request_data), context.request_size);
+}
+
+// On a hit the shared buffer is kept in the context; the caller then returns nullptr
+inline bool lookup_cached_response(ShardedLruCache& cache, RpcCallContext& context) {
+    context.cached_response = cache.get(request_key(context));
+    return context.cached_response != nullptr;
+}
+
+// `generation` is the cache generation taken before the handler ran; an invalidation
+// during the call makes the result stale, and it is then not stored
+inline void store_cached_response(ShardedLruCache& cache, const RpcCallContext& context,
+                                  const RpcResponseBuffer& response, std::chrono::milliseconds ttl,
+                                  uint64_t generation) {
+    if (cache.generation() != generation) {
+        return;
+    }
+    cache.put_if_generation(request_key(context),
+                            std::make_shared<const std::vector<uint8_t>>(response.begin(), response.end()),
+                            ttl, generation);
+}
+
+} // namespace detail
+
 // Requests arrive as raw bytes (without type hash). We deserialize here and serialize responses
 // with type hash using StreamWriter::write_object for client compatibility.
 template<typename TRequest, typename TResponse>
-void BaseService::register_method(const std::string& method_name, ServiceMethod<TRequest, TResponse> method) {
+void BaseService::register_method(const std::string& method_name, ServiceMethod<TRequest, TResponse> method,
+                                  const CachePolicy& cache_policy) {
     std::lock_guard<std::mutex> lock(methods_mutex_);
-    methods_[method_name] = [method](void* request) -> void* {
-        // request is std::vector<uint8_t>*
-        auto req_bytes = static_cast<const std::vector<uint8_t>*>(request);
-        StreamReader reader(*req_bytes);
-        auto* handler = BufferSerializer::instance().get_handler(typeid(TRequest).hash_code());
-        if (!handler) {
-            throw std::runtime_error("No serializer for request type");
+    auto cache = create_method_cache_locked(method_name, cache_policy);
+    auto ttl = cache_policy.ttl;
+    methods_[method_name] = [method, cache, ttl](RpcCallContext& context) -> RpcResponseBuffer* {
+        uint64_t generation = cache ? cache->generation() : 0;
+        if (cache && detail::lookup_cached_response(*cache, context)) {
+            return nullptr;
         }
-        std::unique_ptr<TRequest> req(static_cast<TRequest*>(handler->read(reader)));
+        TRequest* req = detail::read_request<TRequest>(context);
         // Invoke user method
-        std::unique_ptr<TResponse> resp_ptr(method(req.get()));
-        // Serialize with type hash
-        StreamWriter writer;
-        writer.write_object(resp_ptr.get(), typeid(TResponse).hash_code());
-        return new std::vector<uint8_t>(writer.to_array());
+        std::unique_ptr<TResponse> resp_ptr(method(req));
+        auto* response = detail::write_response(resp_ptr.get(), *context.arena);
+        if (cache) {
+            detail::store_cached_response(*cache, context, *response, ttl, generation);
+        }
+        return response;
     };
+
+    if (cache) {
+        object_methods_.erase(method_name);
+    } else {
+        object_methods_[method_name] = std::function<TResponse(const TRequest&)>([method, method_name](const TRequest& request) {
+            std::unique_ptr<TResponse> response(method(&request));
+            // A typed result has no null value to hand back
+            if (!response) {
+                throw RpcException("Method '" + method_name + "' returned a null response");
+            }
+            return std::move(*response);
+        });
+    }
+    registration_generation_.fetch_add(1, std::memory_order_release);
 }
 
 template<typename TRequest, typename TResponse>
 void BaseService::register_async_method(const std::string& method_name,
-                                        std::function<std::future<TResponse>(const TRequest&)> method) {
+                                        std::function<std::future<TResponse>(const TRequest&)> method,
+                                        const CachePolicy& cache_policy) {
     std::lock_guard<std::mutex> lock(methods_mutex_);
+    auto cache = create_method_cache_locked(method_name, cache_policy);
+    auto ttl = cache_policy.ttl;
 
-    async_methods_[method_name] = [method](void* request) -> std::future<void*> {
-        auto req_bytes = static_cast<const std::vector<uint8_t>*>(request);
-        StreamReader reader(*req_bytes);
-        auto* handler = BufferSerializer::instance().get_handler(typeid(TRequest).hash_code());
-        if (!handler) {
-            throw std::runtime_error("No serializer for request type");
+    async_methods_[method_name] = [method, cache, ttl](RpcCallContext& context) -> std::future<RpcResponseBuffer*> {
+        uint64_t generation = cache ? cache->generation() : 0;
+        if (cache && detail::lookup_cached_response(*cache, context)) {
+            return std::async(std::launch::deferred, []() -> RpcResponseBuffer* { return nullptr; });
         }
-        std::unique_ptr<TRequest> req(static_cast<TRequest*>(handler->read(reader)));
-
+        TRequest* req = detail::read_request<TRequest>(context);
         auto future_result = method(*req);
-        return std::async(std::launch::async, [future_result = std::move(future_result)]() mutable -> void* {
+        RpcCallContext call = context;
+        // Deferred: serialization runs on the thread that collects the result, which
+        // keeps the (single-threaded) arena on the connection thread
+        return std::async(std::launch::deferred, [future_result = std::move(future_result), call, cache, ttl, generation]() mutable -> RpcResponseBuffer* {
             auto result = future_result.get(); // by value
-            StreamWriter writer;
-            writer.write_object(&result, typeid(TResponse).hash_code());
-            return new std::vector<uint8_t>(writer.to_array());
+            auto* response = detail::write_response(&result, *call.arena);
+            if (cache) {
+                detail::store_cached_response(*cache, call, *response, ttl, generation);
+            }
+            return response;
         });
     };
+
+    // A batch registration of the same name takes precedence on the object path as well
+    if (method_batchers_.find(method_name) == method_batchers_.end()) {
+        if (cache) {
+            object_methods_.erase(method_name);
+        } else {
+            object_methods_[method_name] = std::function<TResponse(const TRequest&)>([method](const TRequest& request) {
+                return method(request).get();
+            });
+        }
+    }
+    registration_generation_.fetch_add(1, std::memory_order_release);
+}
+
+template<typename TRequest, typename TResponse>
+void BaseService::register_batch_method(const std::string& method_name, BatchServiceMethod<TRequest, TResponse> method,
+                                        const BatchPolicy& batch_policy) {
+    std::lock_guard<std::mutex> lock(methods_mutex_);
+    auto batcher = std::make_shared<MethodBatcher<TRequest, TResponse>>(std::move(method), batch_policy);
+    method_batchers_[method_name] = batcher;
+
+    // The request lives in this caller's arena and the caller blocks until the batch has
+    // run, so the leader can read it; the response is serialized back on this thread
+    methods_[method_name] = [batcher](RpcCallContext& context) -> RpcResponseBuffer* {
+        TRequest* req = detail::read_request<TRequest>(context);
+        TResponse response = batcher->submit(*req);
+        return detail::write_response(&response, *context.arena);
+    };
+    object_methods_[method_name] = std::function<TResponse(const TRequest&)>([batcher](const TRequest& request) {
+        return batcher->submit(request);
+    });
+    registration_generation_.fetch_add(1, std::memory_order_release);
 }
 
 template<typename TRequest>
@@ -175,16 +405,22 @@ void BaseService::register_stream_method(const std::string& method_name,
                                         std::function<std::shared_ptr<StreamResponseReader>(const TRequest&)> method) {
     std::lock_guard<std::mutex> lock(methods_mutex_);
 
-    stream_methods_[method_name] = [method](void* request) -> std::shared_ptr<StreamResponseReader> {
-        auto req_bytes = static_cast<const std::vector<uint8_t>*>(request);
-        StreamReader reader(*req_bytes);
-        auto* handler = BufferSerializer::instance().get_handler(typeid(TRequest).hash_code());
-        if (!handler) {
-            throw std::runtime_error("No serializer for request type");
-        }
-        std::unique_ptr<TRequest> req(static_cast<TRequest*>(handler->read(reader)));
+    stream_methods_[method_name] = [method](RpcCallContext& context) -> std::shared_ptr<StreamResponseReader> {
+        TRequest* req = detail::read_request<TRequest>(context);
         return method(*req);
     };
+    registration_generation_.fetch_add(1, std::memory_order_release);
+}
+
+template<typename TRequest>
+void BaseService::invalidate_cache_for(const std::string& method_name, const TRequest& request) {
+    // Same encoding the clients use for request payloads
+    StreamWriter writer;
+    BufferSerializer::instance().serialize(&request, writer);
+    auto cache = method_cache(method_name);
+    if (cache) {
+        cache->erase(std::string_view(reinterpret_cast<const char*>(writer.data()), writer.size()));
+    }
 }
 
-} // namespace bitrpc
\ No newline at end of file
+} // namespace bitrpc
@@ -0,0 +1,357 @@
+#include "timer_wheel.h"
+#include <algorithm>
+#include <iostream>
+
+namespace bitrpc {
+
+TimerWheel::TimerWheel() : TimerWheel(Options()) {}
+
+TimerWheel::TimerWheel(const Options& options)
+    : tick_(std::max<Clock::duration>(options.tick, std::chrono::microseconds(1))), origin_(Clock::now()) {
+    nodes_.reserve(options.initial_capacity);
+    for (auto& level : slots_) {
+        level.fill(kNil);
+    }
+}
+
+uint64_t TimerWheel::to_tick(Clock::time_point when) const {
+    if (when <= origin_) {
+        return 0;
+    }
+    // Round up so that a timer never fires before its time
+    auto elapsed = when - origin_;
+    return static_cast<uint64_t>((elapsed + tick_ - Clock::duration(1)) / tick_);
+}
+
+TimerWheel::Node* TimerWheel::lookup(TimerHandle handle) {
+    if (handle.index >= nodes_.size()) {
+        return nullptr;
+    }
+    Node& node = nodes_[handle.index];
+    return (node.generation == handle.generation && node.state != State::FREE) ? &node : nullptr;
+}
+
+uint32_t TimerWheel::allocate() {
+    if (free_list_ != kNil) {
+        uint32_t index = free_list_;
+        free_list_ = nodes_[index].next;
+        return index;
+    }
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.state = State::FREE;
+    node.cancelled = false;
+    node.restarted = false;
+    // Invalidates outstanding handles; 0 is reserved for "no timer"
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    node.prev = kNil;
+    node.next = free_list_;
+    free_list_ = index;
+}
+
+void TimerWheel::insert(uint32_t index) {
+    Node& node = nodes_[index];
+    uint64_t delta = node.expiry - current_tick_;
+
+    int level = 0;
+    uint64_t placed = node.expiry;
+    if (delta >= (uint64_t(1) << (kLevels * kSlotBits))) {
+        // Beyond the wheel's range: park at the far end of the top level, cascading
+        // re-places it with its real expiry
+        level = kLevels - 1;
+        placed = current_tick_ + (uint64_t(1) << (kLevels * kSlotBits)) - 1;
+    } else {
+        while (level < kLevels - 1 && delta >= (uint64_t(1) << ((level + 1) * kSlotBits))) {
+            ++level;
+        }
+    }
+
+    uint32_t slot = static_cast<uint32_t>(placed >> (level * kSlotBits)) & kSlotMask;
+    uint32_t& head = slots_[level][slot];
+    node.bucket = static_cast<uint16_t>(level * kSlots + slot);
+    node.prev = kNil;
+    node.next = head;
+    if (head != kNil) {
+        nodes_[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[node.bucket / kSlots][node.bucket % kSlots] = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNil;
+    node.next = kNil;
+}
+
+void TimerWheel::cascade(int level, uint32_t slot) {
+    uint32_t index = slots_[level][slot];
+    slots_[level][slot] = kNil;
+    while (index != kNil) {
+        uint32_t next = nodes_[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+void TimerWheel::step(std::vector<uint32_t>& fired) {
+    uint64_t now = ++current_tick_;
+
+    // Higher levels first: a timer coming down from level 2 may land in the level 1
+    // slot that is cascaded on the same tick
+    for (int level = kLevels - 1; level > 0; --level) {
+        uint64_t span_mask = (uint64_t(1) << (level * kSlotBits)) - 1;
+        if ((now & span_mask) == 0) {
+            cascade(level, static_cast<uint32_t>(now >> (level * kSlotBits)) & kSlotMask);
+        }
+    }
+
+    uint32_t& head = slots_[0][now & kSlotMask];
+    uint32_t index = head;
+    head = kNil;
+    while (index != kNil) {
+        Node& node = nodes_[index];
+        uint32_t next = node.next;
+        node.prev = kNil;
+        node.next = kNil;
+        node.state = State::DUE;
+        --pending_;
+        fired.push_back(index);
+        index = next;
+    }
+}
+
+TimerHandle TimerWheel::schedule(Clock::duration delay, Callback callback) {
+    return schedule_at(Clock::now() + delay, std::move(callback));
+}
+
+TimerHandle TimerWheel::schedule_at(Clock::time_point when, Callback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t index = allocate();
+    Node& node = nodes_[index];
+    node.expiry = std::max(to_tick(when), current_tick_ + 1);
+    node.callback = std::move(callback);
+    node.state = State::PENDING;
+    insert(index);
+    ++pending_;
+    return TimerHandle{index, node.generation};
+}
+
+bool TimerWheel::cancel(TimerHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = lookup(handle);
+    if (!node) {
+        return false;
+    }
+    switch (node->state) {
+    case State::PENDING:
+        unlink(handle.index);
+        --pending_;
+        release(handle.index);
+        return true;
+    case State::DUE:
+        // advance() skips it and releases the node
+        node->cancelled = true;
+        return true;
+    case State::RUNNING:
+        node->cancelled = true;
+        return false;
+    default:
+        return false;
+    }
+}
+
+void TimerWheel::cancel_and_wait(TimerHandle handle) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Node* node = lookup(handle);
+    if (!node) {
+        return;
+    }
+    if (node->state == State::PENDING) {
+        unlink(handle.index);
+        --pending_;
+        release(handle.index);
+        return;
+    }
+
+    node->cancelled = true;
+    if (node->state == State::RUNNING && advancing_thread_ != std::this_thread::get_id()) {
+        // Cancelled nodes are released once their callback returns
+        callback_done_.wait(lock, [this, handle]() { return lookup(handle) == nullptr; });
+    }
+}
+
+bool TimerWheel::restart(TimerHandle handle, Clock::duration delay) {
+    Clock::time_point when = Clock::now() + delay;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = lookup(handle);
+    if (!node || node->cancelled) {
+        return false;
+    }
+    node->expiry = std::max(to_tick(when), current_tick_ + 1);
+    if (node->state == State::PENDING) {
+        unlink(handle.index);
+        insert(handle.index);
+    } else {
+        // Re-inserted by advance() once the callback is done (or instead of running it)
+        node->restarted = true;
+    }
+    return true;
+}
+
+size_t TimerWheel::advance(Clock::time_point now) {
+    std::vector<uint32_t> fired;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    uint64_t target = now > origin_ ? static_cast<uint64_t>((now - origin_) / tick_) : 0;
+    while (current_tick_ < target) {
+        if (pending_ == 0) {
+            // Nothing to cascade or fire: jump straight to now
+            current_tick_ = target;
+            break;
+        }
+        step(fired);
+    }
+    if (fired.empty()) {
+        return 0;
+    }
+
+    advancing_thread_ = std::this_thread::get_id();
+    size_t run = 0;
+    for (uint32_t index : fired) {
+        Node& node = nodes_[index];
+        if (!node.cancelled && !node.restarted) {
+            node.state = State::RUNNING;
+            Callback callback = std::move(node.callback);
+            lock.unlock();
+            try {
+                callback();
+            } catch (const std::exception& e) {
+                std::cerr << "Timer callback error: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "Timer callback error" << std::endl;
+            }
+            lock.lock();
+            ++run;
+            // nodes_ may have grown while unlocked
+            nodes_[index].callback = std::move(callback);
+        }
+
+        Node& done = nodes_[index];
+        if (done.restarted && !done.cancelled) {
+            done.restarted = false;
+            done.state = State::PENDING;
+            done.expiry = std::max(done.expiry, current_tick_ + 1);
+            insert(index);
+            ++pending_;
+        } else {
+            release(index);
+        }
+        callback_done_.notify_all();
+    }
+    advancing_thread_ = std::thread::id();
+    return run;
+}
+
+TimerWheel::Clock::time_point TimerWheel::next_expiry() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ == 0) {
+        return Clock::time_point::max();
+    }
+    // The next occupied level 0 slot, or the next cascade if level 0 is empty
+    uint64_t tick = current_tick_ + 1;
+    while ((tick & kSlotMask) != 0 && slots_[0][tick & kSlotMask] == kNil) {
+        ++tick;
+    }
+    return origin_ + tick_ * static_cast<Clock::rep>(tick);
+}
+
+size_t TimerWheel::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+// TimerService implementation
+TimerService& TimerService::fine() {
+    // Never destroyed: timers may still be cancelled from other static destructors
+    static TimerService* service = new TimerService(TimerWheel::Options{std::chrono::milliseconds(1), 4096});
+    return *service;
+}
+
+TimerService& TimerService::coarse() {
+    static TimerService* service = new TimerService(TimerWheel::Options{std::chrono::milliseconds(100), 4096});
+    return *service;
+}
+
+TimerService::TimerService(const TimerWheel::Options& options) : wheel_(options) {
+    thread_ = std::thread([this]() { run(); });
+}
+
+TimerService::~TimerService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+TimerHandle TimerService::schedule(Clock::duration delay, TimerWheel::Callback callback) {
+    TimerHandle handle = wheel_.schedule(delay, std::move(callback));
+    wake_if_before(Clock::now() + delay);
+    return handle;
+}
+
+bool TimerService::restart(TimerHandle handle, Clock::duration delay) {
+    if (!wheel_.restart(handle, delay)) {
+        return false;
+    }
+    wake_if_before(Clock::now() + delay);
+    return true;
+}
+
+void TimerService::wake_if_before(Clock::time_point when) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (when < sleeping_until_) {
+        sleeping_until_ = when;
+        wakeup_.notify_one();
+    }
+}
+
+void TimerService::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        wheel_.advance();
+        lock.lock();
+
+        // Read under mutex_: a timer inserted after this point calls wake_if_before(),
+        // which sees the new sleeping_until_
+        sleeping_until_ = wheel_.next_expiry();
+        while (!stopping_ && Clock::now() < sleeping_until_) {
+            if (sleeping_until_ == Clock::time_point::max()) {
+                wakeup_.wait(lock);
+            } else {
+                wakeup_.wait_until(lock, sleeping_until_);
+            }
+        }
+    }
+}
+
+} // namespace bitrpc
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bitrpc {
+
+// Refers to one scheduled timer. Handles are generation-checked, so a stale handle
+// (timer already fired or cancelled, slot reused) is harmless to cancel or restart.
+struct TimerHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool valid() const { return generation != 0; }
+};
+
+// Hierarchical hashed timing wheel: 4 levels of 256 slots, so timers up to 2^32 ticks
+// away are placed with O(1) insert and cancel regardless of how many are pending.
+// Timers further out are parked in the top level and re-placed as it cascades.
+// Expiry is rounded up to the next tick; a timer never fires early.
+//
+// The wheel is passive: whoever owns it calls advance() (an event loop, or a
+// TimerService thread). Callbacks run on that thread without the wheel lock held, so
+// they may schedule, cancel and restart timers, including their own.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    struct Options {
+        std::chrono::microseconds tick{1000};
+        size_t initial_capacity = 1024;
+    };
+
+    TimerWheel();
+    explicit TimerWheel(const Options& options);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    TimerHandle schedule(Clock::duration delay, Callback callback);
+    TimerHandle schedule_at(Clock::time_point when, Callback callback);
+
+    // True if the callback will not run (again). A callback that is running right now
+    // completes, but a restart() it makes is dropped.
+    bool cancel(TimerHandle handle);
+    // cancel() that also waits for a running callback to return. Must not be called by
+    // the callback itself for its own handle (it then behaves like cancel()).
+    void cancel_and_wait(TimerHandle handle);
+    // Moves a pending timer, or re-arms a running one from inside its callback; the
+    // handle stays the same. False if the timer is gone.
+    bool restart(TimerHandle handle, Clock::duration delay);
+
+    // Fires everything due at now; returns the number of callbacks run
+    size_t advance(Clock::time_point now = Clock::now());
+    // Earliest time advance() may have work; time_point::max() when empty
+    Clock::time_point next_expiry() const;
+
+    size_t size() const;
+    Clock::duration tick() const { return tick_; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+    static constexpr uint32_t kNil = ~0u;
+
+    // DUE: taken off the wheel by advance() but its callback has not started yet
+    enum class State : uint8_t { FREE, PENDING, DUE, RUNNING };
+
+    struct Node {
+        uint64_t expiry = 0;  // in ticks since origin_
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 1;
+        uint16_t bucket = 0;  // level * kSlots + slot while PENDING
+        State state = State::FREE;
+        bool cancelled = false;  // while DUE/RUNNING: do not run, drop any restart
+        bool restarted = false;  // while DUE/RUNNING: re-insert at expiry instead of releasing
+        Callback callback;
+    };
+
+    uint64_t to_tick(Clock::time_point when) const;
+    Node* lookup(TimerHandle handle);
+    uint32_t allocate();
+    void release(uint32_t index);
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(int level, uint32_t slot);
+    // Moves the wheel forward by one tick, appending due timers to fired
+    void step(std::vector<uint32_t>& fired);
+
+    Clock::duration tick_;
+    Clock::time_point origin_;
+    uint64_t current_tick_ = 0;
+    size_t pending_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable callback_done_;
+    std::thread::id advancing_thread_;
+    std::vector<Node> nodes_;
+    uint32_t free_list_ = kNil;
+    std::array<std::array<uint32_t, kSlots>, kLevels> slots_;
+};
+
+// A TimerWheel with its own driving thread. The thread sleeps until the next expiry
+// rather than waking every tick, so an idle service costs nothing.
+class TimerService {
+public:
+    using Clock = TimerWheel::Clock;
+
+    // 1 ms ticks: call deadlines and other sub-second timeouts
+    static TimerService& fine();
+    // 100 ms ticks: idle connections, heartbeats, anything measured in seconds
+    static TimerService& coarse();
+
+    explicit TimerService(const TimerWheel::Options& options);
+    ~TimerService();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    TimerHandle schedule(Clock::duration delay, TimerWheel::Callback callback);
+    bool cancel(TimerHandle handle) { return wheel_.cancel(handle); }
+    void cancel_and_wait(TimerHandle handle) { wheel_.cancel_and_wait(handle); }
+    bool restart(TimerHandle handle, Clock::duration delay);
+
+    TimerWheel& wheel() { return wheel_; }
+
+private:
+    void run();
+    void wake_if_before(Clock::time_point when);
+
+    TimerWheel wheel_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    Clock::time_point sleeping_until_ = Clock::time_point::max();
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace bitrpc
@@ -0,0 +1,227 @@
+#include "transport_options.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#define SOCKET int
+#endif
+
+namespace bitrpc {
+
+namespace {
+
+SOCKET to_socket(void* socket) {
+    return static_cast<SOCKET>(reinterpret_cast<intptr_t>(socket));
+}
+
+bool set_int_option(SOCKET sock, int level, int name, int value) {
+    return setsockopt(sock, level, name, reinterpret_cast<const char*>(&value), sizeof(value)) == 0;
+}
+
+int get_int_option(SOCKET sock, int level, int name) {
+    int value = 0;
+#ifdef _WIN32
+    int length = sizeof(value);
+#else
+    socklen_t length = sizeof(value);
+#endif
+    if (getsockopt(sock, level, name, reinterpret_cast<char*>(&value), &length) != 0) {
+        return 0;
+    }
+    return value;
+}
+
+} // namespace
+
+void TransportOptions::validate() const {
+    if (send_buffer_size < 0) throw std::invalid_argument("send_buffer_size must be >= 0");
+    if (receive_buffer_size < 0) throw std::invalid_argument("receive_buffer_size must be >= 0");
+    if (busy_poll_us < 0 || busy_poll_us > 1000000) throw std::invalid_argument("busy_poll_us must be in [0, 1000000]");
+    if (listen_backlog < 0) throw std::invalid_argument("listen_backlog must be >= 0");
+    if (keepalive_idle_s < 0 || keepalive_interval_s < 0 || keepalive_count < 0) {
+        throw std::invalid_argument("keepalive parameters must be >= 0");
+    }
+    if (!keepalive && (keepalive_idle_s || keepalive_interval_s || keepalive_count)) {
+        throw std::invalid_argument("keepalive parameters set but keepalive is disabled");
+    }
+    if (auto_tune_buffers) {
+        if (min_auto_buffer_size <= 0 || max_auto_buffer_size < min_auto_buffer_size) {
+            throw std::invalid_argument("auto-tune buffer bounds must satisfy 0 < min <= max");
+        }
+        if (bandwidth_hint_bps == 0) {
+            throw std::invalid_argument("auto_tune_buffers requires bandwidth_hint_bps");
+        }
+    }
+}
+
+std::string EffectiveSocketOptions::to_string() const {
+    std::ostringstream out;
+    out << "nodelay=" << tcp_nodelay
+        << " quickack=" << tcp_quickack
+        << " sndbuf=" << send_buffer_size
+        << " rcvbuf=" << receive_buffer_size
+        << " busy_poll_us=" << busy_poll_us
+        << " keepalive=" << keepalive;
+    if (keepalive) {
+        out << " (idle=" << keepalive_idle_s << "s intvl=" << keepalive_interval_s << "s cnt=" << keepalive_count << ")";
+    }
+    out << " rtt_us=" << rtt_us;
+    return out.str();
+}
+
+void SocketTuner::apply_pre_connect(void* socket, const TransportOptions& options) {
+    SOCKET sock = to_socket(socket);
+
+    // Buffers must be sized before the handshake to influence the window scale
+    if (!options.auto_tune_buffers) {
+        if (options.send_buffer_size > 0) {
+            set_int_option(sock, SOL_SOCKET, SO_SNDBUF, options.send_buffer_size);
+        }
+        if (options.receive_buffer_size > 0) {
+            set_int_option(sock, SOL_SOCKET, SO_RCVBUF, options.receive_buffer_size);
+        }
+    }
+
+#ifdef SO_BUSY_POLL
+    if (options.busy_poll_us > 0) {
+        set_int_option(sock, SOL_SOCKET, SO_BUSY_POLL, options.busy_poll_us);
+    }
+#endif
+}
+
+EffectiveSocketOptions SocketTuner::apply_connected(void* socket, const TransportOptions& options) {
+    SOCKET sock = to_socket(socket);
+
+    if (options.tcp_nodelay) {
+        set_int_option(sock, IPPROTO_TCP, TCP_NODELAY, 1);
+    }
+
+    if (options.tcp_quickack) {
+        rearm_quickack(socket);
+    }
+
+    if (options.keepalive) {
+        set_int_option(sock, SOL_SOCKET, SO_KEEPALIVE, 1);
+#ifndef _WIN32
+        if (options.keepalive_idle_s > 0) {
+#ifdef TCP_KEEPIDLE
+            set_int_option(sock, IPPROTO_TCP, TCP_KEEPIDLE, options.keepalive_idle_s);
+#endif
+        }
+        if (options.keepalive_interval_s > 0) {
+            set_int_option(sock, IPPROTO_TCP, TCP_KEEPINTVL, options.keepalive_interval_s);
+        }
+        if (options.keepalive_count > 0) {
+            set_int_option(sock, IPPROTO_TCP, TCP_KEEPCNT, options.keepalive_count);
+        }
+#endif
+    }
+
+    // Busy poll is per socket and not inherited from the listener
+    apply_pre_connect(socket, options);
+
+    if (options.auto_tune_buffers) {
+        auto_tune_buffers(socket, options);
+    }
+
+    EffectiveSocketOptions effective = query(socket);
+    effective.tcp_quickack = options.tcp_quickack && effective.tcp_quickack;
+    return effective;
+}
+
+EffectiveSocketOptions SocketTuner::query(void* socket) {
+    SOCKET sock = to_socket(socket);
+    EffectiveSocketOptions effective;
+
+    effective.tcp_nodelay = get_int_option(sock, IPPROTO_TCP, TCP_NODELAY) != 0;
+    effective.send_buffer_size = get_int_option(sock, SOL_SOCKET, SO_SNDBUF);
+    effective.receive_buffer_size = get_int_option(sock, SOL_SOCKET, SO_RCVBUF);
+    effective.keepalive = get_int_option(sock, SOL_SOCKET, SO_KEEPALIVE) != 0;
+
+#ifndef _WIN32
+#ifdef TCP_QUICKACK
+    effective.tcp_quickack = get_int_option(sock, IPPROTO_TCP, TCP_QUICKACK) != 0;
+#endif
+#ifdef SO_BUSY_POLL
+    effective.busy_poll_us = get_int_option(sock, SOL_SOCKET, SO_BUSY_POLL);
+#endif
+    if (effective.keepalive) {
+#ifdef TCP_KEEPIDLE
+        effective.keepalive_idle_s = get_int_option(sock, IPPROTO_TCP, TCP_KEEPIDLE);
+#endif
+        effective.keepalive_interval_s = get_int_option(sock, IPPROTO_TCP, TCP_KEEPINTVL);
+        effective.keepalive_count = get_int_option(sock, IPPROTO_TCP, TCP_KEEPCNT);
+    }
+#ifdef TCP_INFO
+    struct tcp_info info {};
+    socklen_t length = sizeof(info);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &length) == 0) {
+        effective.rtt_us = info.tcpi_rtt;
+    }
+#endif
+#endif
+
+    return effective;
+}
+
+int SocketTuner::auto_tune_buffers(void* socket, const TransportOptions& options) {
+#if !defined(_WIN32) && defined(TCP_INFO)
+    // The handshake's cwnd is no estimate of the link, and setting SO_SNDBUF/SO_RCVBUF
+    // turns off kernel autotuning for the connection; only act on an explicit hint
+    if (options.bandwidth_hint_bps == 0) {
+        return 0;
+    }
+
+    SOCKET sock = to_socket(socket);
+
+    struct tcp_info info {};
+    socklen_t length = sizeof(info);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &length) != 0 || info.tcpi_rtt == 0) {
+        return 0;
+    }
+
+    // BDP in bytes = bandwidth (bytes/s) * RTT (s)
+    uint64_t bdp = options.bandwidth_hint_bps / 8 * info.tcpi_rtt / 1000000;
+
+    // Twice the BDP leaves room for the kernel's own bookkeeping share of the buffer
+    uint64_t size = std::min<uint64_t>(std::max<uint64_t>(bdp * 2, options.min_auto_buffer_size),
+                                       options.max_auto_buffer_size);
+    set_int_option(sock, SOL_SOCKET, SO_SNDBUF, static_cast<int>(size));
+    set_int_option(sock, SOL_SOCKET, SO_RCVBUF, static_cast<int>(size));
+    return static_cast<int>(size);
+#else
+    (void)socket;
+    (void)options;
+    return 0;
+#endif
+}
+
+void SocketTuner::set_cork(void* socket, bool enabled) {
+#if !defined(_WIN32) && defined(TCP_CORK)
+    set_int_option(to_socket(socket), IPPROTO_TCP, TCP_CORK, enabled ? 1 : 0);
+#else
+    (void)socket;
+    (void)enabled;
+#endif
+}
+
+void SocketTuner::rearm_quickack(void* socket) {
+#if !defined(_WIN32) && defined(TCP_QUICKACK)
+    set_int_option(to_socket(socket), IPPROTO_TCP, TCP_QUICKACK, 1);
+#else
+    (void)socket;
+#endif
+}
+
+int SocketTuner::listen_backlog(const TransportOptions& options) {
+    return options.listen_backlog > 0 ? options.listen_backlog : SOMAXCONN;
+}
+
+} // namespace bitrpc
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace bitrpc {
+
+// Socket tuning for TCP transports. Zero/false means "leave the kernel default".
+struct TransportOptions {
+    // Disable Nagle; request/response framing otherwise stalls on delayed ACKs
+    bool tcp_nodelay = true;
+    // Linux: ACK immediately instead of delaying (re-armed after every receive)
+    bool tcp_quickack = false;
+
+    // Fixed SO_SNDBUF/SO_RCVBUF in bytes (note: fixing them disables kernel autotuning)
+    int send_buffer_size = 0;
+    int receive_buffer_size = 0;
+
+    // Size both buffers from the bandwidth-delay product once the connection has an
+    // RTT sample. Requires bandwidth_hint_bps: at connect time the congestion window
+    // says nothing about the link, and fixing the sizes disables kernel autotuning,
+    // so without a hint the buffers are left to the kernel. Overrides the fixed sizes above.
+    bool auto_tune_buffers = false;
+    uint64_t bandwidth_hint_bps = 0;  // bits per second
+    int min_auto_buffer_size = 64 * 1024;
+    int max_auto_buffer_size = 16 * 1024 * 1024;
+
+    // Linux SO_BUSY_POLL: microseconds to busy-poll the device queue on blocking reads
+    int busy_poll_us = 0;
+
+    // Linux TCP_CORK around multi-part frame writes (length prefix + body) so they
+    // leave as one segment
+    bool tcp_cork = false;
+
+    // Server listen() backlog; 0 means SOMAXCONN
+    int listen_backlog = 0;
+
+    bool keepalive = false;
+    int keepalive_idle_s = 0;      // TCP_KEEPIDLE
+    int keepalive_interval_s = 0;  // TCP_KEEPINTVL
+    int keepalive_count = 0;       // TCP_KEEPCNT
+
+    // Throws std::invalid_argument describing the first invalid value
+    void validate() const;
+};
+
+// Values read back from the socket after applying TransportOptions.
+// Buffer sizes are what the kernel reports (Linux doubles the requested value).
+struct EffectiveSocketOptions {
+    bool tcp_nodelay = false;
+    bool tcp_quickack = false;
+    int send_buffer_size = 0;
+    int receive_buffer_size = 0;
+    int busy_poll_us = 0;
+    bool keepalive = false;
+    int keepalive_idle_s = 0;
+    int keepalive_interval_s = 0;
+    int keepalive_count = 0;
+    uint32_t rtt_us = 0;  // smoothed RTT from TCP_INFO (Linux, connected sockets only)
+
+    std::string to_string() const;
+};
+
+// Applies TransportOptions to platform sockets (passed as the void* handles used by
+// the client/server classes). Options a platform does not support are skipped and
+// show up as unset in the effective values.
+class SocketTuner {
+public:
+    // Options that must be in place before listen()/connect() (buffers, busy poll)
+    static void apply_pre_connect(void* socket, const TransportOptions& options);
+    // Per-connection options (nodelay, quickack, keepalive, BDP auto-tune)
+    static EffectiveSocketOptions apply_connected(void* socket, const TransportOptions& options);
+
+    static EffectiveSocketOptions query(void* socket);
+
+    // Resize buffers from the bandwidth-delay product; returns the chosen size, or 0
+    // when no bandwidth hint or RTT sample is available (buffers left untouched)
+    static int auto_tune_buffers(void* socket, const TransportOptions& options);
+
+    static void set_cork(void* socket, bool enabled);
+    static void rearm_quickack(void* socket);
+
+    static int listen_backlog(const TransportOptions& options);
+};
+
+} // namespace bitrpc
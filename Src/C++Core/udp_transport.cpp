@@ -0,0 +1,695 @@
+#include "udp_transport.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <poll.h>
+#define SOCKET int
+#define INVALID_SOCKET -1
+#define closesocket close
+#endif
+
+namespace bitrpc {
+
+namespace {
+
+SOCKET to_socket(void* handle) {
+    return static_cast<SOCKET>(reinterpret_cast<intptr_t>(handle));
+}
+
+void* to_handle(SOCKET sock) {
+    return reinterpret_cast<void*>(static_cast<intptr_t>(sock));
+}
+
+void initialize_network() {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        throw std::runtime_error("Failed to initialize Winsock");
+    }
+#endif
+}
+
+void cleanup_network() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+SOCKET create_udp_socket(const UdpTransportOptions& options) {
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+        throw ConnectionException("Failed to create UDP socket");
+    }
+    if (options.send_buffer_size > 0) {
+        setsockopt(sock, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&options.send_buffer_size),
+                   sizeof(options.send_buffer_size));
+    }
+    if (options.receive_buffer_size > 0) {
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&options.receive_buffer_size),
+                   sizeof(options.receive_buffer_size));
+    }
+    return sock;
+}
+
+void resolve_address(const std::string& host, int port, sockaddr_in& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    if (host.empty() || host == "0.0.0.0") {
+        address.sin_addr.s_addr = INADDR_ANY;
+        return;
+    }
+
+    struct hostent* host_info = gethostbyname(host.c_str());
+    if (!host_info) {
+        throw ConnectionException("Failed to resolve hostname: " + host);
+    }
+    std::memcpy(&address.sin_addr, host_info->h_addr_list[0], host_info->h_length);
+}
+
+uint64_t sender_id_of(const sockaddr_in& address) {
+    return (static_cast<uint64_t>(address.sin_addr.s_addr) << 16) | address.sin_port;
+}
+
+} // namespace
+
+void UdpTransportOptions::validate() const {
+    if (max_datagram_size <= udp_wire::kHeaderSize || max_datagram_size > 65507) {
+        throw std::invalid_argument("max_datagram_size must be in (header size, 65507]");
+    }
+    if (batch_size <= 0) throw std::invalid_argument("batch_size must be > 0");
+    if (send_buffer_size < 0 || receive_buffer_size < 0) throw std::invalid_argument("buffer sizes must be >= 0");
+    if (poll_interval_ms <= 0) throw std::invalid_argument("poll_interval_ms must be > 0");
+    if (worker_threads < 0) throw std::invalid_argument("worker_threads must be >= 0");
+    if (worker_queue_capacity == 0) throw std::invalid_argument("worker_queue_capacity must be > 0");
+    if (sequence_idle_timeout_ms < 0) throw std::invalid_argument("sequence_idle_timeout_ms must be >= 0");
+}
+
+// UdpPublisher implementation
+UdpPublisher::UdpPublisher(const std::string& host, int port, const UdpTransportOptions& options)
+    : options_(options), socket_(nullptr), epoch_(0), datagrams_sent_(0) {
+    options_.validate();
+    initialize_network();
+
+    SOCKET sock = create_udp_socket(options_);
+    sockaddr_in address;
+    try {
+        resolve_address(host, port, address);
+    } catch (...) {
+        closesocket(sock);
+        throw;
+    }
+
+    // Connected UDP socket: the kernel caches the route and we can use plain send()
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        closesocket(sock);
+        throw ConnectionException("Failed to connect UDP socket");
+    }
+    socket_ = to_handle(sock);
+
+    // A new epoch tells receivers to restart sequence tracking for this sender
+    std::random_device random;
+    epoch_ = random();
+}
+
+UdpPublisher::~UdpPublisher() {
+    if (socket_) {
+        closesocket(to_socket(socket_));
+        socket_ = nullptr;
+    }
+    cleanup_network();
+}
+
+std::vector<uint8_t> UdpPublisher::encode(UdpMessageKind kind, const std::string& name,
+                                          const uint8_t* payload, size_t size) {
+    size_t total = udp_wire::kHeaderSize + name.size() + size;
+    if (name.size() > 0xFFFF || total > options_.max_datagram_size) {
+        throw ProtocolException("UDP message for '" + name + "' is " + std::to_string(total) +
+                                " bytes, exceeds max datagram size " + std::to_string(options_.max_datagram_size));
+    }
+
+    // Caller holds mutex_
+    uint64_t sequence = ++sequences_[name];
+
+    std::vector<uint8_t> datagram(total);
+    uint8_t* out = datagram.data();
+    uint16_t magic = udp_wire::kMagic;
+    uint16_t name_length = static_cast<uint16_t>(name.size());
+    std::memcpy(out, &magic, 2);
+    out[2] = udp_wire::kVersion;
+    out[3] = static_cast<uint8_t>(kind);
+    std::memcpy(out + 4, &epoch_, 4);
+    std::memcpy(out + 8, &sequence, 8);
+    std::memcpy(out + 16, &name_length, 2);
+    std::memcpy(out + udp_wire::kHeaderSize, name.data(), name.size());
+    if (size > 0) {
+        std::memcpy(out + udp_wire::kHeaderSize + name.size(), payload, size);
+    }
+    return datagram;
+}
+
+void UdpPublisher::publish(const std::string& topic, const uint8_t* payload, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto datagram = encode(UdpMessageKind::TOPIC, topic, payload, size);
+    if (send(to_socket(socket_), reinterpret_cast<const char*>(datagram.data()), static_cast<int>(datagram.size()), 0) >= 0) {
+        datagrams_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void UdpPublisher::call_one_way(const std::string& method, const std::vector<uint8_t>& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto datagram = encode(UdpMessageKind::ONE_WAY_CALL, method, request.data(), request.size());
+    if (send(to_socket(socket_), reinterpret_cast<const char*>(datagram.data()), static_cast<int>(datagram.size()), 0) >= 0) {
+        datagrams_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void UdpPublisher::enqueue_publish(const std::string& topic, const uint8_t* payload, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(encode(UdpMessageKind::TOPIC, topic, payload, size));
+}
+
+void UdpPublisher::enqueue_call_one_way(const std::string& method, const std::vector<uint8_t>& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(encode(UdpMessageKind::ONE_WAY_CALL, method, request.data(), request.size()));
+}
+
+size_t UdpPublisher::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+size_t UdpPublisher::flush() {
+    std::vector<std::vector<uint8_t>> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.swap(pending_);
+    }
+    size_t sent = send_datagrams(batch);
+    datagrams_sent_.fetch_add(sent, std::memory_order_relaxed);
+    return sent;
+}
+
+size_t UdpPublisher::send_datagrams(const std::vector<std::vector<uint8_t>>& datagrams) {
+    SOCKET sock = to_socket(socket_);
+    size_t sent = 0;
+
+#if defined(__linux__)
+    size_t batch = static_cast<size_t>(options_.batch_size);
+    std::vector<mmsghdr> messages(std::min(batch, datagrams.size()));
+    std::vector<iovec> vectors(messages.size());
+
+    while (sent < datagrams.size()) {
+        size_t count = std::min(messages.size(), datagrams.size() - sent);
+        for (size_t i = 0; i < count; ++i) {
+            const auto& datagram = datagrams[sent + i];
+            vectors[i].iov_base = const_cast<uint8_t*>(datagram.data());
+            vectors[i].iov_len = datagram.size();
+            std::memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int result = sendmmsg(sock, messages.data(), static_cast<unsigned int>(count), 0);
+        if (result <= 0) {
+            break;  // best effort: the remaining updates are dropped like lost datagrams
+        }
+        sent += static_cast<size_t>(result);
+    }
+#else
+    for (const auto& datagram : datagrams) {
+        if (send(sock, reinterpret_cast<const char*>(datagram.data()), static_cast<int>(datagram.size()), 0) < 0) {
+            break;
+        }
+        ++sent;
+    }
+#endif
+
+    return sent;
+}
+
+// UdpServer implementation
+UdpServer::UdpServer(const UdpTransportOptions& options, std::shared_ptr<ServiceManager> service_manager)
+    : options_(options),
+      service_manager_(service_manager ? service_manager : std::make_shared<ServiceManager>()),
+      socket_(nullptr),
+      is_running_(false),
+      spare_buffers_(std::max<size_t>(1, static_cast<size_t>(options.worker_threads) * options.worker_queue_capacity)),
+      workers_stopping_(false),
+      datagrams_received_(0),
+      delivered_(0),
+      dropped_stale_(0),
+      dropped_malformed_(0),
+      dropped_unhandled_(0),
+      dropped_overload_(0),
+      handler_errors_(0) {
+    options_.validate();
+    initialize_network();
+
+    // One extra byte detects datagrams larger than the configured maximum
+    receive_buffers_.resize(static_cast<size_t>(options_.batch_size));
+    for (auto& buffer : receive_buffers_) {
+        buffer.resize(options_.max_datagram_size + 1);
+    }
+
+    for (int i = 0; i < options_.worker_threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>(options_.worker_queue_capacity));
+        workers_.back()->pending.reserve(static_cast<size_t>(options_.batch_size));
+    }
+    for (auto& worker : workers_) {
+        Worker* raw = worker.get();
+        worker->thread = std::thread([this, raw]() { worker_loop(*raw); });
+    }
+}
+
+UdpServer::~UdpServer() {
+    stop();
+    workers_stopping_.store(true);
+    for (auto& worker : workers_) {
+        worker->waiter.notify();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    if (socket_) {
+        closesocket(to_socket(socket_));
+        socket_ = nullptr;
+    }
+    cleanup_network();
+}
+
+void UdpServer::bind(const std::string& host, int port) {
+    SOCKET sock = create_udp_socket(options_);
+    sockaddr_in address;
+    try {
+        resolve_address(host, port, address);
+    } catch (...) {
+        closesocket(sock);
+        throw;
+    }
+
+    if (::bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        closesocket(sock);
+        throw ConnectionException("Failed to bind UDP socket");
+    }
+    if (socket_) {
+        closesocket(to_socket(socket_));
+    }
+    socket_ = to_handle(sock);
+}
+
+int UdpServer::local_port() const {
+    if (!socket_) {
+        return 0;
+    }
+    sockaddr_in address;
+#ifdef _WIN32
+    int length = sizeof(address);
+#else
+    socklen_t length = sizeof(address);
+#endif
+    if (getsockname(to_socket(socket_), reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+void UdpServer::subscribe(const std::string& topic, TopicHandler handler) {
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    topic_handlers_[topic] = std::make_shared<TopicHandler>(std::move(handler));
+}
+
+void UdpServer::unsubscribe(const std::string& topic) {
+    std::lock_guard<std::mutex> lock(handlers_mutex_);
+    topic_handlers_.erase(topic);
+}
+
+void UdpServer::start() {
+    if (!socket_) {
+        throw ConnectionException("UDP server is not bound");
+    }
+    if (is_running_.exchange(true)) {
+        return;
+    }
+    receive_thread_ = std::thread([this]() { receive_loop(); });
+}
+
+void UdpServer::stop() {
+    if (!is_running_.exchange(false)) {
+        return;
+    }
+    if (receive_thread_.joinable()) {
+        receive_thread_.join();
+    }
+}
+
+void UdpServer::receive_loop() {
+    while (is_running_) {
+        try {
+            poll_once(options_.poll_interval_ms);
+        } catch (const std::exception& e) {
+            std::cerr << "UDP receive error: " << e.what() << std::endl;
+        }
+    }
+}
+
+size_t UdpServer::poll_once(int timeout_ms) {
+    poll_time_ = std::chrono::steady_clock::now();
+    size_t received = receive_batch(timeout_ms);
+    if (!workers_.empty()) {
+        flush_handoffs();
+    }
+    expire_sequences();
+    return received;
+}
+
+size_t UdpServer::receive_batch(int timeout_ms) {
+    if (!socket_) {
+        throw ConnectionException("UDP server is not bound");
+    }
+    SOCKET sock = to_socket(socket_);
+
+#ifdef _WIN32
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(sock, &read_set);
+    timeval timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    if (select(0, &read_set, nullptr, nullptr, &timeout) <= 0) {
+        return 0;
+    }
+
+    size_t received = 0;
+    for (auto& buffer : receive_buffers_) {
+        sockaddr_in from;
+        int from_length = sizeof(from);
+        u_long available = 0;
+        if (received > 0 && (ioctlsocket(sock, FIONREAD, &available) != 0 || available == 0)) {
+            break;
+        }
+        int size = recvfrom(sock, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                            reinterpret_cast<sockaddr*>(&from), &from_length);
+        if (size < 0) {
+            break;
+        }
+        ++received;
+        datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+        dispatch(buffer.data(), static_cast<size_t>(size), sender_id_of(from));
+    }
+    return received;
+#else
+    pollfd descriptor{sock, POLLIN, 0};
+    if (::poll(&descriptor, 1, timeout_ms) <= 0) {
+        return 0;
+    }
+
+#if defined(__linux__)
+    size_t batch = receive_buffers_.size();
+    std::vector<mmsghdr> messages(batch);
+    std::vector<iovec> vectors(batch);
+    std::vector<sockaddr_in> senders(batch);
+    for (size_t i = 0; i < batch; ++i) {
+        vectors[i].iov_base = receive_buffers_[i].data();
+        vectors[i].iov_len = receive_buffers_[i].size();
+        std::memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &senders[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    int result = recvmmsg(sock, messages.data(), static_cast<unsigned int>(batch), MSG_DONTWAIT, nullptr);
+    if (result <= 0) {
+        return 0;
+    }
+    datagrams_received_.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+    for (int i = 0; i < result; ++i) {
+        if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            dropped_malformed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        dispatch(receive_buffers_[i].data(), messages[i].msg_len, sender_id_of(senders[i]));
+    }
+    return static_cast<size_t>(result);
+#else
+    size_t received = 0;
+    for (auto& buffer : receive_buffers_) {
+        sockaddr_in from;
+        socklen_t from_length = sizeof(from);
+        ssize_t size = recvfrom(sock, buffer.data(), buffer.size(), MSG_DONTWAIT,
+                                reinterpret_cast<sockaddr*>(&from), &from_length);
+        if (size < 0) {
+            break;
+        }
+        ++received;
+        datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+        dispatch(buffer.data(), static_cast<size_t>(size), sender_id_of(from));
+    }
+    return received;
+#endif
+#endif
+}
+
+bool UdpServer::decode(const uint8_t* data, size_t size, UdpMessage& message, uint32_t& epoch) {
+    if (size < udp_wire::kHeaderSize) {
+        return false;
+    }
+
+    uint16_t magic = 0;
+    uint64_t sequence = 0;
+    uint16_t name_length = 0;
+    std::memcpy(&magic, data, 2);
+    std::memcpy(&epoch, data + 4, 4);
+    std::memcpy(&sequence, data + 8, 8);
+    std::memcpy(&name_length, data + 16, 2);
+    uint8_t kind = data[3];
+
+    if (magic != udp_wire::kMagic || data[2] != udp_wire::kVersion ||
+        kind > static_cast<uint8_t>(UdpMessageKind::ONE_WAY_CALL) ||
+        udp_wire::kHeaderSize + name_length > size) {
+        return false;
+    }
+
+    message.kind = static_cast<UdpMessageKind>(kind);
+    message.name = std::string_view(reinterpret_cast<const char*>(data + udp_wire::kHeaderSize), name_length);
+    message.sequence = sequence;
+    message.payload = data + udp_wire::kHeaderSize + name_length;
+    message.payload_size = size - udp_wire::kHeaderSize - name_length;
+    return true;
+}
+
+void UdpServer::dispatch(const uint8_t* data, size_t size, uint64_t sender_id) {
+    UdpMessage message;
+    uint32_t epoch = 0;
+    if (size > options_.max_datagram_size || !decode(data, size, message, epoch)) {
+        dropped_malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Sequence state stays on the receiving thread; workers only see accepted messages
+    if (!accept_sequence(message.name, sender_id, epoch, message.sequence)) {
+        dropped_stale_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (workers_.empty()) {
+        deliver(message);
+    } else {
+        hand_off(message, data, size);
+    }
+}
+
+void UdpServer::deliver(const UdpMessage& message) {
+    try {
+        if (message.kind == UdpMessageKind::TOPIC) {
+            std::shared_ptr<TopicHandler> handler;
+            {
+                std::lock_guard<std::mutex> lock(handlers_mutex_);
+                auto it = topic_handlers_.find(std::string(message.name));
+                if (it != topic_handlers_.end()) {
+                    handler = it->second;
+                }
+            }
+            if (!handler) {
+                dropped_unhandled_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            (*handler)(message);
+        } else if (!dispatch_one_way(message)) {
+            return;
+        }
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+    } catch (const std::exception& e) {
+        handler_errors_.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Error handling UDP message '" << message.name << "': " << e.what() << std::endl;
+    }
+}
+
+void UdpServer::hand_off(const UdpMessage& message, const uint8_t* data, size_t size) {
+    Worker& worker = *workers_[std::hash<std::string_view>()(message.name) % workers_.size()];
+
+    Handoff handoff;
+    if (!spare_buffers_.try_pop(handoff.data)) {
+        handoff.data.reserve(options_.max_datagram_size);
+    }
+    handoff.data.assign(data, data + size);
+    handoff.size = size;
+    worker.pending.push_back(std::move(handoff));
+}
+
+void UdpServer::flush_handoffs() {
+    for (auto& worker : workers_) {
+        if (worker->pending.empty()) {
+            continue;
+        }
+        // One release store publishes the worker's share of the whole receive batch
+        size_t pushed = worker->queue.push_batch(worker->pending.data(), worker->pending.size());
+        if (pushed < worker->pending.size()) {
+            dropped_overload_.fetch_add(worker->pending.size() - pushed, std::memory_order_relaxed);
+            // Dropped datagrams still own pooled buffers; keep them for the next batch
+            for (size_t i = pushed; i < worker->pending.size(); ++i) {
+                spare_buffers_.try_push(std::move(worker->pending[i].data));
+            }
+        }
+        worker->pending.clear();
+        worker->waiter.notify();
+    }
+}
+
+void UdpServer::worker_loop(Worker& worker) {
+    constexpr size_t kPopBatch = 32;
+    constexpr int kSpinIterations = 2048;
+    Handoff batch[kPopBatch];
+    int idle_polls = 0;
+
+    for (;;) {
+        size_t count = worker.queue.pop_batch(batch, kPopBatch);
+        for (size_t i = 0; i < count; ++i) {
+            UdpMessage message;
+            uint32_t epoch = 0;
+            if (decode(batch[i].data.data(), batch[i].size, message, epoch)) {
+                deliver(message);
+            }
+            spare_buffers_.try_push(std::move(batch[i].data));
+        }
+        if (count > 0) {
+            idle_polls = 0;
+            continue;
+        }
+
+        // Drain before exiting so accepted datagrams are not lost on shutdown
+        if (workers_stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (++idle_polls < kSpinIterations) {
+            detail::cpu_relax();
+            continue;
+        }
+        idle_polls = 0;
+        worker.waiter.wait([&]() { return !worker.queue.empty() || workers_stopping_.load(); },
+                           std::chrono::milliseconds(options_.poll_interval_ms));
+    }
+}
+
+bool UdpServer::accept_sequence(std::string_view name, uint64_t sender_id, uint32_t epoch, uint64_t sequence) {
+    std::string key;
+    key.reserve(name.size() + sizeof(sender_id));
+    key.append(reinterpret_cast<const char*>(&sender_id), sizeof(sender_id));
+    key.append(name.data(), name.size());
+
+    auto it = sequences_.find(key);
+    if (it == sequences_.end()) {
+        sequences_.emplace(std::move(key), SequenceState{epoch, sequence, poll_time_});
+        return true;
+    }
+
+    SequenceState& state = it->second;
+    state.last_seen = poll_time_;
+    if (state.epoch != epoch) {
+        // Sender restarted: its sequence numbers start over
+        state.epoch = epoch;
+        state.last_sequence = sequence;
+        return true;
+    }
+    if (sequence <= state.last_sequence) {
+        return false;
+    }
+    state.last_sequence = sequence;
+    return true;
+}
+
+void UdpServer::expire_sequences() {
+    if (options_.sequence_idle_timeout_ms == 0 || poll_time_ < next_sequence_sweep_) {
+        return;
+    }
+    // Sweeping every half timeout keeps an entry at most 1.5x the timeout past its last datagram
+    auto timeout = std::chrono::milliseconds(options_.sequence_idle_timeout_ms);
+    next_sequence_sweep_ = poll_time_ + timeout / 2;
+    for (auto it = sequences_.begin(); it != sequences_.end();) {
+        if (poll_time_ - it->second.last_seen >= timeout) {
+            it = sequences_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool UdpServer::dispatch_one_way(const UdpMessage& message) {
+    size_t dot = message.name.find('.');
+    if (dot == std::string_view::npos) {
+        dropped_unhandled_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto service = service_manager_->get_service(std::string(message.name.substr(0, dot)));
+    std::string method(message.name.substr(dot + 1));
+    if (!service) {
+        dropped_unhandled_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    RpcArena arena(arena_options_);
+    RpcCallContext context;
+    context.request_data = message.payload;
+    context.request_size = message.payload_size;
+    context.arena = &arena;
+
+    // One-way: the handler runs, the serialized response is dropped with the arena
+    if (service->has_method(method)) {
+        service->call_method(method, context);
+    } else if (service->has_async_method(method)) {
+        service->call_method_async(method, context).get();
+    } else {
+        dropped_unhandled_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+UdpServer::Statistics UdpServer::get_statistics() const {
+    Statistics stats;
+    stats.datagrams_received = datagrams_received_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.dropped_stale = dropped_stale_.load(std::memory_order_relaxed);
+    stats.dropped_malformed = dropped_malformed_.load(std::memory_order_relaxed);
+    stats.dropped_unhandled = dropped_unhandled_.load(std::memory_order_relaxed);
+    stats.dropped_overload = dropped_overload_.load(std::memory_order_relaxed);
+    stats.handler_errors = handler_errors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace bitrpc
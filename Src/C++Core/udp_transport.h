@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "client.h"
+#include "lockfree_queue.h"
+#include "serialization.h"
+#include "server.h"
+
+namespace bitrpc {
+
+// Loss-tolerant one-way messaging over UDP.
+//
+// One message per datagram:
+//   [u16 magic][u8 version][u8 kind][u32 sender epoch][u64 sequence][u16 name_len][name][payload]
+// The name is a pub/sub topic or "Service.Method" for one-way calls. Sequence numbers are
+// per (sender, name); receivers drop anything not newer than the last delivered update,
+// so a late datagram never overwrites fresher state.
+struct UdpTransportOptions {
+    // Largest datagram that fits an Ethernet MTU without IP fragmentation
+    // (1500 - 20 IPv4 - 8 UDP). Larger messages are rejected, never fragmented.
+    size_t max_datagram_size = 1472;
+    // Datagrams per sendmmsg/recvmmsg call
+    int batch_size = 32;
+    int send_buffer_size = 0;     // 0 = kernel default
+    int receive_buffer_size = 0;  // 0 = kernel default
+    // Receive loop wake-up interval, bounds how long stop() waits
+    int poll_interval_ms = 100;
+    // Handler threads fed by the receiving thread through SPSC queues; 0 runs handlers on
+    // the receiving thread. A name always maps to the same worker, so per-topic order is
+    // kept. Datagrams that find their worker's queue full are dropped (dropped_overload).
+    int worker_threads = 0;
+    size_t worker_queue_capacity = 1024;
+    // Sequence state of a (sender, name) that has been silent this long is forgotten, so
+    // restarted or departed senders do not accumulate; its next datagram is accepted as
+    // the first one. 0 keeps the state forever.
+    int sequence_idle_timeout_ms = 60000;
+
+    void validate() const;
+};
+
+enum class UdpMessageKind : uint8_t {
+    TOPIC = 0,
+    ONE_WAY_CALL = 1
+};
+
+// A received datagram; the views are only valid inside the handler call
+struct UdpMessage {
+    UdpMessageKind kind;
+    std::string_view name;
+    uint64_t sequence;
+    const uint8_t* payload;
+    size_t payload_size;
+};
+
+namespace udp_wire {
+constexpr uint16_t kMagic = 0x5542;  // "BU"
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = 18;
+}
+
+// Sending side. publish()/call_one_way() send immediately; enqueue_*() + flush()
+// hand a whole batch to the kernel in one sendmmsg call.
+class UdpPublisher {
+public:
+    UdpPublisher(const std::string& host, int port, const UdpTransportOptions& options = UdpTransportOptions());
+    ~UdpPublisher();
+
+    UdpPublisher(const UdpPublisher&) = delete;
+    UdpPublisher& operator=(const UdpPublisher&) = delete;
+
+    void publish(const std::string& topic, const uint8_t* payload, size_t size);
+    void publish(const std::string& topic, const std::vector<uint8_t>& payload) {
+        publish(topic, payload.data(), payload.size());
+    }
+    template<typename T>
+    void publish_message(const std::string& topic, const T& message);
+
+    void call_one_way(const std::string& method, const std::vector<uint8_t>& request);
+
+    // Batched sending. All send paths throw ProtocolException when the datagram would
+    // exceed max_datagram_size.
+    void enqueue_publish(const std::string& topic, const uint8_t* payload, size_t size);
+    void enqueue_call_one_way(const std::string& method, const std::vector<uint8_t>& request);
+    // Returns the number of datagrams handed to the kernel
+    size_t flush();
+    size_t pending() const;
+
+    uint64_t datagrams_sent() const { return datagrams_sent_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<uint8_t> encode(UdpMessageKind kind, const std::string& name, const uint8_t* payload, size_t size);
+    size_t send_datagrams(const std::vector<std::vector<uint8_t>>& datagrams);
+
+    UdpTransportOptions options_;
+    void* socket_;
+    uint32_t epoch_;
+    std::unordered_map<std::string, uint64_t> sequences_;
+    std::vector<std::vector<uint8_t>> pending_;
+    mutable std::mutex mutex_;
+    std::atomic<uint64_t> datagrams_sent_;
+};
+
+// Receiving side: dispatches topics to subscribers and one-way calls to the
+// ServiceManager (responses are discarded).
+class UdpServer {
+public:
+    using TopicHandler = std::function<void(const UdpMessage& message)>;
+
+    struct Statistics {
+        uint64_t datagrams_received = 0;
+        uint64_t delivered = 0;
+        uint64_t dropped_stale = 0;
+        uint64_t dropped_malformed = 0;
+        uint64_t dropped_unhandled = 0;
+        uint64_t dropped_overload = 0;
+        uint64_t handler_errors = 0;
+    };
+
+    explicit UdpServer(const UdpTransportOptions& options = UdpTransportOptions(),
+                       std::shared_ptr<ServiceManager> service_manager = nullptr);
+    ~UdpServer();
+
+    UdpServer(const UdpServer&) = delete;
+    UdpServer& operator=(const UdpServer&) = delete;
+
+    // Port 0 binds an ephemeral port (see local_port())
+    void bind(const std::string& host, int port);
+    int local_port() const;
+
+    void subscribe(const std::string& topic, TopicHandler handler);
+    template<typename T>
+    void subscribe_message(const std::string& topic, std::function<void(const T& message, uint64_t sequence)> handler);
+    void unsubscribe(const std::string& topic);
+
+    ServiceManager& service_manager() { return *service_manager_; }
+
+    // Receive thread
+    void start();
+    void stop();
+    bool is_running() const { return is_running_; }
+
+    // Receive and dispatch at most one batch, waiting up to timeout_ms for the first
+    // datagram; returns the number of datagrams received. Usable without start(), but
+    // not from two threads at once.
+    size_t poll_once(int timeout_ms);
+
+    Statistics get_statistics() const;
+
+private:
+    struct SequenceState {
+        uint32_t epoch;
+        uint64_t last_sequence;
+        std::chrono::steady_clock::time_point last_seen;
+    };
+
+    // A datagram copied out of the receive buffers for a worker
+    struct Handoff {
+        std::vector<uint8_t> data;
+        size_t size = 0;
+    };
+
+    struct alignas(kCacheLineSize) Worker {
+        explicit Worker(size_t capacity) : queue(capacity) {}
+        SpscQueue<Handoff> queue;
+        QueueWaiter waiter;
+        std::thread thread;
+        std::vector<Handoff> pending;  // receiving thread only, flushed once per batch
+    };
+
+    void receive_loop();
+    size_t receive_batch(int timeout_ms);
+    // Validates the header; false for malformed datagrams
+    static bool decode(const uint8_t* data, size_t size, UdpMessage& message, uint32_t& epoch);
+    void dispatch(const uint8_t* data, size_t size, uint64_t sender_id);
+    bool accept_sequence(std::string_view name, uint64_t sender_id, uint32_t epoch, uint64_t sequence);
+    void expire_sequences();
+    // Runs the handler for an accepted message
+    void deliver(const UdpMessage& message);
+    // False when no service method handled the message (counted as dropped_unhandled)
+    bool dispatch_one_way(const UdpMessage& message);
+    void hand_off(const UdpMessage& message, const uint8_t* data, size_t size);
+    void flush_handoffs();
+    void worker_loop(Worker& worker);
+
+    UdpTransportOptions options_;
+    std::shared_ptr<ServiceManager> service_manager_;
+    void* socket_;
+    std::atomic<bool> is_running_;
+    std::thread receive_thread_;
+
+    std::unordered_map<std::string, std::shared_ptr<TopicHandler>> topic_handlers_;
+    mutable std::mutex handlers_mutex_;
+
+    // Only touched by the receiving thread
+    std::unordered_map<std::string, SequenceState> sequences_;
+    // Read once per poll, not per datagram
+    std::chrono::steady_clock::time_point poll_time_;
+    std::chrono::steady_clock::time_point next_sequence_sweep_;
+    std::vector<std::vector<uint8_t>> receive_buffers_;
+    RpcArena::Options arena_options_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    // Workers return used buffers to the receiving thread
+    MpscQueue<std::vector<uint8_t>> spare_buffers_;
+    std::atomic<bool> workers_stopping_;
+
+    std::atomic<uint64_t> datagrams_received_;
+    std::atomic<uint64_t> delivered_;
+    std::atomic<uint64_t> dropped_stale_;
+    std::atomic<uint64_t> dropped_malformed_;
+    std::atomic<uint64_t> dropped_unhandled_;
+    std::atomic<uint64_t> dropped_overload_;
+    std::atomic<uint64_t> handler_errors_;
+};
+
+// Template implementations
+template<typename T>
+void UdpPublisher::publish_message(const std::string& topic, const T& message) {
+    StreamWriter writer;
+    BufferSerializer::instance().serialize(&message, writer);
+    publish(topic, writer.data(), writer.size());
+}
+
+template<typename T>
+void UdpServer::subscribe_message(const std::string& topic,
+                                  std::function<void(const T& message, uint64_t sequence)> handler) {
+    subscribe(topic, [handler](const UdpMessage& message) {
+        auto* type_handler = BufferSerializer::instance().get_handler(typeid(T).hash_code());
+        if (!type_handler) {
+            throw std::runtime_error("No serializer for topic message type");
+        }
+        StreamReader reader(message.payload, message.payload_size);
+        T value;
+        if (!type_handler->read_into(reader, &value)) {
+            std::unique_ptr<T> boxed(static_cast<T*>(type_handler->read(reader)));
+            value = std::move(*boxed);
+        }
+        handler(value, message.sequence);
+    });
+}
+
+} // namespace bitrpc
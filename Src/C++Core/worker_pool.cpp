@@ -0,0 +1,121 @@
+#include "worker_pool.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace bitrpc {
+
+WorkerPool::WorkerPool() : WorkerPool(Options()) {}
+
+WorkerPool::WorkerPool(const Options& options) : options_(options) {
+    size_t count = options_.threads;
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : workers_) {
+        Worker* raw = worker.get();
+        worker->thread = std::thread([this, raw]() { run(*raw); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stopping_.store(true);
+    for (auto& worker : workers_) {
+        worker->waiter.notify();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    // A submit that passed its stopping check just before the flag was set can land
+    // after the worker's final empty check
+    for (auto& worker : workers_) {
+        while (!worker->queue.empty()) {
+            if (TaskNode* node = worker->queue.pop()) {
+                run_task(node);
+            } else {
+                std::this_thread::yield();  // a push is halfway done
+            }
+        }
+    }
+}
+
+void WorkerPool::submit(Task task) {
+    submit_to(next_worker_.fetch_add(1, std::memory_order_relaxed), std::move(task));
+}
+
+void WorkerPool::submit_to(size_t worker, Task task) {
+    if (stopping_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("WorkerPool is shutting down");
+    }
+    auto* node = new TaskNode();
+    node->task = std::move(task);
+    Worker& target = *workers_[worker % workers_.size()];
+    target.queue.push(node);
+    target.waiter.notify();
+}
+
+void WorkerPool::submit_batch(size_t worker, std::vector<Task>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    if (stopping_.load(std::memory_order_acquire)) {
+        throw std::runtime_error("WorkerPool is shutting down");
+    }
+    std::vector<TaskNode*> nodes;
+    nodes.reserve(tasks.size());
+    for (auto& task : tasks) {
+        auto* node = new TaskNode();
+        node->task = std::move(task);
+        nodes.push_back(node);
+    }
+    tasks.clear();
+
+    Worker& target = *workers_[worker % workers_.size()];
+    target.queue.push_batch(nodes.data(), nodes.size());
+    target.waiter.notify();
+}
+
+void WorkerPool::run_task(TaskNode* node) {
+    std::unique_ptr<TaskNode> owned(node);
+    try {
+        owned->task();
+    } catch (const std::exception& e) {
+        std::cerr << "Worker task error: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Worker task error" << std::endl;
+    }
+}
+
+void WorkerPool::run(Worker& worker) {
+    int idle_polls = 0;
+    for (;;) {
+        TaskNode* node = worker.queue.pop();
+        if (node) {
+            idle_polls = 0;
+            run_task(node);
+            continue;
+        }
+
+        if (!worker.queue.empty()) {
+            continue;  // a push is halfway done
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (++idle_polls < options_.spin_iterations) {
+            detail::cpu_relax();
+            continue;
+        }
+        idle_polls = 0;
+        worker.waiter.wait([&]() { return !worker.queue.empty() || stopping_.load(); },
+                           std::chrono::milliseconds(100));
+    }
+}
+
+} // namespace bitrpc
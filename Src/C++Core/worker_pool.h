@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "lockfree_queue.h"
+
+namespace bitrpc {
+
+// Fixed set of worker threads, each draining its own IntrusiveMpscQueue. Submitting is
+// one allocation plus one atomic exchange; an idle worker spins briefly before it
+// parks, so a busy pool hands tasks over without system calls.
+// Usable wherever the runtime accepts an executor (e.g. InProcessOptions::executor).
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    struct Options {
+        size_t threads = 0;            // 0 = std::thread::hardware_concurrency()
+        int spin_iterations = 2048;    // empty polls before parking (each one a pause)
+    };
+
+    WorkerPool();
+    explicit WorkerPool(const Options& options);
+    // Runs everything already submitted, then joins the workers. Tasks that reach a queue
+    // after its worker exited run on the destroying thread.
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Round-robin across workers. Submitting once destruction has begun throws
+    // std::runtime_error.
+    void submit(Task task);
+    // Tasks sent to the same worker run in submission order
+    void submit_to(size_t worker, Task task);
+    // Several tasks for one worker with a single queue operation
+    void submit_batch(size_t worker, std::vector<Task>& tasks);
+
+    size_t size() const { return workers_.size(); }
+
+    // Adapter for APIs that take std::function<void(std::function<void()>)>; the pool
+    // must outlive it
+    std::function<void(std::function<void()>)> executor() {
+        return [this](std::function<void()> task) { submit(std::move(task)); };
+    }
+
+private:
+    struct TaskNode : MpscNode {
+        Task task;
+    };
+
+    struct alignas(kCacheLineSize) Worker {
+        IntrusiveMpscQueue<TaskNode> queue;
+        QueueWaiter waiter;
+        std::thread thread;
+    };
+
+    void run(Worker& worker);
+    static void run_task(TaskNode* node);
+
+    Options options_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace bitrpc
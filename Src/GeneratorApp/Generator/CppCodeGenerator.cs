@@ -77,10 +77,19 @@ namespace BitRPC.Protocol.Generator
             sb.AppendLine(GenerateFileHeader("models.h", options));
             sb.AppendLine("#pragma once");
             sb.AppendLine();
+            var usePmr = UsePmrContainers(options);
             sb.AppendLine("#include <vector>");
             sb.AppendLine("#include <string>");
             sb.AppendLine("#include <chrono>");
+            if (usePmr)
+            {
+                sb.AppendLine("#include <memory_resource>");
+            }
             sb.AppendLine("#include \"../runtime/serialization.h\"");
+            if (definition.Messages.Any(m => m.FragmentCache))
+            {
+                sb.AppendLine("#include \"../runtime/fragment_cache.h\"");
+            }
             sb.AppendLine();
             sb.AppendLine("namespace bitrpc {");
             sb.AppendLine($"namespace {GetCppNamespace(options.Namespace)} {{");
@@ -89,15 +98,34 @@ namespace BitRPC.Protocol.Generator
             foreach (var message in definition.Messages)
             {
                 sb.AppendLine($"struct {message.Name} {{");
+                if (usePmr)
+                {
+                    // Allocator-aware: strings/vectors (recursively) draw from the given resource
+                    sb.AppendLine("    using allocator_type = std::pmr::polymorphic_allocator<char>;");
+                }
                 sb.AppendLine();
 
                 foreach (var field in message.Fields)
                 {
-                    sb.AppendLine($"    {GetCppType(field)} {field.Name};");
+                    sb.AppendLine($"    {GetCppType(field, options)} {field.Name};");
+                }
+                if (message.FragmentCache)
+                {
+                    sb.AppendLine("    // Not serialized. Set id to reuse this object's encoding; bump() after every change");
+                    sb.AppendLine("    FragmentIdentity fragment_identity;");
                 }
 
                 sb.AppendLine();
                 sb.AppendLine($"    {message.Name}();");
+                if (usePmr)
+                {
+                    sb.AppendLine($"    explicit {message.Name}(const allocator_type& alloc);");
+                    sb.AppendLine($"    {message.Name}(const {message.Name}& other, const allocator_type& alloc);");
+                    sb.AppendLine($"    {message.Name}(const {message.Name}& other) = default;");
+                    sb.AppendLine($"    {message.Name}({message.Name}&& other) = default;");
+                    sb.AppendLine($"    {message.Name}& operator=(const {message.Name}& other) = default;");
+                    sb.AppendLine($"    {message.Name}& operator=({message.Name}&& other) = default;");
+                }
                 sb.AppendLine("};");
                 sb.AppendLine();
             }
@@ -139,6 +167,11 @@ namespace BitRPC.Protocol.Generator
                 }
                 sb.AppendLine("}");
                 sb.AppendLine();
+
+                if (UsePmrContainers(options))
+                {
+                    GenerateAllocatorConstructors(sb, message);
+                }
             }
 
             sb.AppendLine("}} // namespace bitrpc");
@@ -146,6 +179,44 @@ namespace BitRPC.Protocol.Generator
             return sb.ToString();
         }
 
+        private void GenerateAllocatorConstructors(StringBuilder sb, ProtocolMessage message)
+        {
+            // Allocator-aware fields are initialized with the allocator, scalars keep their defaults
+            var allocFields = message.Fields.Where(IsAllocatorAwareField).ToList();
+
+            sb.Append($"{message.Name}::{message.Name}(const allocator_type& alloc)");
+            if (allocFields.Count > 0)
+            {
+                sb.Append(" : " + string.Join(", ", allocFields.Select(f => $"{f.Name}(alloc)")));
+            }
+            sb.AppendLine(" {");
+            foreach (var field in message.Fields.Where(f => !IsAllocatorAwareField(f)))
+            {
+                var defaultValue = GetCppDefaultValue(field);
+                if (!string.IsNullOrEmpty(defaultValue))
+                {
+                    sb.AppendLine($"    {field.Name} = {defaultValue};");
+                }
+            }
+            sb.AppendLine("}");
+            sb.AppendLine();
+
+            sb.Append($"{message.Name}::{message.Name}(const {message.Name}& other, const allocator_type& alloc)");
+            var copyInits = message.Fields.Select(f =>
+                IsAllocatorAwareField(f) ? $"{f.Name}(other.{f.Name}, alloc)" : $"{f.Name}(other.{f.Name})").ToList();
+            if (message.FragmentCache)
+            {
+                copyInits.Add("fragment_identity(other.fragment_identity)");
+            }
+            if (copyInits.Count > 0)
+            {
+                sb.Append(" : " + string.Join(", ", copyInits));
+            }
+            sb.AppendLine(" {");
+            sb.AppendLine("}");
+            sb.AppendLine();
+        }
+
         private void GenerateSerializationCode(ProtocolDefinition definition, GenerationOptions options, string baseDir)
         {
             var includeDir = Path.Combine(baseDir, "include");
@@ -188,12 +259,20 @@ namespace BitRPC.Protocol.Generator
             sb.AppendLine("    int hash_code() const override;");
             sb.AppendLine("    void write(const void* obj, StreamWriter& writer) const override;");
             sb.AppendLine("    void* read(StreamReader& reader) const override;");
+            sb.AppendLine("    bool read_into(StreamReader& reader, void* obj) const override;");
             sb.AppendLine("    bool is_default(const void* obj) const override { return is_default_" + lowerName + "(static_cast<const " + message.Name + "*>(obj)); }");
             sb.AppendLine();
             sb.AppendLine("    static " + message.Name + "Serializer& instance() { static " + message.Name + "Serializer inst; return inst; }");
             sb.AppendLine();
             sb.AppendLine("    static void serialize(const " + message.Name + "& obj, StreamWriter& writer);");
             sb.AppendLine("    static std::unique_ptr<" + message.Name + "> deserialize(StreamReader& reader);");
+            sb.AppendLine("    // Fill a default-constructed object in place (no intermediate allocations)");
+            sb.AppendLine("    static void deserialize_into(StreamReader& reader, " + message.Name + "& obj);");
+            if (message.FragmentCache)
+            {
+                sb.AppendLine("    // Encoding without the fragment cache");
+                sb.AppendLine("    static void write_fields(const " + message.Name + "& obj_ref, StreamWriter& writer);");
+            }
             sb.AppendLine("};");
             sb.AppendLine();
             sb.AppendLine("}} // namespace bitrpc");
@@ -241,8 +320,22 @@ namespace BitRPC.Protocol.Generator
             // Field groups
             var fieldGroups = message.Fields.Select(f => new { Field = f, Index = f.Id - 1 }).GroupBy(x => x.Index / 32).ToList();
             int groupCount = fieldGroups.Count;
-            sb.AppendLine("void " + message.Name + "Serializer::write(const void* obj, StreamWriter& writer) const {");
-            sb.AppendLine("    const auto& obj_ref = *static_cast<const " + message.Name + "*>(obj);");
+            if (message.FragmentCache)
+            {
+                sb.AppendLine("void " + message.Name + "Serializer::write(const void* obj, StreamWriter& writer) const {");
+                sb.AppendLine("    const auto& obj_ref = *static_cast<const " + message.Name + "*>(obj);");
+                sb.AppendLine("    // Identified objects are encoded once and spliced into later messages");
+                sb.AppendLine("    FragmentCache::instance().write(hash_code(), obj_ref.fragment_identity, writer,");
+                sb.AppendLine("        [&obj_ref](StreamWriter& fragment_writer) { write_fields(obj_ref, fragment_writer); });");
+                sb.AppendLine("}");
+                sb.AppendLine();
+                sb.AppendLine("void " + message.Name + "Serializer::write_fields(const " + message.Name + "& obj_ref, StreamWriter& writer) {");
+            }
+            else
+            {
+                sb.AppendLine("void " + message.Name + "Serializer::write(const void* obj, StreamWriter& writer) const {");
+                sb.AppendLine("    const auto& obj_ref = *static_cast<const " + message.Name + "*>(obj);");
+            }
             for (int g = 0; g < groupCount; g++) sb.AppendLine("    uint32_t mask" + g + " = 0;");
             foreach (var grp in fieldGroups.Select((grp, gi) => new { grp, gi }))
             {
@@ -269,20 +362,29 @@ namespace BitRPC.Protocol.Generator
             foreach (var field in message.Fields)
             {
                 int index = field.Id - 1; int group = index / 32; int bitPos = index % 32;
-                sb.AppendLine("    if (mask" + group + " & (1u << " + bitPos + ")) { " + GenerateCppWriteField(field) + " }");
+                sb.AppendLine("    if (mask" + group + " & (1u << " + bitPos + ")) { " + GenerateCppWriteField(field, options) + " }");
             }
             sb.AppendLine("}");
             sb.AppendLine();
             sb.AppendLine("void* " + message.Name + "Serializer::read(StreamReader& reader) const {");
             //sb.AppendLine("    auto obj_ptr = std::make_unique<" + message.Name + ">();");
             sb.AppendLine("    std::unique_ptr<" + message.Name + "> obj_ptr(new "+ message.Name + "());");
+            sb.AppendLine("    deserialize_into(reader, *obj_ptr);");
+            sb.AppendLine("    return obj_ptr.release();");
+            sb.AppendLine("}");
+            sb.AppendLine();
+            sb.AppendLine("bool " + message.Name + "Serializer::read_into(StreamReader& reader, void* obj) const {");
+            sb.AppendLine("    deserialize_into(reader, *static_cast<" + message.Name + "*>(obj));");
+            sb.AppendLine("    return true;");
+            sb.AppendLine("}");
+            sb.AppendLine();
+            sb.AppendLine("void " + message.Name + "Serializer::deserialize_into(StreamReader& reader, " + message.Name + "& obj) {");
             for (int g = 0; g < groupCount; g++) sb.AppendLine("    uint32_t mask" + g + " = reader.read_uint32();");
             foreach (var field in message.Fields)
             {
                 int index = field.Id - 1; int group = index / 32; int bitPos = index % 32;
-                sb.AppendLine("    if (mask" + group + " & (1u << " + bitPos + ")) { " + GenerateCppReadField(field) + " }");
+                sb.AppendLine("    if (mask" + group + " & (1u << " + bitPos + ")) { " + GenerateCppReadField(field, options) + " }");
             }
-            sb.AppendLine("    return obj_ptr.release();");
             sb.AppendLine("}");
             sb.AppendLine();
             sb.AppendLine("void " + message.Name + "Serializer::serialize(const " + message.Name + "& obj, StreamWriter& writer) { instance().write(&obj, writer); }");
@@ -386,6 +488,7 @@ namespace BitRPC.Protocol.Generator
             sb.AppendLine();
             var runtimeInclude = GetRuntimeInclude(options);
             sb.AppendLine($"#include \"../runtime/client.h\"");
+            sb.AppendLine($"#include \"../runtime/inprocess_client.h\"");
             sb.AppendLine("#include \"./models.h\"");
             sb.AppendLine("#include <future>");
             sb.AppendLine();
@@ -406,11 +509,16 @@ namespace BitRPC.Protocol.Generator
                 else
                 {
                     sb.AppendLine($"    std::future<{method.ResponseType}> {method.Name}Async(const {method.RequestType}& request);");
+                    sb.AppendLine($"    {method.ResponseType} {method.Name}(const {method.RequestType}& request);");
                 }
             }
 
             sb.AppendLine();
-            sb.AppendLine($"    static std::shared_ptr<{service.Name}Client> create_tcp_client(const std::string& host, int port);");
+            sb.AppendLine($"    static std::shared_ptr<{service.Name}Client> create_tcp_client(const std::string& host, int port,");
+            sb.AppendLine($"                                                                const TransportOptions& options = TransportOptions());");
+            sb.AppendLine($"    // Calls services registered in the same process without sockets");
+            sb.AppendLine($"    static std::shared_ptr<{service.Name}Client> create_in_process_client(ServiceManager& services,");
+            sb.AppendLine($"                                                                       const InProcessOptions& options = InProcessOptions());");
 
             sb.AppendLine("};");
             sb.AppendLine();
@@ -447,13 +555,23 @@ namespace BitRPC.Protocol.Generator
                     sb.AppendLine($"    return call_async<{method.RequestType}, {method.ResponseType}>(\"{service.Name}.{method.Name}\", request);");
                     sb.AppendLine("}");
                     sb.AppendLine();
+                    sb.AppendLine($"{method.ResponseType} {service.Name}Client::{method.Name}(const {method.RequestType}& request) {{");
+                    sb.AppendLine($"    return call<{method.RequestType}, {method.ResponseType}>(\"{service.Name}.{method.Name}\", request);");
+                    sb.AppendLine("}");
+                    sb.AppendLine();
                 }
             }
 
-            sb.AppendLine($"std::shared_ptr<{service.Name}Client> {service.Name}Client::create_tcp_client(const std::string& host, int port) {{");
-            sb.AppendLine($"    auto tcp_client = RpcClientFactory::create_tcp_client(host, port);");
+            sb.AppendLine($"std::shared_ptr<{service.Name}Client> {service.Name}Client::create_tcp_client(const std::string& host, int port,");
+            sb.AppendLine($"                                                                const TransportOptions& options) {{");
+            sb.AppendLine($"    auto tcp_client = RpcClientFactory::create_tcp_client(host, port, options);");
             sb.AppendLine($"    return std::make_shared<{service.Name}Client>(tcp_client);");
             sb.AppendLine("}");
+            sb.AppendLine();
+            sb.AppendLine($"std::shared_ptr<{service.Name}Client> {service.Name}Client::create_in_process_client(ServiceManager& services,");
+            sb.AppendLine($"                                                                       const InProcessOptions& options) {{");
+            sb.AppendLine($"    return std::make_shared<{service.Name}Client>(std::make_shared<InProcessRpcClient>(services, options));");
+            sb.AppendLine("}");
 
             sb.AppendLine("}} // namespace bitrpc");
 
@@ -657,7 +775,14 @@ namespace BitRPC.Protocol.Generator
                     // Register async method that properly handles typed requests and responses
                     sb.AppendLine($"    register_async_method<{requestType}, {responseType}>(\"{method.Name}\", [this](const {method.RequestType}& request) {{");
                     sb.AppendLine($"        return {method.Name}Async_impl(request);");
-                    sb.AppendLine("    });");
+                    if (method.Cacheable)
+                    {
+                        sb.AppendLine($"    }}, CachePolicy::cacheable(std::chrono::milliseconds({method.CacheTtlMs})));");
+                    }
+                    else
+                    {
+                        sb.AppendLine("    });");
+                    }
                 }
             }
 
@@ -813,14 +938,15 @@ namespace BitRPC.Protocol.Generator
             return string.IsNullOrEmpty(ns) ? "generated" : ns.Replace("::", "/").Replace(".", "/");
         }
 
-        private string GetCppType(ProtocolField field)
+        private string GetCppType(ProtocolField field, GenerationOptions options)
         {
             if (field.IsRepeated)
             {
-                return $"std::vector<{GetCppTypeNameForField(field)}>`".Replace("`", string.Empty);
+                var vectorType = UsePmrContainers(options) ? "std::pmr::vector" : "std::vector";
+                return $"{vectorType}<{GetCppTypeNameForField(field, options)}>";
             }
 
-            return GetCppTypeNameForField(field);
+            return GetCppTypeNameForField(field, options);
         }
 
         private string GetCppTypeName(FieldType type)
@@ -839,15 +965,26 @@ namespace BitRPC.Protocol.Generator
             };
         }
 
-        private string GetCppTypeNameForField(ProtocolField field)
+        private string GetCppTypeNameForField(ProtocolField field, GenerationOptions options)
         {
             if (field.Type == FieldType.Struct && !string.IsNullOrEmpty(field.CustomType))
             {
                 return field.CustomType;
             }
+            if (field.Type == FieldType.String && UsePmrContainers(options))
+            {
+                return "std::pmr::string";
+            }
             return GetCppTypeName(field.Type);
         }
 
+        // Fields whose type takes an allocator in pmr mode
+        private bool IsAllocatorAwareField(ProtocolField field)
+        {
+            return field.IsRepeated || field.Type == FieldType.String ||
+                   (field.Type == FieldType.Struct && !string.IsNullOrEmpty(field.CustomType));
+        }
+
         private string GetCppDefaultValue(ProtocolField field)
         {
             if (field.IsRepeated) return "{}";
@@ -870,28 +1007,29 @@ namespace BitRPC.Protocol.Generator
             };
         }
 
-        private string GenerateCppWriteField(ProtocolField field)
+        private string GenerateCppWriteField(ProtocolField field, GenerationOptions options)
         {
             if (field.IsRepeated)
             {
-                var elemType = GetCppTypeNameForField(field);
-                return $"writer.write_vector<{elemType}>(obj_ref.{field.Name}, [&writer](const {elemType}& x) {{ {GenerateCppWriteValueForField(field, "x")}; }});";
+                var elemType = GetCppTypeNameForField(field, options);
+                return $"writer.write_vector_items(obj_ref.{field.Name}, [&writer](const {elemType}& x) {{ {GenerateCppWriteValueForField(field, "x")}; }});";
             }
 
             return $"{GenerateCppWriteValueForField(field, $"obj_ref.{field.Name}")};";
         }
 
-        private string GenerateCppReadField(ProtocolField field)
+        private string GenerateCppReadField(ProtocolField field, GenerationOptions options)
         {
             if (field.IsRepeated)
             {
-                var elemType = GetCppTypeNameForField(field);
-                return $"obj_ptr->{field.Name} = reader.read_vector<{elemType}>([&reader]() {{ return {GenerateCppReadValueForField(field)}; }});";
+                var elemType = GetCppTypeNameForField(field, options);
+                return $"reader.read_vector_into(obj.{field.Name}, [&reader]({elemType}& x) {{ {GenerateCppReadIntoForField(field, "x")}; }});";
             }
 
-            return $"obj_ptr->{field.Name} = {GenerateCppReadValueForField(field)};";
+            return $"{GenerateCppReadIntoForField(field, $"obj.{field.Name}")};";
         }
 
+        // Primitives go straight through StreamWriter/StreamReader (no boxed handler values)
         private string GenerateCppWriteValueForField(ProtocolField field, string value)
         {
             if (field.Type == FieldType.Struct && !string.IsNullOrEmpty(field.CustomType))
@@ -899,21 +1037,39 @@ namespace BitRPC.Protocol.Generator
                 return $"{field.CustomType}Serializer::serialize({value}, writer)";
             }
 
-            // For built-in types, use the singleton handler
-            var handlerName = GetSingletonHandlerForType(field.Type);
-            return $"{handlerName}.write(&{value}, writer)";
+            return field.Type switch
+            {
+                FieldType.Int32 => $"writer.write_int32({value})",
+                FieldType.Int64 => $"writer.write_int64({value})",
+                FieldType.Float => $"writer.write_float({value})",
+                FieldType.Double => $"writer.write_double({value})",
+                FieldType.Bool => $"writer.write_bool({value})",
+                FieldType.String => $"writer.write_string({value})",
+                FieldType.DateTime => $"writer.write_datetime({value})",
+                FieldType.Vector3 => $"writer.write_vector3({value})",
+                _ => throw new NotSupportedException($"Unsupported field type: {field.Type}")
+            };
         }
 
-        private string GenerateCppReadValueForField(ProtocolField field)
+        private string GenerateCppReadIntoForField(ProtocolField field, string target)
         {
             if (field.Type == FieldType.Struct && !string.IsNullOrEmpty(field.CustomType))
             {
-                return $"*{field.CustomType}Serializer::deserialize(reader)";
+                return $"{field.CustomType}Serializer::deserialize_into(reader, {target})";
             }
 
-            // For built-in types, use the singleton handler
-            var handlerName = GetSingletonHandlerForType(field.Type);
-            return $"*static_cast<{GetCppTypeName(field.Type)}*>({handlerName}.read(reader))";
+            return field.Type switch
+            {
+                FieldType.Int32 => $"{target} = reader.read_int32()",
+                FieldType.Int64 => $"{target} = reader.read_int64()",
+                FieldType.Float => $"{target} = reader.read_float()",
+                FieldType.Double => $"{target} = reader.read_double()",
+                FieldType.Bool => $"{target} = reader.read_bool()",
+                FieldType.String => $"reader.read_string_into({target})",
+                FieldType.DateTime => $"{target} = reader.read_datetime()",
+                FieldType.Vector3 => $"{target} = reader.read_vector3()",
+                _ => throw new NotSupportedException($"Unsupported field type: {field.Type}")
+            };
         }
 
         private string GetSingletonHandlerForType(FieldType type)
@@ -964,6 +1120,19 @@ namespace BitRPC.Protocol.Generator
             return ".";
         }
 
+        // Cpp option "UsePmrContainers": generate std::pmr strings/vectors and allocator-aware
+        // messages so request objects can live entirely in a per-call arena
+        private bool UsePmrContainers(GenerationOptions options)
+        {
+            if (options.LanguageSpecificOptions.TryGetValue("Cpp", out var cppOptions) &&
+                cppOptions is Dictionary<string, object> cppDict &&
+                cppDict.TryGetValue("UsePmrContainers", out var valueObj) && valueObj is bool value)
+            {
+                return value;
+            }
+            return false;
+        }
+
         private string GetRuntimeIncludeDirOption(GenerationOptions options)
         {
             if (options.LanguageSpecificOptions.TryGetValue("Cpp", out var cppOptions) &&
@@ -25,6 +25,10 @@ namespace BitRPC.Protocol.Parser
     {
         public string Name { get; set; } = string.Empty;
         public List<ProtocolField> Fields { get; set; } = new List<ProtocolField>();
+        // Annotation after the name, e.g. message UserInfo [fragment_cache] {
+        public Dictionary<string, string> Attributes { get; set; } = new Dictionary<string, string>();
+        // Encoded instances with an identity are cached and spliced into parent messages
+        public bool FragmentCache { get; set; }
     }
 
     public class ProtocolMethod
@@ -34,6 +38,12 @@ namespace BitRPC.Protocol.Parser
         public string ResponseType { get; set; } = string.Empty;
         // Indicates server streaming response (server sends multiple ResponseType items)
         public bool ResponseStream { get; set; }
+        // Trailing annotation, e.g. [cacheable ttl=5s]; flags map to "true"
+        public Dictionary<string, string> Attributes { get; set; } = new Dictionary<string, string>();
+        // Server-side result cache keyed on request bytes
+        public bool Cacheable { get; set; }
+        // Cache entry lifetime in milliseconds; 0 means no expiry
+        public int CacheTtlMs { get; set; }
     }
 
     public class ProtocolService
@@ -112,10 +122,12 @@ namespace BitRPC.Protocol.Parser
         private ProtocolMessage ParseMessage(List<string> lines, ref int currentLine)
         {
             var message = new ProtocolMessage();
-            var match = Regex.Match(lines[currentLine], @"message\s+(\w+)\s*\{");
+            var match = Regex.Match(lines[currentLine], @"message\s+(\w+)\s*(?:\[([^\]]*)\])?\s*\{");
             if (match.Success)
             {
                 message.Name = match.Groups[1].Value;
+                message.Attributes = ParseAttributes(match.Groups[2].Value);
+                message.FragmentCache = message.Attributes.ContainsKey("fragment_cache");
             }
 
             currentLine++;
@@ -206,20 +218,65 @@ namespace BitRPC.Protocol.Parser
         {
             // Support: rpc Method (Request) returns (Response)
             // Server streaming: rpc Method (Request) returns (stream Response)
-            var match = Regex.Match(line, @"rpc\s+(\w+)\s*\((\w+)\)\s+returns\s*\((stream\s+)?(\w+)\)");
+            // Optional annotation: rpc Method (Request) returns (Response) [cacheable ttl=5s]
+            var match = Regex.Match(line, @"rpc\s+(\w+)\s*\((\w+)\)\s+returns\s*\((stream\s+)?(\w+)\)(?:\s*\[([^\]]*)\])?");
             if (match.Success)
             {
-                return new ProtocolMethod
+                var method = new ProtocolMethod
                 {
                     Name = match.Groups[1].Value,
                     RequestType = match.Groups[2].Value,
                     ResponseType = match.Groups[4].Value,
-                    ResponseStream = !string.IsNullOrEmpty(match.Groups[3].Value)
+                    ResponseStream = !string.IsNullOrEmpty(match.Groups[3].Value),
+                    Attributes = ParseAttributes(match.Groups[5].Value)
                 };
+
+                method.Cacheable = method.Attributes.ContainsKey("cacheable");
+                if (method.Attributes.TryGetValue("ttl", out var ttl))
+                {
+                    method.CacheTtlMs = ParseDurationMs(ttl);
+                }
+                return method;
             }
             return null;
         }
 
+        private Dictionary<string, string> ParseAttributes(string text)
+        {
+            var attributes = new Dictionary<string, string>();
+            foreach (var token in text.Split(new[] { ' ', '\t', ',' }, StringSplitOptions.RemoveEmptyEntries))
+            {
+                var eq = token.IndexOf('=');
+                if (eq < 0)
+                {
+                    attributes[token] = "true";
+                }
+                else
+                {
+                    attributes[token.Substring(0, eq)] = token.Substring(eq + 1);
+                }
+            }
+            return attributes;
+        }
+
+        // Durations: "250ms", "5s", "2m", "1h"; a bare number is seconds
+        private int ParseDurationMs(string text)
+        {
+            var match = Regex.Match(text, @"^(\d+)(ms|s|m|h)?$");
+            if (!match.Success)
+            {
+                throw new FormatException($"Invalid duration: {text}");
+            }
+            var value = int.Parse(match.Groups[1].Value);
+            return match.Groups[2].Value switch
+            {
+                "ms" => value,
+                "m" => value * 60 * 1000,
+                "h" => value * 60 * 60 * 1000,
+                _ => value * 1000
+            };
+        }
+
         private void ParseOption(string line, ProtocolDefinition definition)
         {
             var match = Regex.Match(line, @"option\s+(\w+)\s*=\s*[""]([^""]+)[""]");
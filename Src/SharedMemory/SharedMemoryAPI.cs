@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Runtime.InteropServices;
 using System.Text;
 
@@ -26,6 +27,15 @@ namespace BitRPC.SharedMemory
         LastFragment = 0x08
     }
 
+    // RB_CreateProducerEx / RB_CreateConsumerEx / SMM_CreateProducerEx 的标志位
+    [Flags]
+    public enum RingBufferFlags
+    {
+        None = 0,
+        MultiProducer = 0x1,  // 多生产者记录模式；消费者传入时要求缓冲区确实是该模式
+        MirrorMapping = 0x2   // 数据区镜像映射 (仅创建时生效)；bufferSize 须为 2 的幂且是页大小的倍数
+    }
+
     // 消息头结构
     [StructLayout(LayoutKind.Sequential, Pack = 1)]
     public struct MessageHeader
@@ -54,7 +64,8 @@ namespace BitRPC.SharedMemory
         public SharedMemoryMessage()
         {
             MessageId = nextId++;
-            Timestamp = (ulong)DateTimeOffset.UtcNow.ToUnixTimeMilliseconds();
+            // 与 C++ 端一致：单调时钟纳秒 (Linux 上为 CLOCK_MONOTONIC，Windows 上为 QPC)
+            Timestamp = (ulong)(Stopwatch.GetTimestamp() * (1_000_000_000.0 / Stopwatch.Frequency));
             Flags = MessageFlags.None;
         }
 
@@ -153,6 +164,12 @@ namespace BitRPC.SharedMemory
         [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr RB_CreateConsumer(string name, ulong bufferSize);
 
+        [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr RB_CreateProducerEx(string name, ulong bufferSize, int flags);
+
+        [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr RB_CreateConsumerEx(string name, ulong bufferSize, int flags);
+
         [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
         public static extern void RB_Close(IntPtr handle);
 
@@ -175,6 +192,9 @@ namespace BitRPC.SharedMemory
         [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr SMM_CreateProducer(string name, ulong bufferSize);
 
+        [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr SMM_CreateProducerEx(string name, ulong bufferSize, int flags);
+
         [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr SMM_CreateConsumer(string name, ulong bufferSize);
 
@@ -190,6 +210,12 @@ namespace BitRPC.SharedMemory
         [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
         public static extern int SMM_IsRunning(IntPtr handle);
 
+        [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int SMM_SendHeartbeat(IntPtr handle);
+
+        [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int SMM_IsPeerAlive(IntPtr handle);
+
         // 错误处理
         [DllImport(SharedMemoryLib, CallingConvention = CallingConvention.Cdecl)]
         private static extern void RB_SetLastError(string error);
@@ -257,16 +283,20 @@ namespace BitRPC.SharedMemory
     // 共享内存生产者
     public class SharedMemoryProducer : RingBuffer
     {
-        public SharedMemoryProducer(string name, ulong bufferSize = 1024 * 1024)
+        private readonly RingBufferFlags flags;
+
+        // multiProducer: 多个生产者共用一个缓冲区 (由创建方决定，之后打开的生产者沿用)
+        public SharedMemoryProducer(string name, ulong bufferSize = 1024 * 1024, bool multiProducer = false)
             : base(name, bufferSize)
         {
+            flags = multiProducer ? RingBufferFlags.MultiProducer : RingBufferFlags.None;
         }
 
         public bool Connect()
         {
             if (IsConnected) return true;
 
-            handle = NativeMethods.RB_CreateProducer(name, bufferSize);
+            handle = NativeMethods.RB_CreateProducerEx(name, bufferSize, (int)flags);
             return IsConnected;
         }
 
@@ -436,12 +466,14 @@ namespace BitRPC.SharedMemory
         private bool disposed;
         private readonly string name;
         private readonly ulong bufferSize;
+        private readonly bool multiProducer;
         private bool isProducer;
 
-        public SharedMemoryManager(string name, ulong bufferSize = 1024 * 1024)
+        public SharedMemoryManager(string name, ulong bufferSize = 1024 * 1024, bool multiProducer = false)
         {
             this.name = name;
             this.bufferSize = bufferSize;
+            this.multiProducer = multiProducer;
         }
 
         ~SharedMemoryManager()
@@ -472,7 +504,8 @@ namespace BitRPC.SharedMemory
         {
             if (IsRunning) return true;
 
-            handle = NativeMethods.SMM_CreateProducer(name, bufferSize);
+            handle = NativeMethods.SMM_CreateProducerEx(name, bufferSize,
+                (int)(multiProducer ? RingBufferFlags.MultiProducer : RingBufferFlags.None));
             isProducer = true;
             return IsRunning;
         }
@@ -492,6 +525,8 @@ namespace BitRPC.SharedMemory
         }
 
         public bool IsRunning => !disposed && handle != IntPtr.Zero && NativeMethods.SMM_IsRunning(handle) != 0;
+        // 对端进程是否仍然存在 (按缓冲区头部中的 pid 检查)
+        public bool IsPeerAlive => IsRunning && NativeMethods.SMM_IsPeerAlive(handle) != 0;
         public bool IsProducer => isProducer;
         public bool IsConsumer => !isProducer;
 
@@ -531,9 +566,10 @@ namespace BitRPC.SharedMemory
             return message.Deserialize(messageData);
         }
 
+        // 心跳写入缓冲区头部，不经过数据区
         public bool SendHeartbeat()
         {
-            return SendMessage(MessageType.Heartbeat, Array.Empty<byte>());
+            return IsRunning && NativeMethods.SMM_SendHeartbeat(handle) != 0;
         }
 
         public string GetLastError()
@@ -545,9 +581,9 @@ namespace BitRPC.SharedMemory
     // 工厂方法
     public static class SharedMemoryFactory
     {
-        public static SharedMemoryProducer CreateProducer(string name, ulong bufferSize = 1024 * 1024)
+        public static SharedMemoryProducer CreateProducer(string name, ulong bufferSize = 1024 * 1024, bool multiProducer = false)
         {
-            var producer = new SharedMemoryProducer(name, bufferSize);
+            var producer = new SharedMemoryProducer(name, bufferSize, multiProducer);
             return producer.Connect() ? producer : null;
         }
 
@@ -0,0 +1,596 @@
+/*
+ * 跨进程环形缓冲区基准测试
+ * 生产者和消费者运行在 fork 出的两个进程中，测量：
+ *   oneway     - 生产者按固定间隔发送，消费者记录单向延迟
+ *   pingpong   - 两个缓冲区往返，记录往返延迟
+ *   throughput - 生产者全速发送，记录吞吐量和满载下的单向延迟
+ * 覆盖消息大小、缓冲区大小、等待策略的组合，分别测试 RingBuffer 和 SharedMemoryManager。
+ * 延迟用 HDR 直方图统计，结果以 JSON 输出，便于回归比较。
+ *
+ * 用法: ring_benchmark [--quick] [--output=result.json] [--transports=ring,manager]
+ *                      [--modes=oneway,pingpong,throughput] [--sizes=16,1K,64K,1M]
+ *                      [--ring-sizes=64K,1M,16M] [--strategies=adaptive,busy]
+ *                      [--messages=N] [--pingpong-messages=N] [--interval-us=N]
+ */
+
+#include "../latency_histogram.h"
+#include "../ring_buffer.h"
+#include "../shared_memory_manager.h"
+#include "lockfree_queue.h"
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bitrpc::shared_memory;
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// 参数
+// ---------------------------------------------------------------------------
+enum class Transport { RING, MANAGER };
+enum class Mode { ONEWAY, PINGPONG, THROUGHPUT };
+
+struct Options {
+    std::vector<Transport> transports{Transport::RING, Transport::MANAGER};
+    std::vector<Mode> modes{Mode::ONEWAY, Mode::PINGPONG, Mode::THROUGHPUT};
+    std::vector<size_t> sizes{16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576};
+    std::vector<size_t> ring_sizes{64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+    std::vector<WaitStrategy> strategies{WaitStrategy::ADAPTIVE, WaitStrategy::BUSY_POLL};
+    size_t messages{200000};          // oneway/throughput 每组消息数上限
+    size_t pingpong_messages{20000};  // pingpong 每组往返次数上限
+    size_t max_bytes{512u << 20};     // 每组最多传输的字节数，大消息据此减少条数
+    int interval_us{20};              // oneway 发送间隔
+    std::string output;
+};
+
+// 每条消息的前 16 字节：发送时刻 (单调时钟 ns) 和序号
+constexpr size_t MIN_MESSAGE_SIZE = 16;
+constexpr int RUN_TIMEOUT_MS = 30000;
+
+const char* to_string(Transport transport) { return transport == Transport::RING ? "ring" : "manager"; }
+const char* to_string(Mode mode) {
+    return mode == Mode::ONEWAY ? "oneway" : mode == Mode::PINGPONG ? "pingpong" : "throughput";
+}
+const char* to_string(WaitStrategy strategy) { return strategy == WaitStrategy::BUSY_POLL ? "busy" : "adaptive"; }
+
+size_t parse_size(const std::string& text) {
+    char* end = nullptr;
+    size_t value = std::strtoull(text.c_str(), &end, 10);
+    if (end && (*end == 'K' || *end == 'k')) value <<= 10;
+    if (end && (*end == 'M' || *end == 'm')) value <<= 20;
+    return value;
+}
+
+std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string key = arg, value;
+        size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            key = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+        }
+
+        if (key == "--quick") {
+            options.sizes = {64, 4096, 65536};
+            options.ring_sizes = {1024 * 1024};
+            options.messages = 50000;
+            options.pingpong_messages = 5000;
+        } else if (key == "--output") {
+            options.output = value;
+        } else if (key == "--transports") {
+            options.transports.clear();
+            for (auto& item : split(value)) options.transports.push_back(item == "manager" ? Transport::MANAGER : Transport::RING);
+        } else if (key == "--modes") {
+            options.modes.clear();
+            for (auto& item : split(value)) {
+                options.modes.push_back(item == "pingpong" ? Mode::PINGPONG : item == "throughput" ? Mode::THROUGHPUT : Mode::ONEWAY);
+            }
+        } else if (key == "--sizes") {
+            options.sizes.clear();
+            for (auto& item : split(value)) options.sizes.push_back(std::max(parse_size(item), MIN_MESSAGE_SIZE));
+        } else if (key == "--ring-sizes") {
+            options.ring_sizes.clear();
+            for (auto& item : split(value)) options.ring_sizes.push_back(parse_size(item));
+        } else if (key == "--strategies") {
+            options.strategies.clear();
+            for (auto& item : split(value)) options.strategies.push_back(item == "busy" ? WaitStrategy::BUSY_POLL : WaitStrategy::ADAPTIVE);
+        } else if (key == "--messages") {
+            options.messages = parse_size(value);
+        } else if (key == "--pingpong-messages") {
+            options.pingpong_messages = parse_size(value);
+        } else if (key == "--interval-us") {
+            options.interval_us = std::atoi(value.c_str());
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 单组测试
+// ---------------------------------------------------------------------------
+struct Case {
+    Transport transport;
+    Mode mode;
+    size_t message_size;
+    size_t ring_size;
+    WaitStrategy strategy;
+    size_t messages;
+    size_t warmup;
+    int interval_us;
+    std::string ring_a;  // 生产者 -> 消费者
+    std::string ring_b;  // pingpong 回程
+};
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void stamp(uint8_t* data, uint64_t sequence) {
+    uint64_t ts = now_ns();
+    std::memcpy(data, &ts, sizeof(ts));
+    std::memcpy(data + sizeof(ts), &sequence, sizeof(sequence));
+}
+
+uint64_t stamp_of(const uint8_t* data) {
+    uint64_t ts;
+    std::memcpy(&ts, data, sizeof(ts));
+    return ts;
+}
+
+uint64_t sequence_of(const uint8_t* data) {
+    uint64_t sequence;
+    std::memcpy(&sequence, data + sizeof(uint64_t), sizeof(sequence));
+    return sequence;
+}
+
+RingBuffer::Config ring_config(const Case& c, const std::string& name) {
+    RingBuffer::Config config(name);
+    config.buffer_size = c.ring_size;
+    config.record_framing = true;
+    config.wait_strategy = c.strategy;
+    return config;
+}
+
+SharedMemoryManager::Config manager_config(const Case& c, const std::string& name) {
+    SharedMemoryManager::Config config(name);
+    config.buffer_size = c.ring_size;
+    config.max_message_size = c.ring_size / 2 - 64;
+    config.wait_strategy = c.strategy;
+    return config;
+}
+
+void pace(uint64_t& next, int interval_us) {
+    if (interval_us <= 0) {
+        return;
+    }
+    next += uint64_t(interval_us) * 1000;
+    while (now_ns() < next) {
+        bitrpc::detail::cpu_relax();
+    }
+}
+
+// 测量结果，由测量进程写入管道
+struct Measurement {
+    bool ok{false};
+    uint64_t received{0};
+    double seconds{0.0};
+    BasicLatencyHistogram<11> latency;  // 每个 2 的幂区间 1024 个子桶，3 位有效数字
+};
+
+// --- RingBuffer ---
+
+bool ring_producer(const Case& c) {
+    RingBuffer ring(ring_config(c, c.ring_a));
+    if (!ring.create(RingBuffer::CreateMode::OPEN_ONLY)) {
+        return false;
+    }
+
+    std::vector<uint8_t> message(c.message_size, 0x5A);
+    uint64_t next = now_ns();
+    for (uint64_t i = 0; i < c.warmup + c.messages; ++i) {
+        stamp(message.data(), i);
+        while (!ring.write(message.data(), message.size())) {
+            if (!ring.wait_for_space(message.size(), RUN_TIMEOUT_MS)) {
+                return false;
+            }
+        }
+        if (c.mode == Mode::ONEWAY) {
+            pace(next, c.interval_us);
+        }
+    }
+    return true;
+}
+
+bool ring_echo(const Case& c) {
+    RingBuffer in(ring_config(c, c.ring_a)), out(ring_config(c, c.ring_b));
+    if (!in.create(RingBuffer::CreateMode::OPEN_ONLY) || !out.create(RingBuffer::CreateMode::OPEN_ONLY)) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < c.warmup + c.messages; ++i) {
+        ReadView view;
+        while (!in.acquire(view)) {
+            if (!in.wait_for_data(RUN_TIMEOUT_MS)) {
+                return false;
+            }
+        }
+        while (!out.write(view.data, view.size)) {
+            if (!out.wait_for_space(view.size, RUN_TIMEOUT_MS)) {
+                return false;
+            }
+        }
+        in.release(view);
+    }
+    return true;
+}
+
+void ring_measure(const Case& c, Measurement& result) {
+    RingBuffer ring(ring_config(c, c.mode == Mode::PINGPONG ? c.ring_b : c.ring_a));
+    if (!ring.create(RingBuffer::CreateMode::OPEN_ONLY)) {
+        return;
+    }
+
+    if (c.mode == Mode::PINGPONG) {
+        RingBuffer out(ring_config(c, c.ring_a));
+        if (!out.create(RingBuffer::CreateMode::OPEN_ONLY)) {
+            return;
+        }
+        std::vector<uint8_t> message(c.message_size, 0x5A);
+        uint64_t start = 0;
+        for (uint64_t i = 0; i < c.warmup + c.messages; ++i) {
+            if (i == c.warmup) start = now_ns();
+            stamp(message.data(), i);
+            while (!out.write(message.data(), message.size())) {
+                if (!out.wait_for_space(message.size(), RUN_TIMEOUT_MS)) {
+                    return;
+                }
+            }
+            ReadView view;
+            while (!ring.acquire(view)) {
+                if (!ring.wait_for_data(RUN_TIMEOUT_MS)) {
+                    return;
+                }
+            }
+            if (view.size != c.message_size || sequence_of(view.data) != i) {
+                return;
+            }
+            if (i >= c.warmup) result.latency.record(now_ns() - stamp_of(view.data));
+            ring.release(view);
+        }
+        result.seconds = (now_ns() - start) / 1e9;
+        result.received = c.messages;
+        result.ok = true;
+        return;
+    }
+
+    uint64_t expected = 0, start = 0, last = 0;
+    bool in_order = true;
+    while (expected < c.warmup + c.messages && in_order) {
+        if (!ring.wait_for_data(RUN_TIMEOUT_MS)) {
+            return;
+        }
+        ring.consume(64, [&](const uint8_t* data, size_t size) {
+            uint64_t now = now_ns();
+            if (size != c.message_size || sequence_of(data) != expected) {
+                in_order = false;
+                return;
+            }
+            if (expected == c.warmup) start = stamp_of(data);
+            if (expected >= c.warmup) result.latency.record(now - stamp_of(data));
+            last = now;
+            ++expected;
+        });
+    }
+    result.received = expected - std::min<uint64_t>(expected, c.warmup);
+    result.seconds = (last - start) / 1e9;
+    result.ok = in_order;
+}
+
+// --- SharedMemoryManager ---
+// 消费者收到的消息由工作线程交给已注册的处理器，这里在处理器中记录延迟
+
+void wait_until(const std::atomic<uint64_t>& counter, uint64_t target, const std::atomic<bool>& failed) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RUN_TIMEOUT_MS);
+    while (counter.load(std::memory_order_acquire) < target && !failed.load() &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+bool send_blocking(SharedMemoryManager& manager, const std::vector<uint8_t>& message) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RUN_TIMEOUT_MS);
+    while (!manager.send_message(MessageType::DATA, message.data(), message.size())) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+bool manager_producer(const Case& c) {
+    SharedMemoryManager producer(manager_config(c, c.ring_a));
+    if (!producer.start_producer()) {
+        return false;
+    }
+
+    std::vector<uint8_t> message(c.message_size, 0x5A);
+    uint64_t next = now_ns();
+    for (uint64_t i = 0; i < c.warmup + c.messages; ++i) {
+        stamp(message.data(), i);
+        if (!send_blocking(producer, message)) {
+            return false;
+        }
+        if (c.mode == Mode::ONEWAY) {
+            pace(next, c.interval_us);
+        }
+    }
+    return true;
+}
+
+bool manager_echo(const Case& c) {
+    SharedMemoryManager in(manager_config(c, c.ring_a)), out(manager_config(c, c.ring_b));
+    std::atomic<uint64_t> echoed{0};
+    std::atomic<bool> failed{false};
+    std::vector<uint8_t> message;
+    in.register_handler(MessageType::DATA, [&](const SharedMemoryMessage& received, SharedMemoryMessage&) {
+        message.assign(received.get_payload(), received.get_payload() + received.get_payload_size());
+        if (!send_blocking(out, message)) {
+            failed = true;
+        }
+        echoed.fetch_add(1, std::memory_order_release);
+        return true;
+    });
+    if (!out.start_producer() || !in.start_consumer()) {
+        return false;
+    }
+
+    wait_until(echoed, c.warmup + c.messages, failed);
+    return !failed && echoed.load() == c.warmup + c.messages;
+}
+
+void manager_measure(const Case& c, Measurement& result) {
+    std::atomic<uint64_t> expected{0};
+    std::atomic<bool> failed{false};
+    uint64_t start = 0, last = 0;
+
+    SharedMemoryManager consumer(manager_config(c, c.mode == Mode::PINGPONG ? c.ring_b : c.ring_a));
+    consumer.register_handler(MessageType::DATA, [&](const SharedMemoryMessage& message, SharedMemoryMessage&) {
+        uint64_t now = now_ns();
+        uint64_t sequence = expected.load(std::memory_order_relaxed);
+        if (message.get_payload_size() != c.message_size || sequence_of(message.get_payload()) != sequence) {
+            failed = true;
+            return false;
+        }
+        if (sequence == c.warmup && c.mode != Mode::PINGPONG) start = stamp_of(message.get_payload());
+        if (sequence >= c.warmup) result.latency.record(now - stamp_of(message.get_payload()));
+        last = now;
+        expected.store(sequence + 1, std::memory_order_release);
+        return true;
+    });
+
+    if (c.mode == Mode::PINGPONG) {
+        SharedMemoryManager producer(manager_config(c, c.ring_a));
+        if (!producer.start_producer() || !consumer.start_consumer()) {
+            return;
+        }
+        std::vector<uint8_t> message(c.message_size, 0x5A);
+        for (uint64_t i = 0; i < c.warmup + c.messages && !failed; ++i) {
+            if (i == c.warmup) start = now_ns();
+            stamp(message.data(), i);
+            if (!send_blocking(producer, message)) {
+                return;
+            }
+            wait_until(expected, i + 1, failed);
+            if (expected.load() != i + 1) {
+                return;
+            }
+        }
+        consumer.stop();
+        producer.stop();
+    } else {
+        if (!consumer.start_consumer()) {
+            return;
+        }
+        wait_until(expected, c.warmup + c.messages, failed);
+        consumer.stop();
+    }
+
+    result.received = expected.load() - std::min<uint64_t>(expected.load(), c.warmup);
+    result.seconds = (last - start) / 1e9;
+    result.ok = !failed && expected.load() == c.warmup + c.messages;
+}
+
+// ---------------------------------------------------------------------------
+// 进程编排：缓冲区在主进程中创建 (此时还没有任何线程)，测量方和生产方各 fork 一个进程，
+// 测量方把结果写入管道。每组都在新进程中运行，前一组留下的线程不会影响 fork
+// ---------------------------------------------------------------------------
+std::string format_result(const Case& c, const Measurement& m) {
+    std::ostringstream json;
+    json << "{\"transport\":\"" << to_string(c.transport) << "\",\"mode\":\"" << to_string(c.mode)
+         << "\",\"message_size\":" << c.message_size << ",\"ring_size\":" << c.ring_size
+         << ",\"wait_strategy\":\"" << to_string(c.strategy) << "\",\"ok\":" << (m.ok ? "true" : "false")
+         << ",\"messages\":" << m.received;
+    if (c.mode == Mode::ONEWAY) {
+        json << ",\"interval_us\":" << c.interval_us;
+    }
+    if (m.seconds > 0) {
+        double rate = m.received / m.seconds;
+        json << ",\"seconds\":" << m.seconds << ",\"msgs_per_sec\":" << rate
+             << ",\"mb_per_sec\":" << rate * c.message_size / (1024.0 * 1024.0);
+    }
+    auto latency = m.latency.snapshot();
+    json << ",\"latency_ns\":{\"kind\":\"" << (c.mode == Mode::PINGPONG ? "round_trip" : "one_way")
+         << "\",\"count\":" << latency.count << ",\"min\":" << latency.min
+         << ",\"mean\":" << static_cast<uint64_t>(latency.mean())
+         << ",\"p50\":" << latency.percentile(50) << ",\"p90\":" << latency.percentile(90)
+         << ",\"p99\":" << latency.percentile(99) << ",\"p99_9\":" << latency.percentile(99.9)
+         << ",\"p99_99\":" << latency.percentile(99.99) << ",\"max\":" << latency.max << "}}";
+    return json.str();
+}
+
+pid_t spawn(const std::function<bool()>& body) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(body() ? 0 : 1);
+    }
+    return pid;
+}
+
+bool wait_child(pid_t pid, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    int status = 0;
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+std::string run_case(const Case& c) {
+    RingBufferFactory::remove_ring_buffer(c.ring_a);
+    RingBufferFactory::remove_ring_buffer(c.ring_b);
+    RingBuffer ring_a(ring_config(c, c.ring_a)), ring_b(ring_config(c, c.ring_b));
+    if (!ring_a.create() || (c.mode == Mode::PINGPONG && !ring_b.create())) {
+        return format_result(c, Measurement{});
+    }
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return format_result(c, Measurement{});
+    }
+
+    pid_t measurer = spawn([&]() {
+        ::close(fds[0]);
+        Measurement m;
+        if (c.transport == Transport::RING) {
+            ring_measure(c, m);
+        } else {
+            manager_measure(c, m);
+        }
+        std::string json = format_result(c, m);
+        return write(fds[1], json.data(), json.size()) == static_cast<ssize_t>(json.size()) && m.ok;
+    });
+    pid_t producer = spawn([&]() {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        if (c.mode == Mode::PINGPONG) {
+            return c.transport == Transport::RING ? ring_echo(c) : manager_echo(c);
+        }
+        return c.transport == Transport::RING ? ring_producer(c) : manager_producer(c);
+    });
+    ::close(fds[1]);
+
+    std::string json;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        json.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fds[0]);
+
+    wait_child(measurer, RUN_TIMEOUT_MS);
+    wait_child(producer, RUN_TIMEOUT_MS);
+
+    ring_a.close();
+    ring_b.close();
+    RingBufferFactory::remove_ring_buffer(c.ring_a);
+    RingBufferFactory::remove_ring_buffer(c.ring_b);
+    return json.empty() ? format_result(c, Measurement{}) : json;
+}
+
+std::string iso_time() {
+    std::time_t now = std::time(nullptr);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return 2;
+    }
+
+    std::vector<std::string> results;
+    std::string prefix = "bench_" + std::to_string(getpid());
+    for (Transport transport : options.transports) {
+        for (Mode mode : options.modes) {
+            for (size_t ring_size : options.ring_sizes) {
+                for (WaitStrategy strategy : options.strategies) {
+                    for (size_t size : options.sizes) {
+                        // 单条记录最大为容量的一半；SharedMemoryManager 还要加上消息头
+                        size_t overhead = transport == Transport::MANAGER ? sizeof(MessageHeader) + 64 : 8;
+                        if (size + overhead > ring_size / 2) {
+                            continue;
+                        }
+
+                        Case c{transport, mode, size, ring_size, strategy, 0, 0, options.interval_us,
+                               prefix + "_a", prefix + "_b"};
+                        size_t limit = mode == Mode::PINGPONG ? options.pingpong_messages : options.messages;
+                        c.messages = std::max<size_t>(100, std::min(limit, options.max_bytes / size));
+                        c.warmup = std::min<size_t>(1000, c.messages / 10);
+
+                        std::cerr << to_string(transport) << " " << to_string(mode) << " size=" << size
+                                  << " ring=" << ring_size << " " << to_string(strategy) << " ..." << std::flush;
+                        results.push_back(run_case(c));
+                        std::cerr << (results.back().find("\"ok\":true") != std::string::npos ? " ok" : " FAILED")
+                                  << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    std::ostringstream json;
+    json << "{\"benchmark\":\"bitrpc_shared_memory\",\"timestamp\":\"" << iso_time()
+         << "\",\"host\":{\"cpus\":" << std::thread::hardware_concurrency() << ",\"compiler\":\"" << __VERSION__
+         << "\"},\"results\":[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        json << "  " << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "]}\n";
+
+    if (options.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(options.output);
+        file << json.str();
+    }
+    return 0;
+}
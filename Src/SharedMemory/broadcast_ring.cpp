@@ -0,0 +1,511 @@
+#include "broadcast_ring.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include "lockfree_queue.h"
+
+namespace bitrpc {
+namespace shared_memory {
+
+namespace {
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool heartbeat_expired(const BroadcastCursor* cursor, uint64_t now, uint64_t timeout_ns) {
+    uint64_t last = cursor->heartbeat_ns.load(std::memory_order_relaxed);
+    return now > last && now - last > timeout_ns;
+}
+
+// 独占一个游标槽：ACTIVE/FREE -> CLAIMING，并让原持有者失效
+bool lock_cursor(BroadcastCursor* cursor, BroadcastCursorState from) {
+    uint32_t expected = static_cast<uint32_t>(from);
+    if (!cursor->state.compare_exchange_strong(expected, static_cast<uint32_t>(BroadcastCursorState::CLAIMING),
+                                               std::memory_order_acq_rel)) {
+        return false;
+    }
+    cursor->generation.fetch_add(1, std::memory_order_acq_rel);
+    return true;
+}
+
+size_t data_offset(size_t max_consumers) {
+    return sizeof(BroadcastRingHeader) + max_consumers * sizeof(BroadcastCursor);
+}
+
+} // namespace
+
+BroadcastRing::BroadcastRing(const Config& config) : config_(config) {
+}
+
+BroadcastRing::~BroadcastRing() {
+    close();
+}
+
+bool BroadcastRing::create_producer() {
+    if (header_) {
+        return is_producer_;
+    }
+
+    if (config_.buffer_size == 0 || config_.buffer_size % RECORD_ALIGNMENT != 0 || config_.max_consumers == 0) {
+        std::cerr << "BroadcastRing: buffer_size must be a non-zero multiple of " << RECORD_ALIGNMENT
+                  << " and max_consumers must be positive" << std::endl;
+        return false;
+    }
+
+    buffer_size_ = config_.buffer_size;
+    max_consumers_ = config_.max_consumers;
+    if (!map(true)) {
+        close();
+        return false;
+    }
+
+    // 重新初始化已存在的缓冲区时，先让之前的消费者全部失效
+    header_->initialized.store(0, std::memory_order_release);
+    for (size_t i = 0; i < max_consumers_; ++i) {
+        BroadcastCursor* slot = cursor(i);
+        slot->generation.fetch_add(1);
+        slot->read_pos.store(0);
+        slot->heartbeat_ns.store(0);
+        slot->state.store(static_cast<uint32_t>(BroadcastCursorState::FREE));
+    }
+    header_->magic_number = MAGIC_NUMBER;
+    header_->version = VERSION;
+    header_->buffer_size = buffer_size_;
+    header_->max_consumers = static_cast<uint32_t>(max_consumers_);
+    header_->liveness_timeout_ms = static_cast<uint32_t>(std::max(config_.liveness_timeout_ms, 1));
+    header_->claim_pos.store(0);
+    header_->write_pos.store(0);
+    header_->initialized.store(1, std::memory_order_release);
+
+    is_producer_ = true;
+    write_pos_ = 0;
+    cached_min_read_ = 0;
+    return true;
+}
+
+bool BroadcastRing::attach_consumer() {
+    if (is_producer_) {
+        return false;
+    }
+    if (cursor_ && owns_cursor()) {
+        return true;
+    }
+
+    if (!header_) {
+        if (!map(false)) {
+            close();
+            return false;
+        }
+        if (header_->magic_number != MAGIC_NUMBER || header_->version != VERSION ||
+            header_->initialized.load(std::memory_order_acquire) != 1) {
+            close();
+            return false;
+        }
+        buffer_size_ = header_->buffer_size;
+        max_consumers_ = header_->max_consumers;
+#ifndef _WIN32
+        if (mapped_size_ < data_offset(max_consumers_) + buffer_size_) {
+            close();
+            return false;
+        }
+#endif
+        buffer_ = static_cast<uint8_t*>(mapped_memory_) + data_offset(max_consumers_);
+    }
+
+    // 先找空闲槽，没有时回收心跳已超时的槽
+    uint64_t timeout_ns = uint64_t(header_->liveness_timeout_ms) * 1000000;
+    for (int pass = 0; pass < 2; ++pass) {
+        uint64_t now = now_ns();
+        for (size_t i = 0; i < max_consumers_; ++i) {
+            BroadcastCursor* slot = cursor(i);
+            bool locked = pass == 0 ? lock_cursor(slot, BroadcastCursorState::FREE)
+                                    : heartbeat_expired(slot, now, timeout_ns) &&
+                                      lock_cursor(slot, BroadcastCursorState::ACTIVE);
+            if (!locked) {
+                continue;
+            }
+
+            // 从当前写位置开始读取。槽处于 CLAIMING 时 scan_cursors 会跳过它，缓存的最小读位置可能已超过
+            // 这里读到的写位置，所以发布 ACTIVE 后要再读一次写位置：与 scan_cursors 开头的 seq_cst fence 配对，
+            // 没看到 ACTIVE 的扫描所基于的写位置一定不大于第二次读到的值，生产者不会越过本游标写入
+            generation_ = slot->generation.load(std::memory_order_relaxed);
+            read_pos_ = header_->write_pos.load(std::memory_order_acquire);
+            slot->read_pos.store(read_pos_, std::memory_order_relaxed);
+            slot->heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+            slot->state.store(static_cast<uint32_t>(BroadcastCursorState::ACTIVE), std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            read_pos_ = header_->write_pos.load(std::memory_order_acquire);
+            slot->read_pos.store(read_pos_, std::memory_order_release);
+            cursor_ = slot;
+            evicted_ = false;
+            return true;
+        }
+    }
+
+    std::cerr << "BroadcastRing: no free consumer slot in " << config_.name << std::endl;
+    return false;
+}
+
+void BroadcastRing::close() {
+    // 消费者主动离开时归还游标槽
+    if (cursor_ && owns_cursor() && lock_cursor(cursor_, BroadcastCursorState::ACTIVE)) {
+        cursor_->state.store(static_cast<uint32_t>(BroadcastCursorState::FREE), std::memory_order_release);
+    }
+
+    if (mapped_memory_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapped_memory_);
+#else
+        munmap(mapped_memory_, mapped_size_);
+#endif
+        mapped_memory_ = nullptr;
+    }
+#ifdef _WIN32
+    if (file_mapping_ != nullptr) {
+        CloseHandle(file_mapping_);
+        file_mapping_ = nullptr;
+    }
+#else
+    if (file_descriptor_ != -1) {
+        ::close(file_descriptor_);
+        file_descriptor_ = -1;
+    }
+#endif
+
+    header_ = nullptr;
+    buffer_ = nullptr;
+    cursor_ = nullptr;
+    is_producer_ = false;
+    evicted_ = false;
+}
+
+bool BroadcastRing::publish(const void* data, size_t size) {
+    if (!is_producer_ || (data == nullptr && size > 0) || size > get_max_record_size()) {
+        return false;
+    }
+
+    uint64_t end = publish_end(size);
+    if (!has_space(end)) {
+        return false;
+    }
+
+    // 先发布要写到的位置再写数据：落后的消费者读完后比较 claim_pos 就能发现数据被覆盖
+    header_->claim_pos.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t span = record_span(size);
+    if (end - write_pos_ > span) {
+        RecordHeader* padding = record_at(write_pos_);
+        padding->length = PADDING_LENGTH;
+        padding->span.store(static_cast<uint32_t>(end - span - write_pos_), std::memory_order_relaxed);
+    }
+    RecordHeader* record = record_at(end - span);
+    record->length = static_cast<uint32_t>(size);
+    record->span.store(static_cast<uint32_t>(span), std::memory_order_relaxed);
+    if (size > 0) {
+        std::memcpy(reinterpret_cast<uint8_t*>(record) + sizeof(RecordHeader), data, size);
+    }
+
+    write_pos_ = end;
+    header_->write_pos.store(end, std::memory_order_release);
+    wake_wait_word(header_->data_ready);
+    return true;
+}
+
+bool BroadcastRing::wait_for_space(size_t size, int timeout_ms) {
+    if (!is_producer_ || size > get_max_record_size()) {
+        return false;
+    }
+
+    auto ready = [this, size]() { return has_space(publish_end(size)); };
+    for (int spin = 0; spin < config_.spin_iterations; ++spin) {
+        if (ready()) {
+            return true;
+        }
+        detail::cpu_relax();
+    }
+
+    // 死掉的消费者不会唤醒生产者：最多休眠半个心跳超时，醒来重新扫描游标 (会剔除超时的消费者)
+    const int64_t liveness_ns = int64_t(header_->liveness_timeout_ms) * 1000000 / 2;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+    RingBufferWaitWord& word = header_->space_available;
+    for (;;) {
+        int64_t park_ns = liveness_ns;
+        if (timeout_ms >= 0) {
+            int64_t remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return ready();
+            }
+            park_ns = std::min(park_ns, remaining);
+        }
+
+        uint32_t sequence = word.sequence.load(std::memory_order_acquire);
+        word.waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready()) {
+            word.waiters.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        park_on_wait_word(word, sequence, park_ns);
+        word.waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (ready()) {
+            return true;
+        }
+    }
+}
+
+bool BroadcastRing::read(void* buffer, size_t buffer_size, size_t& bytes_read) {
+    bytes_read = 0;
+    if (!cursor_ || evicted_ || buffer == nullptr) {
+        return false;
+    }
+    if (!owns_cursor()) {
+        evicted_ = true;
+        return false;
+    }
+
+    uint64_t write_pos = header_->write_pos.load(std::memory_order_acquire);
+    uint64_t pos = read_pos_;
+    while (pos != write_pos) {
+        const RecordHeader* record = record_at(pos);
+        uint32_t length = record->length;
+        uint32_t span = record->span.load(std::memory_order_relaxed);
+
+        // 记录头可能已被下一圈覆盖，先确认没有被套圈再使用其中的长度
+        if (length == PADDING_LENGTH || length > get_max_record_size()) {
+            if (lapped(pos)) {
+                evicted_ = true;
+                return false;
+            }
+            pos += span;
+            continue;
+        }
+        if (length > buffer_size) {
+            return false;
+        }
+
+        std::memcpy(buffer, reinterpret_cast<const uint8_t*>(record) + sizeof(RecordHeader), length);
+        if (lapped(pos)) {
+            evicted_ = true;
+            return false;
+        }
+        bytes_read = length;
+        pos += span;
+        break;
+    }
+
+    if (pos != read_pos_) {
+        read_pos_ = pos;
+        cursor_->read_pos.store(pos, std::memory_order_release);
+        wake_wait_word(header_->space_available);
+    }
+    cursor_->heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+    return true;
+}
+
+bool BroadcastRing::wait_for_data(int timeout_ms) {
+    if (!cursor_ || evicted_) {
+        return false;
+    }
+
+    for (int spin = 0; spin < config_.spin_iterations; ++spin) {
+        if (has_data()) {
+            return true;
+        }
+        detail::cpu_relax();
+    }
+
+    // 最多休眠半个心跳超时，醒来刷新心跳，空闲的消费者不会被当作已死亡
+    const int64_t liveness_ns = int64_t(header_->liveness_timeout_ms) * 1000000 / 2;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+    RingBufferWaitWord& word = header_->data_ready;
+    for (;;) {
+        if (!owns_cursor()) {
+            evicted_ = true;
+            return false;
+        }
+        heartbeat();
+
+        int64_t park_ns = liveness_ns;
+        if (timeout_ms >= 0) {
+            int64_t remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return has_data();
+            }
+            park_ns = std::min(park_ns, remaining);
+        }
+
+        uint32_t sequence = word.sequence.load(std::memory_order_acquire);
+        word.waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (has_data()) {
+            word.waiters.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        park_on_wait_word(word, sequence, park_ns);
+        word.waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (has_data()) {
+            return true;
+        }
+    }
+}
+
+void BroadcastRing::heartbeat() {
+    if (cursor_ && !evicted_) {
+        cursor_->heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+    }
+}
+
+size_t BroadcastRing::get_active_consumers() const {
+    size_t count = 0;
+    for (size_t i = 0; header_ && i < max_consumers_; ++i) {
+        if (cursor(i)->state.load(std::memory_order_acquire) == static_cast<uint32_t>(BroadcastCursorState::ACTIVE)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+size_t BroadcastRing::get_max_record_size() const {
+    // 一条记录加上回绕填充不超过容量
+    size_t half = (buffer_size_ / 2) & ~(RECORD_ALIGNMENT - 1);
+    return half > sizeof(RecordHeader) ? half - sizeof(RecordHeader) : 0;
+}
+
+bool BroadcastRing::remove(const std::string& name) {
+#ifdef _WIN32
+    (void)name;
+    return true;
+#else
+    std::string shm_name = "/BitRPC_Broadcast_" + name;
+    return shm_unlink(shm_name.c_str()) == 0;
+#endif
+}
+
+bool BroadcastRing::map(bool create) {
+#ifdef _WIN32
+    std::string mapping_name = "Local\\BitRPC_Broadcast_" + config_.name;
+    if (create) {
+        mapped_size_ = data_offset(max_consumers_) + buffer_size_;
+        file_mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                           static_cast<DWORD>(uint64_t(mapped_size_) >> 32),
+                                           static_cast<DWORD>(mapped_size_), mapping_name.c_str());
+    } else {
+        file_mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mapping_name.c_str());
+    }
+    if (file_mapping_ == nullptr) {
+        return false;
+    }
+    // 打开时映射整个对象，布局从头部读取
+    mapped_memory_ = MapViewOfFile(file_mapping_, FILE_MAP_ALL_ACCESS, 0, 0, create ? mapped_size_ : 0);
+    if (mapped_memory_ == nullptr) {
+        return false;
+    }
+#else
+    std::string shm_name = "/BitRPC_Broadcast_" + config_.name;
+    file_descriptor_ = shm_open(shm_name.c_str(), (create ? O_CREAT : 0) | O_RDWR, 0666);
+    if (file_descriptor_ == -1) {
+        return false;
+    }
+
+    if (create) {
+        mapped_size_ = data_offset(max_consumers_) + buffer_size_;
+        if (ftruncate(file_descriptor_, static_cast<off_t>(mapped_size_)) == -1) {
+            return false;
+        }
+    } else {
+        struct stat st;
+        if (fstat(file_descriptor_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(BroadcastRingHeader)) {
+            return false;
+        }
+        mapped_size_ = static_cast<size_t>(st.st_size);
+    }
+
+    mapped_memory_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor_, 0);
+    if (mapped_memory_ == MAP_FAILED) {
+        mapped_memory_ = nullptr;
+        return false;
+    }
+#endif
+
+    header_ = static_cast<BroadcastRingHeader*>(mapped_memory_);
+    if (create) {
+        buffer_ = static_cast<uint8_t*>(mapped_memory_) + data_offset(max_consumers_);
+    }
+    return true;
+}
+
+BroadcastCursor* BroadcastRing::cursor(size_t index) const {
+    auto* base = reinterpret_cast<uint8_t*>(header_) + sizeof(BroadcastRingHeader);
+    return reinterpret_cast<BroadcastCursor*>(base) + index;
+}
+
+RecordHeader* BroadcastRing::record_at(uint64_t pos) const {
+    return reinterpret_cast<RecordHeader*>(buffer_ + pos % buffer_size_);
+}
+
+uint64_t BroadcastRing::record_span(size_t size) const {
+    return (sizeof(RecordHeader) + size + RECORD_ALIGNMENT - 1) & ~uint64_t(RECORD_ALIGNMENT - 1);
+}
+
+uint64_t BroadcastRing::publish_end(size_t size) const {
+    // 记录不跨越缓冲区末尾，放不下时先写一条填充记录
+    uint64_t span = record_span(size);
+    uint64_t to_end = buffer_size_ - write_pos_ % buffer_size_;
+    return write_pos_ + (span > to_end ? to_end : 0) + span;
+}
+
+bool BroadcastRing::has_space(uint64_t end) {
+    if (end - cached_min_read_ <= buffer_size_) {
+        return true;
+    }
+    scan_cursors(end);
+    return end - cached_min_read_ <= buffer_size_;
+}
+
+// 重新计算活跃消费者的最小读位置。拖住生产者 (写到 end 会覆盖它未读的数据) 且心跳超时的消费者被剔除；
+// 没有活跃消费者时不受限制
+uint64_t BroadcastRing::scan_cursors(uint64_t end) {
+    // write_pos 已在上一次 publish 中存储；与 attach_consumer 发布 ACTIVE 后的 fence 配对
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t now = now_ns();
+    uint64_t timeout_ns = uint64_t(header_->liveness_timeout_ms) * 1000000;
+    uint64_t min_read = write_pos_;
+    for (size_t i = 0; i < max_consumers_; ++i) {
+        BroadcastCursor* slot = cursor(i);
+        if (slot->state.load(std::memory_order_acquire) != static_cast<uint32_t>(BroadcastCursorState::ACTIVE)) {
+            continue;
+        }
+        uint64_t read_pos = std::min(slot->read_pos.load(std::memory_order_acquire), write_pos_);
+        if (end - read_pos > buffer_size_ && heartbeat_expired(slot, now, timeout_ns) &&
+            lock_cursor(slot, BroadcastCursorState::ACTIVE)) {
+            slot->state.store(static_cast<uint32_t>(BroadcastCursorState::FREE), std::memory_order_release);
+            continue;
+        }
+        min_read = std::min(min_read, read_pos);
+    }
+    cached_min_read_ = min_read;
+    return min_read;
+}
+
+bool BroadcastRing::has_data() const {
+    return header_->write_pos.load(std::memory_order_acquire) != read_pos_;
+}
+
+bool BroadcastRing::owns_cursor() const {
+    return cursor_->generation.load(std::memory_order_acquire) == generation_ &&
+           cursor_->state.load(std::memory_order_acquire) == static_cast<uint32_t>(BroadcastCursorState::ACTIVE);
+}
+
+// 与 publish 中 claim_pos 之后的 release fence 配对：读到的数据若来自下一圈的写入，这里一定能看到更大的 claim_pos
+bool BroadcastRing::lapped(uint64_t pos) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header_->claim_pos.load(std::memory_order_relaxed) - pos > buffer_size_;
+}
+
+} // namespace shared_memory
+} // namespace bitrpc
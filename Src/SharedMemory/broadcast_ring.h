@@ -0,0 +1,134 @@
+#pragma once
+
+#include "ring_buffer.h"
+
+namespace bitrpc {
+namespace shared_memory {
+
+// 广播环形缓冲区：一个生产者、多个消费者，每个消费者在头部有自己的读游标，
+// 每条记录都会被每个活跃的消费者读到，生产者只写一次。
+// 生产者的可用空间受最慢的活跃消费者限制；心跳超时且拖住生产者的消费者会被剔除。
+// 生产者平时只比较本地缓存的最小读位置，看起来已满时才扫描游标槽，开销与消费者数量无关
+
+// 游标槽状态
+enum class BroadcastCursorState : uint32_t {
+    FREE = 0,
+    CLAIMING = 1,  // 消费者正在认领，生产者忽略
+    ACTIVE = 2
+};
+
+// 消费者游标槽，每个槽独占缓存行，只由所属消费者写入 (剔除时由生产者改写状态)
+struct BroadcastCursor {
+    alignas(RING_BUFFER_CACHE_LINE) std::atomic<uint64_t> read_pos{0};
+    std::atomic<uint64_t> heartbeat_ns{0};  // 单调时钟，读取和等待时刷新
+    std::atomic<uint32_t> state{0};         // BroadcastCursorState
+    std::atomic<uint32_t> generation{0};    // 每次认领/剔除加一，消费者据此发现自己被剔除
+};
+
+// 广播缓冲区头部，后面依次是 max_consumers 个游标槽和数据区
+struct BroadcastRingHeader {
+    alignas(RING_BUFFER_CACHE_LINE) uint32_t magic_number{0};
+    uint32_t version{0};
+    uint64_t buffer_size{0};
+    uint32_t max_consumers{0};
+    uint32_t liveness_timeout_ms{0};
+    std::atomic<uint32_t> initialized{0};
+    RingBufferWaitWord data_ready;
+    RingBufferWaitWord space_available;
+    alignas(RING_BUFFER_CACHE_LINE) std::atomic<uint64_t> write_pos{0};  // 已发布的写位置
+    // 生产者即将写到的位置，在写入数据之前发布；消费者读完后据此判断数据是否已被覆盖
+    std::atomic<uint64_t> claim_pos{0};
+};
+
+class BroadcastRing {
+public:
+    struct Config {
+        size_t buffer_size{1024 * 1024};  // 须为 8 的倍数；消费者以头部为准
+        size_t max_consumers{8};          // 游标槽数量
+        int liveness_timeout_ms{1000};    // 消费者心跳超过这么久未刷新即可被剔除
+        int spin_iterations{2048};        // 等待前的自旋次数
+        std::string name;
+
+        Config(const std::string& ring_name = "BitRPC_Broadcast")
+            : name(ring_name) {}
+    };
+
+    explicit BroadcastRing(const Config& config = Config{});
+    ~BroadcastRing();
+
+    // 禁用拷贝
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // 生产者：创建缓冲区，已存在时重新初始化 (之前的消费者都会被剔除)
+    bool create_producer();
+    // 消费者：打开已存在的缓冲区并认领一个游标槽，从当前写位置开始读取。
+    // 没有空闲槽时会回收心跳已超时的槽
+    bool attach_consumer();
+    void close();
+
+    // 生产者：写入一条记录；最慢的活跃消费者尚未腾出空间时返回 false
+    bool publish(const void* data, size_t size);
+    bool wait_for_space(size_t size, int timeout_ms = -1);
+
+    // 消费者：读取下一条记录，没有新记录时返回 true 且 bytes_read 为 0。
+    // 被剔除或落后太多、记录已被覆盖时返回 false，is_evicted() 为 true，需要重新 attach_consumer
+    bool read(void* buffer, size_t buffer_size, size_t& bytes_read);
+    bool wait_for_data(int timeout_ms = -1);
+    void heartbeat();  // 长时间不读取时保持存活
+    bool is_evicted() const { return evicted_; }
+
+    // 状态查询
+    bool is_connected() const { return header_ != nullptr; }
+    bool is_producer() const { return is_producer_; }
+    size_t get_active_consumers() const;
+    size_t get_capacity() const { return buffer_size_; }
+    size_t get_max_record_size() const;
+    std::string get_name() const { return config_.name; }
+
+    static bool remove(const std::string& name);
+
+private:
+    bool map(bool create);
+    BroadcastCursor* cursor(size_t index) const;
+    RecordHeader* record_at(uint64_t pos) const;
+    uint64_t record_span(size_t size) const;
+    uint64_t publish_end(size_t size) const;
+    bool has_space(uint64_t end);
+    uint64_t scan_cursors(uint64_t end);
+    bool has_data() const;
+    bool owns_cursor() const;
+    bool lapped(uint64_t pos) const;
+
+    Config config_;
+    BroadcastRingHeader* header_{nullptr};
+    uint8_t* buffer_{nullptr};
+    size_t buffer_size_{0};
+    size_t max_consumers_{0};
+    void* mapped_memory_{nullptr};
+    size_t mapped_size_{0};
+#ifdef _WIN32
+    HANDLE file_mapping_{nullptr};
+#else
+    int file_descriptor_{-1};
+#endif
+
+    // 生产者
+    bool is_producer_{false};
+    uint64_t write_pos_{0};
+    uint64_t cached_min_read_{0};
+
+    // 消费者
+    BroadcastCursor* cursor_{nullptr};
+    uint32_t generation_{0};
+    uint64_t read_pos_{0};
+    bool evicted_{false};
+
+    static constexpr uint32_t MAGIC_NUMBER = 0x42524243;  // "BRBC"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t RECORD_ALIGNMENT = 8;
+    static constexpr uint32_t PADDING_LENGTH = 0xFFFFFFFF;
+};
+
+} // namespace shared_memory
+} // namespace bitrpc
@@ -56,17 +56,31 @@ echo.
 echo # 源文件
 echo set^(SOURCES
 echo     "%SCRIPT_DIR%\ring_buffer.cpp"
+echo     "%SCRIPT_DIR%\broadcast_ring.cpp"
+echo     "%SCRIPT_DIR%\slab_pool.cpp"
 echo     "%SCRIPT_DIR%\shared_memory_manager.cpp"
 echo     "%SCRIPT_DIR%\shared_memory_api.cpp"
+echo     "%SCRIPT_DIR%\ring_stream_writer.cpp"
+echo     "%PROJECT_ROOT%\Src\C++Core\timer_wheel.cpp"
+echo     "%PROJECT_ROOT%\Src\C++Core\serialization.cpp"
 echo ^)
 echo.
 echo # 头文件
 echo set^(HEADERS
 echo     "%SCRIPT_DIR%\ring_buffer.h"
+echo     "%SCRIPT_DIR%\broadcast_ring.h"
+echo     "%SCRIPT_DIR%\slab_pool.h"
+echo     "%SCRIPT_DIR%\latency_histogram.h"
 echo     "%SCRIPT_DIR%\shared_memory_manager.h"
 echo     "%SCRIPT_DIR%\shared_memory_api.h"
+echo     "%SCRIPT_DIR%\ring_stream_writer.h"
+echo     "%PROJECT_ROOT%\Src\C++Core\timer_wheel.h"
+echo     "%PROJECT_ROOT%\Src\C++Core\serialization.h"
 echo ^)
 echo.
+echo # 心跳定时器使用 C++Core 的时间轮，RingStreamWriter 使用 C++Core 的 StreamWriter
+echo include_directories^("%PROJECT_ROOT%\Src\C++Core"^)
+echo.
 echo # 编译选项
 echo add_compile_options^(/W4^)
 echo.
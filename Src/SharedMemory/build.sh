@@ -52,17 +52,31 @@ set(CMAKE_CXX_STANDARD_REQUIRED ON)
 # 源文件
 set(SOURCES
     "$SCRIPT_DIR/ring_buffer.cpp"
+    "$SCRIPT_DIR/broadcast_ring.cpp"
+    "$SCRIPT_DIR/slab_pool.cpp"
     "$SCRIPT_DIR/shared_memory_manager.cpp"
     "$SCRIPT_DIR/shared_memory_api.cpp"
+    "$SCRIPT_DIR/ring_stream_writer.cpp"
+    "$PROJECT_ROOT/Src/C++Core/timer_wheel.cpp"
+    "$PROJECT_ROOT/Src/C++Core/serialization.cpp"
 )
 
 # 头文件
 set(HEADERS
     "$SCRIPT_DIR/ring_buffer.h"
+    "$SCRIPT_DIR/broadcast_ring.h"
+    "$SCRIPT_DIR/slab_pool.h"
+    "$SCRIPT_DIR/latency_histogram.h"
     "$SCRIPT_DIR/shared_memory_manager.h"
     "$SCRIPT_DIR/shared_memory_api.h"
+    "$SCRIPT_DIR/ring_stream_writer.h"
+    "$PROJECT_ROOT/Src/C++Core/timer_wheel.h"
+    "$PROJECT_ROOT/Src/C++Core/serialization.h"
 )
 
+# 心跳定时器使用 C++Core 的时间轮，RingStreamWriter 使用 C++Core 的 StreamWriter
+include_directories("$PROJECT_ROOT/Src/C++Core")
+
 # 编译选项
 if(MSVC)
     add_compile_options(/W4)
@@ -84,6 +98,13 @@ if(UNIX)
     target_link_libraries(\${PROJECT_NAME} pthread rt)
 endif()
 
+# 基准测试 (fork 出生产者/消费者进程，仅 Unix)
+if(UNIX)
+    add_executable(ring_benchmark "$SCRIPT_DIR/benchmarks/ring_benchmark.cpp")
+    target_link_libraries(ring_benchmark \${PROJECT_NAME})
+    install(TARGETS ring_benchmark RUNTIME DESTINATION bin)
+endif()
+
 # 安装规则
 install(TARGETS \${PROJECT_NAME}
         LIBRARY DESTINATION lib
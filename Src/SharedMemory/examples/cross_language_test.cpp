@@ -101,7 +101,7 @@ private:
                               << ", value=" << data.value << std::endl;
                 }
 
-                // 发送心跳
+                // 发送心跳 (写入缓冲区头部，管理器也会按 heartbeat_interval_ms 自动发送)
                 if (counter % 10 == 0) {
                     producer_->send_heartbeat();
                     std::cout << "Sent heartbeat" << std::endl;
@@ -164,12 +164,6 @@ public:
                 return true;
             });
 
-        consumer_->register_handler(MessageType::HEARTBEAT,
-            [this](const SharedMemoryMessage& msg) -> bool {
-                std::cout << "Received heartbeat from producer" << std::endl;
-                return true;
-            });
-
         std::cout << "✓ C++ Consumer connected to shared memory: " << name_ << std::endl;
         running_ = true;
 
@@ -200,6 +194,7 @@ public:
 
 private:
     void receive_loop() {
+        bool producer_seen = false;
         while (running_) {
             try {
                 // 尝试接收消息
@@ -223,6 +218,13 @@ private:
                     continue;
                 }
 
+                // 没有数据时检查生产者是否还在 (心跳和 pid 在缓冲区头部，不经过消息)
+                bool producer_alive = consumer_->is_producer_alive();
+                if (producer_alive != producer_seen) {
+                    std::cout << (producer_alive ? "Producer is alive" : "Producer has exited") << std::endl;
+                    producer_seen = producer_alive;
+                }
+
                 // 如果没有数据，短暂休眠
                 std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace bitrpc {
+namespace shared_memory {
+
+// 无锁延迟直方图：HDR 风格的对数-线性分桶，每个 2 的幂区间分成 2^(SubBucketBits-1) 个子桶，
+// 最大相对误差为其倒数。record 只有几次 relaxed 原子操作，收发热路径上任意线程都可以调用；
+// snapshot 复制出一份普通数据再计算分位数，与并发的 record 之间不保证严格一致
+template<int SubBucketBits>
+class BasicLatencyHistogram {
+public:
+    struct Snapshot {
+        std::vector<uint64_t> counts;
+        uint64_t count{0};
+        uint64_t sum{0};
+        uint64_t min{0};
+        uint64_t max{0};
+
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+        // p 取 0-100，返回落在该分位的桶的最大等价值
+        uint64_t percentile(double p) const {
+            if (count == 0) {
+                return 0;
+            }
+            uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(p / 100.0 * count + 0.5));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= target) {
+                    return std::min(highest_equivalent(i), max);
+                }
+            }
+            return max;
+        }
+    };
+
+    BasicLatencyHistogram() : counts_(new std::atomic<uint64_t>[COUNTS_SIZE]) { reset(); }
+
+    BasicLatencyHistogram(const BasicLatencyHistogram&) = delete;
+    BasicLatencyHistogram& operator=(const BasicLatencyHistogram&) = delete;
+
+    void record(uint64_t value) {
+        value = std::min<uint64_t>(value, INT64_MAX);
+        counts_[index_of(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current = min_.load(std::memory_order_relaxed);
+        while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+        current = max_.load(std::memory_order_relaxed);
+        while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    Snapshot snapshot() const {
+        Snapshot result;
+        result.counts.resize(COUNTS_SIZE);
+        for (size_t i = 0; i < COUNTS_SIZE; ++i) {
+            result.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            result.count += result.counts[i];
+        }
+        result.sum = sum_.load(std::memory_order_relaxed);
+        result.min = result.count ? min_.load(std::memory_order_relaxed) : 0;
+        result.max = max_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void reset() {
+        for (size_t i = 0; i < COUNTS_SIZE; ++i) {
+            counts_[i].store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static_assert(SubBucketBits >= 2 && SubBucketBits < 32, "unsupported histogram precision");
+    static constexpr int SUB_BUCKET_BITS = SubBucketBits;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr int BUCKET_COUNT = 64 - SUB_BUCKET_BITS;
+    static constexpr size_t COUNTS_SIZE = (BUCKET_COUNT + 1) * SUB_BUCKET_HALF;
+
+    static int bit_length(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index) + 1;
+#else
+        return 64 - __builtin_clzll(value);
+#endif
+    }
+
+    static size_t index_of(uint64_t value) {
+        int bucket = bit_length(value | (SUB_BUCKET_COUNT - 1)) - SUB_BUCKET_BITS;
+        uint64_t sub = value >> bucket;
+        return static_cast<size_t>((bucket + 1) * SUB_BUCKET_HALF + sub - SUB_BUCKET_HALF);
+    }
+
+    static uint64_t highest_equivalent(size_t index) {
+        int64_t bucket = static_cast<int64_t>(index / SUB_BUCKET_HALF) - 1;
+        uint64_t sub = index % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+        if (bucket < 0) {
+            bucket = 0;
+            sub -= SUB_BUCKET_HALF;
+        }
+        return ((sub + 1) << bucket) - 1;
+    }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+// 统计用：每个 2 的幂区间 32 个子桶，最大相对误差约 3%
+using LatencyHistogram = BasicLatencyHistogram<6>;
+
+} // namespace shared_memory
+} // namespace bitrpc
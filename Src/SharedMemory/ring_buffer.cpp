@@ -3,11 +3,27 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+
+#include <cerrno>
+#include <climits>
+#include <vector>
+#include "lockfree_queue.h"
 
 #ifdef _WIN32
 #include <io.h>
 #else
 #include <sys/syscall.h>
+#include <signal.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <linux/magic.h>
+#include <linux/mempolicy.h>
+#include <sys/vfs.h>
+#include <pthread.h>
+#include <sched.h>
 #endif
 
 namespace bitrpc {
@@ -73,13 +89,23 @@ public:
             return sem_wait(semaphore_) == 0;
         }
 
+        // 优先按单调时钟计算超时，系统时间被调整时不受影响
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+        const clockid_t clock = CLOCK_MONOTONIC;
+#else
+        const clockid_t clock = CLOCK_REALTIME;
+#endif
         struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
+        clock_gettime(clock, &ts);
         ts.tv_nsec += (timeout_ms % 1000) * 1000000;
         ts.tv_sec += timeout_ms / 1000 + ts.tv_nsec / 1000000000;
         ts.tv_nsec %= 1000000000;
 
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+        return sem_clockwait(semaphore_, clock, &ts) == 0;
+#else
         return sem_timedwait(semaphore_, &ts) == 0;
+#endif
     }
 
     bool reset() override {
@@ -104,6 +130,64 @@ private:
 };
 #endif
 
+namespace {
+
+size_t system_page_size() {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwPageSize;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+bool is_power_of_two(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint32_t current_process_id() {
+#ifdef _WIN32
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+bool process_exists(uint32_t pid) {
+#ifdef _WIN32
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (process == nullptr) {
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    }
+    DWORD exit_code = 0;
+    bool running = GetExitCodeProcess(process, &exit_code) && exit_code == STILL_ACTIVE;
+    CloseHandle(process);
+    return running;
+#else
+    // 信号 0 只检查进程是否存在；EPERM 表示进程存在但属于其他用户
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+#ifdef __linux__
+// 共享映射上的 futex 不能用 FUTEX_PRIVATE_FLAG，其他进程也在同一个字上等待
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, const struct timespec* timeout) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace
+
 // RingBuffer实现
 RingBuffer::RingBuffer(const Config& config) : config_(config) {
 }
@@ -119,25 +203,97 @@ bool RingBuffer::create(CreateMode mode) {
 
     try {
         // 分配共享内存
-        if (!allocate_memory()) {
+        bool create_allowed = mode != CreateMode::OPEN_ONLY;
+        if (!allocate_memory(create_allowed)) {
             return false;
         }
 
-        // 创建同步对象
-        if (config_.enable_events && !create_shared_objects()) {
+        // 新建的缓冲区总是使用 v2 头部；已存在的缓冲区按 version 选择布局
+        bool initialize = mode == CreateMode::CREATE_ONLY ||
+                          (mode == CreateMode::CREATE_OR_OPEN && header_->magic_number != MAGIC_NUMBER);
+        if (initialize) {
+            // 多生产者模式总是按记录读写
+            if (config_.producer_mode == ProducerMode::MULTI) {
+                config_.record_framing = true;
+            }
+            if (config_.record_framing && config_.buffer_size % RECORD_ALIGNMENT != 0) {
+                std::cerr << "RingBuffer: record framing requires buffer_size to be a multiple of "
+                          << RECORD_ALIGNMENT << std::endl;
+                close();
+                return false;
+            }
+            header_->version = HEADER_VERSION;
+            header_->layout_flags = config_.record_framing ? HEADER_FLAG_RECORDS : 0;
+            if (config_.mirror_mapping) {
+#ifdef _WIN32
+                std::cerr << "RingBuffer: mirror mapping is not supported on this platform" << std::endl;
+#else
+                size_t page_size = system_page_size();
+                if (!is_power_of_two(config_.buffer_size) || config_.buffer_size % page_size != 0) {
+                    std::cerr << "RingBuffer: mirror mapping requires a power-of-two buffer_size that is a multiple of "
+                              << page_size << std::endl;
+                    close();
+                    return false;
+                }
+                header_->layout_flags |= HEADER_FLAG_MIRRORED;
+#endif
+            }
+        }
+
+        if (!bind_layout()) {
+            close();
             return false;
         }
+        apply_memory_options();
 
         // 初始化头部
-        if (mode == CreateMode::CREATE_ONLY ||
-            (mode == CreateMode::CREATE_OR_OPEN && header_->magic_number != MAGIC_NUMBER)) {
+        if (initialize) {
+            if (config_.producer_mode == ProducerMode::MULTI) {
+                // 未提交的记录头必须为 0
+                std::memset(buffer_, 0, config_.buffer_size);
+            }
 
             header_->magic_number = MAGIC_NUMBER;
-            header_->version = 1;
             header_->buffer_size = config_.buffer_size;
             header_->write_pos.store(0);
             header_->read_pos.store(0);
+            write_pos_->store(0);
+            read_pos_->store(0);
+            cached_read_pos_.store(0);
+            cached_write_pos_.store(0);
+            auto* header_v2 = reinterpret_cast<RingBufferHeaderV2*>(mapped_memory_);
+            header_v2->data_ready.sequence.store(0);
+            header_v2->data_ready.waiters.store(0);
+            header_v2->space_available.sequence.store(0);
+            header_v2->space_available.waiters.store(0);
+            for (RingBufferPeerInfo* info : {&header_v2->producer, &header_v2->consumer}) {
+                info->pid.store(0);
+                info->heartbeat.store(0);
+                info->heartbeat_ns.store(0);
+            }
+            header_->producer_mode = static_cast<uint8_t>(config_.producer_mode);
             header_->initialized = 1;
+        } else {
+            // 打开已存在的缓冲区：模式由创建方决定
+            config_.producer_mode = static_cast<ProducerMode>(header_->producer_mode);
+            config_.record_framing = (header_->layout_flags & HEADER_FLAG_RECORDS) != 0 ||
+                                     config_.producer_mode == ProducerMode::MULTI;
+        }
+
+        // 创建同步对象：v2 缓冲区在 Linux 下直接用头部里的 futex 字，不需要命名信号量
+        spin_budget_.store(config_.spin_iterations, std::memory_order_relaxed);
+        if (config_.enable_events) {
+#ifdef __linux__
+            if (header_->version == HEADER_VERSION) {
+                auto* header_v2 = reinterpret_cast<RingBufferHeaderV2*>(mapped_memory_);
+                data_ready_word_ = &header_v2->data_ready;
+                space_available_word_ = &header_v2->space_available;
+            }
+#endif
+            if (data_ready_word_ == nullptr && !create_shared_objects()) {
+                close();
+                return false;
+            }
         }
 
         // 验证头部
@@ -180,12 +336,22 @@ void RingBuffer::close() {
         munmap(mapped_memory_, mapped_size_);
         if (file_descriptor_ != -1) {
             ::close(file_descriptor_);
+            file_descriptor_ = -1;
         }
 #endif
         mapped_memory_ = nullptr;
     }
 
+    data_ready_word_ = nullptr;
+    space_available_word_ = nullptr;
+    waits_cancelled_.store(false);
+    mirrored_ = false;
+    huge_page_backed_ = false;
     header_ = nullptr;
+    write_pos_ = nullptr;
+    read_pos_ = nullptr;
+    producer_info_ = nullptr;
+    consumer_info_ = nullptr;
     buffer_ = nullptr;
     initialized_ = false;
 }
@@ -195,24 +361,26 @@ bool RingBuffer::write(const void* data, size_t size) {
         return false;
     }
 
-    uint64_t write_pos = get_write_position();
-    uint64_t read_pos = get_read_position();
+    if (config_.record_framing) {
+        return write_record(data, size);
+    }
 
-    // 计算可用空间
-    size_t free_space = config_.buffer_size - (write_pos - read_pos);
-    if (size > free_space) {
+    // 先按缓存的读位置计算可用空间，不够时才重新读取
+    uint64_t write_pos = get_write_position();
+    if (!has_free_space(write_pos, size)) {
         return false;
     }
 
     const uint8_t* src = static_cast<const uint8_t*>(data);
     uint64_t buffer_size = config_.buffer_size;
 
-    // 处理环形缓冲区的回绕
-    size_t first_chunk = std::min(size, buffer_size - (write_pos % buffer_size));
+    // 处理环形缓冲区的回绕 (镜像映射下总是连续的)
+    size_t offset = buffer_offset(write_pos);
+    size_t first_chunk = mirrored_ ? size : std::min(size, buffer_size - offset);
     size_t second_chunk = size - first_chunk;
 
     // 写入第一部分
-    uint8_t* dst = buffer_ + (write_pos % buffer_size);
+    uint8_t* dst = buffer_ + offset;
     std::memcpy(dst, src, first_chunk);
 
     // 写入第二部分（如果有）
@@ -226,28 +394,28 @@ bool RingBuffer::write(const void* data, size_t size) {
     release_barrier();
 
     // 通知消费者
-    if (data_ready_event_) {
-        data_ready_event_->signal();
-    }
+    signal_data_ready();
 
     return true;
 }
 
 bool RingBuffer::write_atomic(const void* data, size_t size) {
+    // 按记录模式下每条记录本来就是整体提交的
+    if (config_.record_framing) {
+        return write(data, size);
+    }
+
     // 检查是否有足够的连续空间
     uint64_t write_pos = get_write_position();
-    uint64_t read_pos = get_read_position();
-    size_t free_space = config_.buffer_size - (write_pos - read_pos);
-
-    if (size > free_space) {
+    if (!has_free_space(write_pos, size)) {
         return false;
     }
 
-    // 对于原子写入，确保不跨越缓冲区边界
+    // 对于原子写入，确保不跨越缓冲区边界 (镜像映射下没有边界)
     uint64_t buffer_size = config_.buffer_size;
-    uint64_t write_offset = write_pos % buffer_size;
+    uint64_t write_offset = buffer_offset(write_pos);
 
-    if (write_offset + size <= buffer_size) {
+    if (mirrored_ || write_offset + size <= buffer_size) {
         // 可以一次性写入
         std::memcpy(buffer_ + write_offset, data, size);
     } else {
@@ -258,10 +426,107 @@ bool RingBuffer::write_atomic(const void* data, size_t size) {
     set_write_position(write_pos + size);
     release_barrier();
 
-    if (data_ready_event_) {
-        data_ready_event_->signal();
+    signal_data_ready();
+
+    return true;
+}
+
+bool RingBuffer::reserve(size_t size, WriteSlot& slot) {
+    if (!initialized_ || size == 0) {
+        return false;
+    }
+
+    if (config_.record_framing) {
+        return reserve_record(size, slot);
+    }
+
+    uint64_t write_pos = get_write_position();
+    size_t offset = buffer_offset(write_pos);
+    if (!mirrored_ && offset + size > config_.buffer_size) {
+        return false;  // 不连续
+    }
+    if (!has_free_space(write_pos, size)) {
+        return false;
+    }
+
+    slot.data = buffer_ + offset;
+    slot.size = size;
+    slot.position = write_pos;
+    return true;
+}
+
+bool RingBuffer::commit(const WriteSlot& slot, size_t size) {
+    if (!initialized_ || slot.data == nullptr || size > slot.size) {
+        return false;
+    }
+
+    if (config_.record_framing) {
+        commit_record(slot, size);
+        return true;
+    }
+
+    if (size == 0) {
+        return true;
+    }
+
+    set_write_position(slot.position + size);
+
+    signal_data_ready();
+
+    return true;
+}
+
+bool RingBuffer::acquire(ReadView& view) {
+    if (!initialized_) {
+        return false;
+    }
+
+    if (config_.record_framing) {
+        uint64_t start = get_read_position();
+        uint64_t pos = start;
+        const RecordHeader* record = nullptr;
+        if (!next_record(start, pos, record)) {
+            // 只有回绕填充/放弃的预留也要归还空间
+            if (pos != start) {
+                release_records(start, pos);
+            }
+            return false;
+        }
+        view.data = reinterpret_cast<const uint8_t*>(record + 1);
+        view.size = record->length;
+        view.begin = start;
+        view.end = pos + record->span.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t read_pos = get_read_position();
+    size_t available = available_data(read_pos, 1);
+    if (available == 0) {
+        return false;
+    }
+
+    size_t offset = buffer_offset(read_pos);
+    view.data = buffer_ + offset;
+    view.size = mirrored_ ? available : std::min(available, config_.buffer_size - offset);
+    view.begin = read_pos;
+    view.end = read_pos + view.size;
+    return true;
+}
+
+bool RingBuffer::release(const ReadView& view) {
+    if (!initialized_ || view.data == nullptr) {
+        return false;
+    }
+
+    if (config_.record_framing) {
+        release_records(view.begin, view.end);
+        return true;
     }
 
+    set_read_position(view.end);
+
+    signal_space_available();
+
     return true;
 }
 
@@ -271,12 +536,31 @@ bool RingBuffer::read(void* buffer, size_t buffer_size, size_t& bytes_read) {
         return false;
     }
 
-    acquire_barrier();
-    uint64_t write_pos = get_write_position();
-    uint64_t read_pos = get_read_position();
+    if (config_.record_framing) {
+        bytes_read = 0;
+        uint64_t start = get_read_position();
+        uint64_t pos = start;
+        const RecordHeader* record = nullptr;
+        if (!next_record(start, pos, record)) {
+            // 只有回绕填充也要归还空间
+            if (pos != start) {
+                release_records(start, pos);
+            }
+            return true;
+        }
+        if (record->length > buffer_size) {
+            return false;
+        }
+
+        std::memcpy(buffer, reinterpret_cast<const uint8_t*>(record + 1), record->length);
+        bytes_read = record->length;
+        release_records(start, pos + record->span.load(std::memory_order_relaxed));
+        return true;
+    }
 
-    // 计算可用数据
-    size_t available = write_pos - read_pos;
+    // 先按缓存的写位置计算可读数据，不够时才重新读取
+    uint64_t read_pos = get_read_position();
+    size_t available = available_data(read_pos, buffer_size);
     if (available == 0) {
         bytes_read = 0;
         return true;  // 缓冲区为空
@@ -284,15 +568,16 @@ bool RingBuffer::read(void* buffer, size_t buffer_size, size_t& bytes_read) {
 
     // 限制读取量
     size_t to_read = std::min(available, buffer_size);
-    uint64_t buffer_size = config_.buffer_size;
+    uint64_t ring_size = config_.buffer_size;
 
-    // 处理环形缓冲区的回绕
+    // 处理环形缓冲区的回绕 (镜像映射下总是连续的)
     uint8_t* dst = static_cast<uint8_t*>(buffer);
-    size_t first_chunk = std::min(to_read, buffer_size - (read_pos % buffer_size));
+    size_t offset = buffer_offset(read_pos);
+    size_t first_chunk = mirrored_ ? to_read : std::min(to_read, ring_size - offset);
     size_t second_chunk = to_read - first_chunk;
 
     // 读取第一部分
-    const uint8_t* src = buffer_ + (read_pos % buffer_size);
+    const uint8_t* src = buffer_ + offset;
     std::memcpy(dst, src, first_chunk);
 
     // 读取第二部分（如果有）
@@ -306,9 +591,7 @@ bool RingBuffer::read(void* buffer, size_t buffer_size, size_t& bytes_read) {
     bytes_read = to_read;
 
     // 通知生产者
-    if (space_available_event_) {
-        space_available_event_->signal();
-    }
+    signal_space_available();
 
     return true;
 }
@@ -319,24 +602,38 @@ bool RingBuffer::peek(void* buffer, size_t buffer_size, size_t& bytes_read) cons
         return false;
     }
 
-    acquire_barrier();
-    uint64_t write_pos = get_write_position();
-    uint64_t read_pos = get_read_position();
+    if (config_.record_framing) {
+        bytes_read = 0;
+        uint64_t start = get_read_position();
+        uint64_t pos = start;
+        const RecordHeader* record = nullptr;
+        if (!next_record(start, pos, record)) {
+            return true;
+        }
+        if (record->length > buffer_size) {
+            return false;
+        }
+        std::memcpy(buffer, reinterpret_cast<const uint8_t*>(record + 1), record->length);
+        bytes_read = record->length;
+        return true;
+    }
 
-    size_t available = write_pos - read_pos;
+    uint64_t read_pos = get_read_position();
+    size_t available = available_data(read_pos, buffer_size);
     if (available == 0) {
         bytes_read = 0;
         return true;
     }
 
     size_t to_read = std::min(available, buffer_size);
-    uint64_t buffer_size = config_.buffer_size;
+    uint64_t ring_size = config_.buffer_size;
 
     uint8_t* dst = static_cast<uint8_t*>(buffer);
-    size_t first_chunk = std::min(to_read, buffer_size - (read_pos % buffer_size));
+    size_t offset = buffer_offset(read_pos);
+    size_t first_chunk = mirrored_ ? to_read : std::min(to_read, ring_size - offset);
     size_t second_chunk = to_read - first_chunk;
 
-    const uint8_t* src = buffer_ + (read_pos % buffer_size);
+    const uint8_t* src = buffer_ + offset;
     std::memcpy(dst, src, first_chunk);
 
     if (second_chunk > 0) {
@@ -353,20 +650,32 @@ bool RingBuffer::skip(size_t bytes) {
         return false;
     }
 
-    acquire_barrier();
-    uint64_t write_pos = get_write_position();
-    uint64_t read_pos = get_read_position();
+    if (config_.record_framing) {
+        uint64_t start = get_read_position();
+        uint64_t pos = start;
+        size_t remaining = bytes;
+        while (remaining > 0) {
+            const RecordHeader* record = nullptr;
+            if (!next_record(start, pos, record) || record->length > remaining) {
+                return false;
+            }
+            remaining -= record->length;
+            pos += record->span.load(std::memory_order_relaxed);
+        }
+        if (pos != start) {
+            release_records(start, pos);
+        }
+        return true;
+    }
 
-    size_t available = write_pos - read_pos;
-    if (bytes > available) {
+    uint64_t read_pos = get_read_position();
+    if (bytes > available_data(read_pos, bytes)) {
         return false;
     }
 
     set_read_position(read_pos + bytes);
 
-    if (space_available_event_) {
-        space_available_event_->signal();
-    }
+    signal_space_available();
 
     return true;
 }
@@ -396,10 +705,63 @@ size_t RingBuffer::get_capacity() const {
     return config_.buffer_size;
 }
 
+size_t RingBuffer::get_max_record_size() const {
+    if (config_.record_framing) {
+        if (mirrored_) {
+            // 镜像映射下记录可以跨越缓冲区末尾，不需要回绕填充
+            return config_.buffer_size - sizeof(RecordHeader);
+        }
+        // 不超过容量的一半，保证回绕填充加记录总能放进空缓冲区
+        return config_.buffer_size / 2 - sizeof(RecordHeader);
+    }
+    return config_.buffer_size;
+}
+
 bool RingBuffer::is_connected() const {
     return initialized_;
 }
 
+void RingBuffer::attach_peer(RingPeer peer) {
+    RingBufferPeerInfo* info = peer_info(peer);
+    if (info == nullptr) {
+        return;
+    }
+    info->pid.store(current_process_id(), std::memory_order_relaxed);
+    heartbeat(peer);
+}
+
+void RingBuffer::detach_peer(RingPeer peer) {
+    RingBufferPeerInfo* info = peer_info(peer);
+    if (info == nullptr) {
+        return;
+    }
+    // 多生产者模式下可能已被后连接的生产者覆盖，不能清掉别人的 pid
+    uint32_t expected = current_process_id();
+    info->pid.compare_exchange_strong(expected, 0, std::memory_order_release, std::memory_order_relaxed);
+}
+
+void RingBuffer::heartbeat(RingPeer peer) {
+    RingBufferPeerInfo* info = peer_info(peer);
+    if (info == nullptr) {
+        return;
+    }
+    info->heartbeat_ns.store(now_ns(), std::memory_order_relaxed);
+    info->heartbeat.fetch_add(1, std::memory_order_release);
+}
+
+RingPeerStatus RingBuffer::get_peer_status(RingPeer peer) const {
+    RingPeerStatus status;
+    const RingBufferPeerInfo* info = peer_info(peer);
+    if (info == nullptr) {
+        return status;
+    }
+    status.heartbeat = info->heartbeat.load(std::memory_order_acquire);
+    status.heartbeat_ns = info->heartbeat_ns.load(std::memory_order_relaxed);
+    status.pid = info->pid.load(std::memory_order_relaxed);
+    status.alive = status.pid != 0 && process_exists(status.pid);
+    return status;
+}
+
 bool RingBuffer::is_empty() const {
     return get_used_space() == 0;
 }
@@ -409,43 +771,240 @@ bool RingBuffer::is_full() const {
 }
 
 bool RingBuffer::wait_for_data(int timeout_ms) {
-    if (!initialized_ || !data_ready_event_) {
+    if (!initialized_ || waits_cancelled_.load(std::memory_order_relaxed)) {
         return false;
     }
 
-    // 首先检查是否有数据
-    if (!is_empty()) {
-        return true;
+    return wait_on(data_ready_word_, data_ready_event_.get(), [this]() { return has_data(); }, timeout_ms);
+}
+
+bool RingBuffer::notify_data_ready() {
+    if (!initialized_ || (!data_ready_word_ && !data_ready_event_)) {
+        return false;
     }
 
-    // 等待事件通知
-    return data_ready_event_->wait(timeout_ms);
+    signal_data_ready();
+    return true;
 }
 
-bool RingBuffer::notify_data_ready() {
-    if (!initialized_ || !data_ready_event_) {
+bool RingBuffer::wait_for_space(size_t size, int timeout_ms) {
+    if (!initialized_ || waits_cancelled_.load(std::memory_order_relaxed) || size > get_max_record_size()) {
         return false;
     }
 
-    return data_ready_event_->signal();
+    return wait_on(space_available_word_, space_available_event_.get(),
+                   [this, size]() { return can_write(size); }, timeout_ms);
 }
 
-// 私有方法实现
-bool RingBuffer::allocate_memory() {
-    size_t total_size = HEADER_SIZE + config_.buffer_size;
+void RingBuffer::cancel_waits() {
+    waits_cancelled_.store(true);
 
-    // 对齐到页面大小
-#ifdef _WIN32
-    SYSTEM_INFO si;
-    GetSystemInfo(&si);
-    size_t page_size = si.dwPageSize;
+    // 改变 sequence 后唤醒：已登记但尚未休眠的等待方也会因 sequence 不符立即返回
+#ifdef __linux__
+    for (RingBufferWaitWord* word : {data_ready_word_, space_available_word_}) {
+        if (word) {
+            word->sequence.fetch_add(1, std::memory_order_release);
+            futex_wake_all(word->sequence);
+        }
+    }
+#endif
+    if (data_ready_event_) {
+        data_ready_event_->signal();
+    }
+    if (space_available_event_) {
+        space_available_event_->signal();
+    }
+}
+
+bool RingBuffer::has_data() const {
+    // 多生产者模式下写位置是预留位置，要看读位置上的记录是否已提交 (回绕填充也算，消费时一并归还)
+    if (config_.producer_mode == ProducerMode::MULTI) {
+        return record_at(get_read_position())->span.load(std::memory_order_acquire) != 0;
+    }
+    return get_write_position() != get_read_position();
+}
+
+bool RingBuffer::can_write(size_t size) const {
+    if (!config_.record_framing) {
+        return get_free_space() >= size;
+    }
+
+    // 与 reserve_record 的判断相同
+    uint64_t ring_size = config_.buffer_size;
+    uint64_t tail = get_write_position();
+    uint64_t span = record_span(size);
+    uint64_t to_end = ring_size - buffer_offset(tail);
+    uint64_t padding = (!mirrored_ && span > to_end) ? to_end : 0;
+    return tail + padding + span - get_read_position() <= ring_size;
+}
+
+void RingBuffer::signal_data_ready() {
+    if (data_ready_word_) {
+        wake_wait_word(*data_ready_word_);
+        return;
+    }
+    if (data_ready_event_) {
+        data_ready_event_->signal();
+    }
+}
+
+void RingBuffer::signal_space_available() {
+    if (space_available_word_) {
+        wake_wait_word(*space_available_word_);
+        return;
+    }
+    if (space_available_event_) {
+        space_available_event_->signal();
+    }
+}
+
+void wake_wait_word(RingBufferWaitWord& word) {
+#ifdef __linux__
+    // 与等待方登记后的 fence 配对：要么等待方看到新状态，要么这里看到等待者
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (word.waiters.load(std::memory_order_relaxed) != 0) {
+        word.sequence.fetch_add(1, std::memory_order_release);
+        futex_wake_all(word.sequence);
+    }
 #else
-    size_t page_size = sysconf(_SC_PAGESIZE);
+    (void)word;
 #endif
+}
+
+void park_on_wait_word(RingBufferWaitWord& word, uint32_t sequence, int64_t timeout_ns) {
+#ifdef __linux__
+    // sequence 已变化时立即返回；超时按单调时钟的相对时间计算
+    struct timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(timeout_ns / 1000000000);
+    timeout.tv_nsec = static_cast<long>(timeout_ns % 1000000000);
+    futex_wait(word.sequence, sequence, timeout_ns < 0 ? nullptr : &timeout);
+#else
+    (void)word;
+    (void)sequence;
+    (void)timeout_ns;
+    std::this_thread::yield();
+#endif
+}
+
+// 先自旋，再休眠等待唤醒。
+// ADAPTIVE：自旋预算自适应，自旋中等到就加倍 (不超过 spin_iterations)，需要休眠就减半。
+// BUSY_POLL：自旋后不断 yield，不登记为等待者，生产者也就不做系统调用；yield_iterations 用完后才休眠。
+// 休眠时先登记为等待者并重新检查条件，再在 sequence 上 futex 等待；没有 futex 字时等待命名事件
+template<typename Condition>
+bool RingBuffer::wait_on(RingBufferWaitWord* word, CrossProcessEvent* event, Condition condition, int timeout_ms) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    auto cancelled = [this]() { return waits_cancelled_.load(std::memory_order_relaxed); };
+
+    if (config_.wait_strategy == WaitStrategy::BUSY_POLL) {
+        for (int spin = 0; spin < config_.spin_iterations; ++spin) {
+            if (condition()) {
+                return true;
+            }
+            detail::cpu_relax();
+        }
+        for (int yields = 0; config_.yield_iterations < 0 || yields < config_.yield_iterations; ++yields) {
+            if (condition()) {
+                return true;
+            }
+            if (cancelled()) {
+                return false;
+            }
+            if (timeout_ms >= 0 && Clock::now() >= deadline) {
+                return condition();
+            }
+            std::this_thread::yield();
+        }
+    } else {
+        const int spin_floor = config_.spin_iterations > 0 ? std::max(1, config_.spin_iterations / 16) : 0;
+        const int budget = spin_budget_.load(std::memory_order_relaxed);
+        for (int spin = 0; spin < budget; ++spin) {
+            if (condition()) {
+                spin_budget_.store(std::min(config_.spin_iterations, budget * 2), std::memory_order_relaxed);
+                return true;
+            }
+            detail::cpu_relax();
+        }
+        spin_budget_.store(std::max(spin_floor, budget / 2), std::memory_order_relaxed);
+    }
+    if (condition()) {
+        return true;
+    }
+
+    // 剩余时间 (纳秒)；不限时返回 -1
+    auto remaining_ns = [&]() -> int64_t {
+        if (timeout_ms < 0) {
+            return -1;
+        }
+        return std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            deadline - Clock::now()).count());
+    };
+
+#ifdef __linux__
+    if (word) {
+        for (;;) {
+            int64_t remaining = remaining_ns();
+            if (remaining == 0) {
+                return condition();
+            }
+            uint32_t sequence = word->sequence.load(std::memory_order_acquire);
+            word->waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (condition()) {
+                word->waiters.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (cancelled()) {
+                word->waiters.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            park_on_wait_word(*word, sequence, remaining);
+            word->waiters.fetch_sub(1, std::memory_order_relaxed);
+
+            if (condition()) {
+                return true;
+            }
+            if (cancelled()) {
+                return false;
+            }
+        }
+    }
+#else
+    (void)word;
+#endif
+
+    if (!event) {
+        return false;
+    }
+    // 命名事件可能残留之前的通知，被唤醒后要重新检查条件
+    for (;;) {
+        int64_t remaining = remaining_ns();
+        if (remaining == 0) {
+            return condition();
+        }
+        int wait_ms = remaining < 0 ? -1 : static_cast<int>((remaining + 999999) / 1000000);
+        event->wait(wait_ms);
+        if (condition()) {
+            return true;
+        }
+        if (cancelled()) {
+            return false;
+        }
+    }
+}
+
+// 私有方法实现
+bool RingBuffer::allocate_memory(bool create) {
+    // 按 v2 头部计算；打开 v1 缓冲区时多映射的尾部不会被使用
+    size_t total_size = HEADER_SIZE + config_.buffer_size;
+
+    // 对齐到页面大小 (镜像映射时 buffer_size 是页大小的倍数，数据区恰好从第二页开始)
+    size_t page_size = system_page_size();
     mapped_size_ = ((total_size + page_size - 1) / page_size) * page_size;
 
 #ifdef _WIN32
-    // Windows共享内存实现
+    // Windows共享内存实现 (CreateFileMapping 总是创建或打开)
+    (void)create;
     std::string mapping_name = "Local\\" + config_.name;
 
     file_mapping_ = CreateFileMappingA(
@@ -482,42 +1041,157 @@ bool RingBuffer::allocate_memory() {
 
 #else
     // Linux共享内存实现
-    std::string shm_name = "/BitRPC_" + config_.name;
+    huge_page_backed_ = false;
+    if (config_.huge_pages == HugePagePolicy::EXPLICIT) {
+        // 镜像映射按普通页的偏移映射数据区，不能放在 hugetlbfs 上
+        if (!config_.mirror_mapping && open_hugetlbfs_file(create, total_size)) {
+            huge_page_backed_ = true;
+        } else if (create) {
+            std::cerr << "RingBuffer: hugetlbfs unavailable under " << config_.hugetlbfs_path
+                      << ", falling back to transparent huge pages" << std::endl;
+        }
+    }
 
-    file_descriptor_ = shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0666);
-    if (file_descriptor_ == -1) {
-        return false;
+    if (!huge_page_backed_) {
+        std::string shm_name = "/BitRPC_" + config_.name;
+
+        file_descriptor_ = shm_open(shm_name.c_str(), (create ? O_CREAT : 0) | O_RDWR, 0666);
+        if (file_descriptor_ == -1) {
+            // 只打开时缓冲区也可能是创建方放在 hugetlbfs 上的
+            if (create || errno != ENOENT || !open_hugetlbfs_file(false, total_size)) {
+                return false;
+            }
+            huge_page_backed_ = true;
+        } else {
+            // 设置共享内存大小
+            if (ftruncate(file_descriptor_, mapped_size_) == -1) {
+                ::close(file_descriptor_);
+                file_descriptor_ = -1;
+                return false;
+            }
+
+            mapped_memory_ = mmap(
+                nullptr,
+                mapped_size_,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED,
+                file_descriptor_,
+                0
+            );
+
+            if (mapped_memory_ == MAP_FAILED) {
+                mapped_memory_ = nullptr;
+                ::close(file_descriptor_);
+                file_descriptor_ = -1;
+                return false;
+            }
+        }
     }
+#endif
 
-    // 设置共享内存大小
-    if (ftruncate(file_descriptor_, mapped_size_) == -1) {
+    if (mapped_memory_ == nullptr) {
         return false;
     }
 
-    mapped_memory_ = mmap(
-        nullptr,
-        mapped_size_,
-        PROT_READ | PROT_WRITE,
-        MAP_SHARED,
-        file_descriptor_,
-        0
-    );
+    // 元数据在两个版本中都位于起始处；读写位置和缓冲区由 bind_layout 按版本确定
+    header_ = static_cast<RingBufferHeader*>(mapped_memory_);
 
-    if (mapped_memory_ == MAP_FAILED) {
-        mapped_memory_ = nullptr;
+    return true;
+}
+
+// hugetlbfs 上的文件按大页分配；没有足够的预留大页时 mmap 失败，由调用方退回普通共享内存
+bool RingBuffer::open_hugetlbfs_file(bool create, size_t total_size) {
+#ifdef __linux__
+    std::string path = config_.hugetlbfs_path + "/BitRPC_" + config_.name;
+    int fd = ::open(path.c_str(), (create ? O_CREAT : 0) | O_RDWR, 0666);
+    if (fd == -1) {
         return false;
     }
-#endif
 
-    if (mapped_memory_ == nullptr) {
+    struct statfs fs;
+    struct stat st;
+    bool ok = fstatfs(fd, &fs) == 0 && fs.f_type == HUGETLBFS_MAGIC && fstat(fd, &st) == 0;
+    bool fresh = ok && st.st_size == 0;  // 刚由本进程创建
+    size_t size = 0;
+    void* memory = MAP_FAILED;
+    if (ok) {
+        size_t huge_page_size = static_cast<size_t>(fs.f_bsize);
+        size = (total_size + huge_page_size - 1) / huge_page_size * huge_page_size;
+        ok = fresh ? create && ftruncate(fd, static_cast<off_t>(size)) == 0
+                   : static_cast<size_t>(st.st_size) == size;
+    }
+    if (ok) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (memory == MAP_FAILED) {
+        ::close(fd);
+        if (create && fresh) {
+            unlink(path.c_str());
+        }
         return false;
     }
 
-    // 设置头部和缓冲区指针
-    header_ = static_cast<RingBufferHeader*>(mapped_memory_);
-    buffer_ = static_cast<uint8_t*>(mapped_memory_) + HEADER_SIZE;
-
+    file_descriptor_ = fd;
+    mapped_memory_ = memory;
+    mapped_size_ = size;
     return true;
+#else
+    (void)create;
+    (void)total_size;
+    return false;
+#endif
+}
+
+// 透明大页建议、NUMA 策略、预取和锁定。映射已按布局确定 (包括镜像映射)，首次写入之前调用
+void RingBuffer::apply_memory_options() {
+#ifdef __linux__
+    if (config_.numa_node >= 0) {
+        // 共享内存的策略记录在共享对象上，对所有映射它的进程生效；已分配的页面不迁移
+        const size_t bits = sizeof(unsigned long) * 8;
+        std::vector<unsigned long> nodemask(static_cast<size_t>(config_.numa_node) / bits + 1, 0);
+        nodemask[config_.numa_node / bits] |= 1UL << (config_.numa_node % bits);
+        if (syscall(SYS_mbind, mapped_memory_, mapped_size_, MPOL_PREFERRED, nodemask.data(),
+                    nodemask.size() * bits + 1, 0) != 0) {
+            std::cerr << "RingBuffer: failed to prefer NUMA node " << config_.numa_node << std::endl;
+        }
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (config_.huge_pages != HugePagePolicy::NONE && !huge_page_backed_) {
+        if (madvise(mapped_memory_, mapped_size_, MADV_HUGEPAGE) != 0) {
+            std::cerr << "RingBuffer: transparent huge pages unavailable" << std::endl;
+        }
+    }
+#endif
+
+    if (config_.prefault) {
+        // 不改写内容，打开正在使用中的缓冲区也安全；内核不支持时逐页读取
+        bool populated = false;
+#ifdef MADV_POPULATE_WRITE
+        populated = madvise(mapped_memory_, mapped_size_, MADV_POPULATE_WRITE) == 0;
+#endif
+        if (!populated) {
+            const volatile uint8_t* bytes = static_cast<const volatile uint8_t*>(mapped_memory_);
+            for (size_t offset = 0; offset < mapped_size_; offset += system_page_size()) {
+                (void)bytes[offset];
+            }
+        }
+    }
+
+    if (config_.lock_memory && mlock(mapped_memory_, mapped_size_) != 0) {
+        std::cerr << "RingBuffer: mlock failed (check RLIMIT_MEMLOCK)" << std::endl;
+    }
+#else
+    if (config_.prefault) {
+        const volatile uint8_t* bytes = static_cast<const volatile uint8_t*>(mapped_memory_);
+        for (size_t offset = 0; offset < mapped_size_; offset += system_page_size()) {
+            (void)bytes[offset];
+        }
+    }
+    if (config_.huge_pages != HugePagePolicy::NONE || config_.lock_memory || config_.numa_node >= 0) {
+        std::cerr << "RingBuffer: huge pages, mlock and NUMA placement are not supported on this platform" << std::endl;
+    }
+#endif
 }
 
 bool RingBuffer::create_shared_objects() {
@@ -550,14 +1224,13 @@ bool RingBuffer::validate_header() const {
     }
 
     return header_->magic_number == MAGIC_NUMBER &&
-           header_->version == 1 &&
+           (header_->version == HEADER_VERSION_V1 || header_->version == HEADER_VERSION) &&
            header_->buffer_size == config_.buffer_size &&
            header_->initialized == 1;
 }
 
 void RingBuffer::update_header() {
     if (header_) {
-        header_->version = 1;
         header_->initialized = 1;
     }
 }
@@ -571,37 +1244,265 @@ size_t RingBuffer::get_data_offset() const {
 }
 
 uint64_t RingBuffer::get_write_position() const {
-    return header_ ? header_->write_pos.load(std::memory_order_acquire) : 0;
+    return write_pos_ ? write_pos_->load(std::memory_order_acquire) : 0;
 }
 
 uint64_t RingBuffer::get_read_position() const {
-    return header_ ? header_->read_pos.load(std::memory_order_acquire) : 0;
+    return read_pos_ ? read_pos_->load(std::memory_order_acquire) : 0;
 }
 
 void RingBuffer::set_write_position(uint64_t pos) {
-    if (header_) {
-        header_->write_pos.store(pos, std::memory_order_release);
+    if (write_pos_) {
+        write_pos_->store(pos, std::memory_order_release);
     }
 }
 
 void RingBuffer::set_read_position(uint64_t pos) {
-    if (header_) {
-        header_->read_pos.store(pos, std::memory_order_release);
+    if (read_pos_) {
+        read_pos_->store(pos, std::memory_order_release);
+    }
+}
+
+bool RingBuffer::bind_layout() {
+    uint8_t* base = static_cast<uint8_t*>(mapped_memory_);
+    if (header_->version == HEADER_VERSION && (header_->layout_flags & HEADER_FLAG_MIRRORED)) {
+        size_t page_size = system_page_size();
+        size_t data_offset = (HEADER_SIZE + page_size - 1) / page_size * page_size;
+        if (config_.buffer_size % page_size != 0 || !map_mirror(data_offset)) {
+            std::cerr << "RingBuffer: failed to create mirror mapping" << std::endl;
+            return false;
+        }
+        base = static_cast<uint8_t*>(mapped_memory_);
+        auto* header_v2 = reinterpret_cast<RingBufferHeaderV2*>(base);
+        write_pos_ = &header_v2->write_pos;
+        read_pos_ = &header_v2->read_pos;
+        producer_info_ = &header_v2->producer;
+        consumer_info_ = &header_v2->consumer;
+        buffer_ = base + data_offset;
+        mirrored_ = true;
+    } else if (header_->version == HEADER_VERSION) {
+        auto* header_v2 = reinterpret_cast<RingBufferHeaderV2*>(base);
+        write_pos_ = &header_v2->write_pos;
+        read_pos_ = &header_v2->read_pos;
+        producer_info_ = &header_v2->producer;
+        consumer_info_ = &header_v2->consumer;
+        buffer_ = base + HEADER_SIZE;
+    } else if (header_->version == HEADER_VERSION_V1) {
+        // 旧版本创建的缓冲区：读写位置与元数据紧挨着
+        write_pos_ = &header_->write_pos;
+        read_pos_ = &header_->read_pos;
+        buffer_ = base + HEADER_SIZE_V1;
+    } else {
+        return false;
     }
+
+    power_of_two_ = is_power_of_two(config_.buffer_size);
+    index_mask_ = config_.buffer_size - 1;
+
+    refresh_cached_read_position();
+    refresh_cached_write_position();
+    return true;
 }
 
-void RingBuffer::acquire_barrier() {
+// 把 [头部 + 数据区] 映射到一段预留的地址空间，再把数据区紧接着映射一次：
+// buffer_[i] 与 buffer_[i + buffer_size] 是同一块物理内存
+bool RingBuffer::map_mirror(size_t data_offset) {
+#ifdef _WIN32
+    (void)data_offset;
+    return false;
+#else
+    size_t ring_size = config_.buffer_size;
+    size_t total_size = data_offset + 2 * ring_size;
+
+    void* base = mmap(nullptr, total_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(base);
+    void* primary = mmap(bytes, data_offset + ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_FIXED, file_descriptor_, 0);
+    void* mirror = primary == MAP_FAILED ? MAP_FAILED
+                 : mmap(bytes + data_offset + ring_size, ring_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, file_descriptor_, static_cast<off_t>(data_offset));
+    if (mirror == MAP_FAILED) {
+        munmap(base, total_size);
+        return false;
+    }
+
+    // 换掉普通映射
+    munmap(mapped_memory_, mapped_size_);
+    mapped_memory_ = base;
+    mapped_size_ = total_size;
+    header_ = static_cast<RingBufferHeader*>(mapped_memory_);
+    return true;
+#endif
+}
+
+// 缓存用 release 写入、acquire 读取：使用别的线程刷新的缓存时，
+// 对端在发布该位置之前的读写同样可见
+uint64_t RingBuffer::refresh_cached_read_position() const {
+    uint64_t pos = get_read_position();
+    cached_read_pos_.store(pos, std::memory_order_release);
+    return pos;
+}
+
+uint64_t RingBuffer::refresh_cached_write_position() const {
+    uint64_t pos = get_write_position();
+    cached_write_pos_.store(pos, std::memory_order_release);
+    return pos;
+}
+
+bool RingBuffer::has_free_space(uint64_t write_pos, uint64_t size) const {
+    uint64_t ring_size = config_.buffer_size;
+    if (write_pos + size - cached_read_pos_.load(std::memory_order_acquire) <= ring_size) {
+        return true;
+    }
+    return write_pos + size - refresh_cached_read_position() <= ring_size;
+}
+
+size_t RingBuffer::available_data(uint64_t read_pos, size_t wanted) const {
+    uint64_t available = cached_write_pos_.load(std::memory_order_acquire) - read_pos;
+    if (available < wanted) {
+        available = refresh_cached_write_position() - read_pos;
+    }
+    return available;
+}
+
+void RingBuffer::acquire_barrier() const {
     std::atomic_thread_fence(std::memory_order_acquire);
 }
 
-void RingBuffer::release_barrier() {
+void RingBuffer::release_barrier() const {
     std::atomic_thread_fence(std::memory_order_release);
 }
 
+// 按记录模式实现 (多生产者模式总是按记录)
+bool RingBuffer::write_record(const void* data, size_t size) {
+    WriteSlot slot;
+    if (!reserve_record(size, slot)) {
+        return false;
+    }
+
+    std::memcpy(slot.data, data, size);
+    commit_record(slot, size);
+    return true;
+}
+
+bool RingBuffer::reserve_record(size_t size, WriteSlot& slot) {
+    if (size > get_max_record_size()) {
+        return false;
+    }
+
+    uint64_t ring_size = config_.buffer_size;
+    uint64_t span = record_span(size);
+    bool multi_producer = config_.producer_mode == ProducerMode::MULTI;
+
+    // 预留 [tail, tail + padding + span)；放不下缓冲区尾部时连同尾部填充一起预留。
+    // 多生产者用 CAS 推进写位置；单生产者到 commit 时才发布写位置
+    uint64_t tail = write_pos_->load(std::memory_order_relaxed);
+    uint64_t padding = 0;
+    for (;;) {
+        uint64_t to_end = ring_size - buffer_offset(tail);
+        padding = (!mirrored_ && span > to_end) ? to_end : 0;
+        if (!has_free_space(tail, padding + span)) {
+            return false;
+        }
+        if (!multi_producer) {
+            break;
+        }
+        if (write_pos_->compare_exchange_weak(tail, tail + padding + span,
+                                              std::memory_order_relaxed,
+                                              std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (padding > 0) {
+        RecordHeader* filler = record_at(tail);
+        filler->length = PADDING_LENGTH;
+        filler->span.store(static_cast<uint32_t>(padding), std::memory_order_release);
+        tail += padding;
+    }
+
+    slot.data = reinterpret_cast<uint8_t*>(record_at(tail) + 1);
+    slot.size = size;
+    slot.position = tail;
+    return true;
+}
+
+void RingBuffer::commit_record(const WriteSlot& slot, size_t size) {
+    RecordHeader* record = record_at(slot.position);
+    uint32_t span = static_cast<uint32_t>(record_span(slot.size));
+
+    if (config_.producer_mode == ProducerMode::MULTI) {
+        // 写完负载后才提交 span，消费者不会读到写了一半的记录；
+        // 提交 0 字节的预留当作填充，由消费者跳过
+        record->length = size == 0 ? PADDING_LENGTH : static_cast<uint32_t>(size);
+        record->span.store(span, std::memory_order_release);
+    } else {
+        // 单生产者：放弃的预留不发布即可；写位置同时覆盖前面的回绕填充
+        if (size == 0) {
+            return;
+        }
+        record->length = static_cast<uint32_t>(size);
+        record->span.store(span, std::memory_order_relaxed);
+        set_write_position(slot.position + span);
+    }
+
+    signal_data_ready();
+}
+
+RecordHeader* RingBuffer::record_at(uint64_t pos) const {
+    return reinterpret_cast<RecordHeader*>(buffer_ + buffer_offset(pos));
+}
+
+bool RingBuffer::next_record(uint64_t start, uint64_t& pos, const RecordHeader*& record) const {
+    bool multi_producer = config_.producer_mode == ProducerMode::MULTI;
+    for (;;) {
+        if (pos - start >= config_.buffer_size) {
+            return false;
+        }
+        // 单生产者模式下写位置之前的记录都已完整写入
+        if (!multi_producer && available_data(pos, 1) == 0) {
+            return false;
+        }
+        const RecordHeader* candidate = record_at(pos);
+        uint32_t span = candidate->span.load(std::memory_order_acquire);
+        if (span == 0) {
+            return false;  // 尚未提交
+        }
+        if (candidate->length != PADDING_LENGTH) {
+            record = candidate;
+            return true;
+        }
+        pos += span;
+    }
+}
+
+void RingBuffer::release_records(uint64_t from, uint64_t to) {
+    // 多生产者：清零后再发布读位置，生产者看到新的读位置时，这段空间里的记录头都是 0
+    if (config_.producer_mode == ProducerMode::MULTI) {
+        uint64_t ring_size = config_.buffer_size;
+        uint64_t offset = buffer_offset(from);
+        uint64_t length = to - from;
+        uint64_t first_chunk = mirrored_ ? length : std::min(length, ring_size - offset);
+        std::memset(buffer_ + offset, 0, first_chunk);
+        if (length > first_chunk) {
+            std::memset(buffer_, 0, length - first_chunk);
+        }
+    }
+    set_read_position(to);
+
+    signal_space_available();
+}
+
 // RingBufferFactory实现
-std::unique_ptr<RingBuffer> RingBufferFactory::create_producer(const std::string& name, size_t buffer_size) {
+std::unique_ptr<RingBuffer> RingBufferFactory::create_producer(const std::string& name, size_t buffer_size,
+                                                               ProducerMode producer_mode) {
     auto config = RingBuffer::Config(name);
     config.buffer_size = buffer_size;
+    config.producer_mode = producer_mode;
     auto buffer = std::make_unique<RingBuffer>(config);
 
     if (!buffer->create(RingBuffer::CreateMode::CREATE_OR_OPEN)) {
@@ -629,7 +1530,32 @@ bool RingBufferFactory::remove_ring_buffer(const std::string& name) {
     return true;
 #else
     std::string shm_name = "/BitRPC_" + name;
-    return shm_unlink(shm_name.c_str()) == 0;
+    bool removed = shm_unlink(shm_name.c_str()) == 0;
+    // 使用默认挂载点的 hugetlbfs 缓冲区
+    std::string hugetlbfs_file = RingBuffer::Config().hugetlbfs_path + "/BitRPC_" + name;
+    return unlink(hugetlbfs_file.c_str()) == 0 || removed;
+#endif
+}
+
+bool pin_current_thread(int cpu) {
+    if (cpu < 0) {
+        return false;
+    }
+#if defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    return false;
 #endif
 }
 
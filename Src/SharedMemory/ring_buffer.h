@@ -19,19 +19,117 @@
 namespace bitrpc {
 namespace shared_memory {
 
-// 环形缓冲区头部元数据
+// 生产者模式
+enum class ProducerMode : uint8_t {
+    SINGLE = 0,  // 单生产者：字节流，write 直接移动 write_pos
+    MULTI = 1    // 多生产者：按记录写入，CAS 预留空间，逐条提交
+};
+
+// 等待策略 (wait_for_data / wait_for_space)
+enum class WaitStrategy : uint8_t {
+    ADAPTIVE = 0,  // 自适应自旋后休眠，由生产者唤醒
+    BUSY_POLL = 1  // 忙轮询：pause 自旋后 yield，不登记为等待者；yield_iterations 用完才休眠
+};
+
+// 大页策略
+enum class HugePagePolicy : uint8_t {
+    NONE = 0,
+    TRANSPARENT = 1,  // 对映射建议使用透明大页 (madvise MADV_HUGEPAGE，需 shmem_enabled 为 advise/always)
+    EXPLICIT = 2      // 在 hugetlbfs 上创建缓冲区文件，使用预留的大页；失败时退回普通共享内存加透明大页
+};
+
+// 环形缓冲区头部元数据 (v1 布局，v2 的公共前缀)
+// magic_number/version 在两个版本中偏移相同，打开方据此判断布局
 #pragma pack(push, 1)  // 确保紧凑内存布局
 struct RingBufferHeader {
-    std::atomic<uint64_t> write_pos{0};    // 写位置
-    std::atomic<uint64_t> read_pos{0};     // 读位置
+    std::atomic<uint64_t> write_pos{0};    // 写位置 (v1；v2 中不使用，保持为 0)
+    std::atomic<uint64_t> read_pos{0};     // 读位置 (v1；v2 中不使用，保持为 0)
     uint64_t buffer_size{0};               // 缓冲区大小
     uint32_t magic_number{0};              // 魔数，用于验证
     uint32_t version{1};                   // 版本号
     uint8_t initialized{0};               // 初始化标志
-    uint8_t padding[7];                   // 对齐填充
+    uint8_t producer_mode{0};             // ProducerMode，由创建方写入，打开方沿用
+    uint8_t layout_flags{0};              // 布局标志 (v2)，见 RingBuffer::HEADER_FLAG_*
+    uint8_t padding[5];                   // 对齐填充
 };
 #pragma pack(pop)
 
+// 跨进程等待/唤醒字 (v2 头部，Linux 下用 futex)
+// 通知方只读取 waiters，没有等待者时不做系统调用
+struct RingBufferWaitWord {
+    std::atomic<uint32_t> sequence{0};  // 每次唤醒加一，等待方在它上面 futex 等待
+    std::atomic<uint32_t> waiters{0};   // 正在等待的进程/线程数
+};
+
+// 通知方：有等待者时才递增 sequence 并唤醒
+void wake_wait_word(RingBufferWaitWord& word);
+// 等待方：先递增 waiters 并重新检查条件，再以之前读到的 sequence 调用；
+// sequence 已变化、被唤醒或超时 (timeout_ns 为负表示不限时) 后返回。非 Linux 平台只让出 CPU
+void park_on_wait_word(RingBufferWaitWord& word, uint32_t sequence, int64_t timeout_ns);
+
+// 连接到缓冲区的一方
+enum class RingPeer : uint8_t {
+    PRODUCER = 0,
+    CONSUMER = 1
+};
+
+// 一方的存活信息 (v2 头部，与该方的写/读位置同一缓存行，旧版本中为填充)。
+// 心跳只更新这里，不占用数据区；对端根据 pid 判断进程是否还在
+struct RingBufferPeerInfo {
+    std::atomic<uint32_t> pid{0};           // 进程 ID，0 表示未连接
+    std::atomic<uint32_t> reserved{0};
+    std::atomic<uint64_t> heartbeat{0};     // 心跳计数
+    std::atomic<uint64_t> heartbeat_ns{0};  // 最近一次心跳 (单调时钟纳秒)
+};
+
+// 存活信息快照
+struct RingPeerStatus {
+    uint32_t pid{0};
+    uint64_t heartbeat{0};
+    uint64_t heartbeat_ns{0};
+    bool alive{false};  // pid 不为 0 且对应的进程仍然存在
+};
+
+// 头部 v2：元数据、生产者、消费者各占独立的缓存行，读写位置互不伪共享
+// 按 128 字节对齐，避开相邻缓存行预取带来的伪共享
+constexpr size_t RING_BUFFER_CACHE_LINE = 128;
+
+struct RingBufferHeaderV2 {
+    alignas(RING_BUFFER_CACHE_LINE) RingBufferHeader meta;           // 只读元数据
+    // 与元数据共用缓存行 (原先的填充)，只在有等待者时才写入
+    RingBufferWaitWord data_ready;
+    RingBufferWaitWord space_available;
+    alignas(RING_BUFFER_CACHE_LINE) std::atomic<uint64_t> write_pos{0};  // 生产者区
+    RingBufferPeerInfo producer;
+    alignas(RING_BUFFER_CACHE_LINE) std::atomic<uint64_t> read_pos{0};   // 消费者区
+    RingBufferPeerInfo consumer;
+};
+static_assert(sizeof(RingBufferHeaderV2) == 3 * RING_BUFFER_CACHE_LINE, "unexpected RingBufferHeaderV2 layout");
+
+// 按记录模式下的记录头，记录 (头部 + 负载 + 对齐填充) 按 8 字节对齐
+// 多生产者模式下生产者先写负载再以 release 写入 span；消费者读到 span 为 0 即认为记录尚未提交，
+// 消费后把整段清零，因此缓冲区中未提交的位置总是 0。单生产者模式下由写位置发布记录
+struct RecordHeader {
+    std::atomic<uint32_t> span{0};  // 记录总字节数 (含头部和对齐)，0 表示尚未提交
+    uint32_t length{0};             // 负载长度，PADDING_LENGTH 表示回绕前的填充
+};
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader must be 8 bytes");
+
+// 零拷贝写入：reserve 返回缓冲区内的一段连续空间，写完后 commit
+struct WriteSlot {
+    uint8_t* data{nullptr};   // 可直接写入的共享内存
+    size_t size{0};           // 预留的字节数
+    uint64_t position{0};     // 内部使用
+};
+
+// 零拷贝读取：acquire 返回缓冲区内的数据视图，用完后 release
+struct ReadView {
+    const uint8_t* data{nullptr};  // 指向共享内存，release 之后失效
+    size_t size{0};
+    uint64_t begin{0};             // 内部使用
+    uint64_t end{0};               // 内部使用
+};
+
 // 跨进程事件通知接口
 class CrossProcessEvent {
 public:
@@ -42,14 +140,34 @@ public:
     virtual void close() = 0;
 };
 
-// SPSC环形缓冲区核心类
+// 环形缓冲区核心类 (单生产者或多生产者，单消费者)
 class RingBuffer {
 public:
     // 配置参数
     struct Config {
         size_t buffer_size{1024 * 1024};  // 默认1MB
         bool enable_events{true};         // 启用事件通知
+        // 等待前最多自旋的次数 (每次一个 pause)，ADAPTIVE 下按最近是否在自旋中等到而自适应调整；0 表示直接等待
+        int spin_iterations{2048};
+        WaitStrategy wait_strategy{WaitStrategy::ADAPTIVE};
+        // BUSY_POLL 下自旋之后 yield 的次数，用完后退回休眠；负数表示从不休眠
+        int yield_iterations{-1};
         std::string name;                 // 缓冲区名称（用于跨进程标识）
+        // 创建时写入头部；打开已存在的缓冲区时以头部为准。MULTI 要求 buffer_size 为 8 的倍数
+        ProducerMode producer_mode{ProducerMode::SINGLE};
+        // 按记录读写：每次 write 一条记录，read/peek/acquire 每次返回一条，不会把相邻的两次写入合并。
+        // 多生产者模式总是按记录；创建时写入头部，打开方沿用。要求 buffer_size 为 8 的倍数
+        bool record_framing{false};
+        // 镜像映射：数据区在虚拟内存中连续映射两次，任何不超过容量的数据都是连续的，
+        // 读写不再拆成两段。创建时生效并写入头部，打开方沿用；
+        // 要求 buffer_size 为 2 的幂且是页大小的倍数，目前仅支持 Linux
+        bool mirror_mapping{false};
+        // 内存选项：都只影响性能，不可用时输出警告后照常运行 (目前仅支持 Linux)
+        HugePagePolicy huge_pages{HugePagePolicy::NONE};
+        std::string hugetlbfs_path{"/dev/hugepages"};  // EXPLICIT 使用的 hugetlbfs 挂载点，双方须一致
+        bool prefault{false};     // 映射后立即为整个区域建立页表，避免运行中的缺页
+        bool lock_memory{false};  // mlock 整个映射，不被换出 (受 RLIMIT_MEMLOCK 限制)
+        int numa_node{-1};        // 优先从该 NUMA 节点分配页面 (在首次写入前设置)，-1 表示不指定
 
         Config(const std::string& buffer_name = "BitRPC_RingBuffer")
             : name(buffer_name) {}
@@ -74,30 +192,79 @@ public:
     void close();
 
     // 生产者接口
+    // 多生产者模式下可被多个线程/进程同时调用，每次写入一条完整记录
     bool write(const void* data, size_t size);
     bool write_atomic(const void* data, size_t size);  // 原子写入（全部成功或全部失败）
     size_t get_free_space() const;
     size_t get_capacity() const;
 
-    // 消费者接口
+    // 零拷贝生产者接口
+    // 按记录模式下每个预留是一条记录，commit 0 字节即放弃；多生产者可并发预留，预留后必须 commit。
+    // 单生产者同一时间只能有一个未提交的预留；字节流模式下未镜像映射时跨越缓冲区末尾的预留会失败，可改用 write
+    bool reserve(size_t size, WriteSlot& slot);
+    bool commit(const WriteSlot& slot, size_t size);  // size 不超过 slot.size
+
+    // 批量写入 (仅按记录模式)：一次预留 count 条记录的空间 (多生产者为一次 CAS)，
+    // 依次调用 encode(i, uint8_t* out) 把第 i 条的 size_of(i) 字节负载直接写入缓冲区，
+    // 最后只发布一次写位置、通知一次消费者。空间不够时只写入能放下的前若干条，返回写入的条数。
+    // size_of 对同一条记录会被调用多次，结果必须相同
+    template<typename SizeOf, typename Encoder>
+    size_t write_batch(size_t count, SizeOf&& size_of, Encoder&& encode);
+
+    // 消费者接口 (单消费者)
+    // 按记录模式下 read/peek 每次返回一条记录，缓冲区小于记录时返回 false 且不消费；
+    // skip 按整条记录跳过，bytes 必须等于若干条记录的负载长度之和
     bool read(void* buffer, size_t buffer_size, size_t& bytes_read);
     bool peek(void* buffer, size_t buffer_size, size_t& bytes_read) const;  // 查看但不移动读指针
     bool skip(size_t bytes);  // 跳过指定字节数
     size_t get_used_space() const;
 
+    // 零拷贝消费者接口
+    // 按记录模式下每次返回一条记录；字节流模式下返回全部连续可读数据 (未镜像映射时到缓冲区末尾为止)。
+    // 没有数据时返回 false。release 之前生产者不会覆盖这段数据
+    bool acquire(ReadView& view);
+    bool release(const ReadView& view);
+
+    // 批量消费 (仅按记录模式)：依次把最多 max_count 条记录交给 handler(const uint8_t* data, size_t size)，
+    // 全部处理完后只发布一次读位置、通知一次生产者。返回处理的记录数
+    template<typename Handler>
+    size_t consume(size_t max_count, Handler&& handler);
+
     // 状态查询
     bool is_connected() const;
     bool is_empty() const;
     bool is_full() const;
     std::string get_name() const { return config_.name; }
+    ProducerMode get_producer_mode() const { return config_.producer_mode; }
+    bool is_record_framed() const { return config_.record_framing; }
+    bool is_mirrored() const { return mirrored_; }
+    bool is_huge_page_backed() const { return huge_page_backed_; }  // 是否位于 hugetlbfs 上
+    // 单条记录的最大负载 (按记录模式下为容量的一半减去记录头，镜像映射时为容量减去记录头)
+    size_t get_max_record_size() const;
+
+    // 存活信息 (仅 v2 缓冲区；旧版本缓冲区上不做任何事，对端视为未连接)。
+    // 多生产者模式下生产者区记录最近连接的生产者，任何一个生产者的心跳都会刷新它
+    void attach_peer(RingPeer peer);  // 写入本进程 pid 并记一次心跳
+    void detach_peer(RingPeer peer);  // pid 仍是本进程时清零
+    void heartbeat(RingPeer peer);
+    RingPeerStatus get_peer_status(RingPeer peer) const;
+    bool is_peer_alive(RingPeer peer) const { return get_peer_status(peer).alive; }
 
     // 等待通知（用于消费者等待数据）
+    // v2 缓冲区在 Linux 下用头部中的 futex 字：先自旋，再登记为等待者后休眠；超时按单调时钟计算。
+    // 旧版本缓冲区和 Windows 使用命名信号量/事件
     bool wait_for_data(int timeout_ms = -1);
     bool notify_data_ready();  // 生产者通知数据就绪
+    // 生产者等待直到写入 size 字节能够成功 (按记录模式下已计入记录头和回绕填充)
+    bool wait_for_space(size_t size, int timeout_ms = -1);
+    // 让本对象上正在进行和之后的等待立即返回 false (用于停止等待线程)，close 后恢复
+    void cancel_waits();
 
 private:
     // 内部方法
-    bool allocate_memory();
+    bool allocate_memory(bool create);
+    bool open_hugetlbfs_file(bool create, size_t total_size);
+    void apply_memory_options();
     bool create_shared_objects();
     void cleanup();
     bool validate_header() const;
@@ -112,10 +279,43 @@ private:
     uint64_t get_read_position() const;
     void set_write_position(uint64_t pos);
     void set_read_position(uint64_t pos);
+    bool bind_layout();
+    RingBufferPeerInfo* peer_info(RingPeer peer) const {
+        return peer == RingPeer::PRODUCER ? producer_info_ : consumer_info_;
+    }
+    bool map_mirror(size_t data_offset);
+    size_t buffer_offset(uint64_t pos) const {
+        return power_of_two_ ? static_cast<size_t>(pos & index_mask_) : static_cast<size_t>(pos % config_.buffer_size);
+    }
+    // 对端位置的本地缓存，只在缓冲区看起来已满/为空时才重新读取共享的位置
+    uint64_t refresh_cached_read_position() const;
+    uint64_t refresh_cached_write_position() const;
+    bool has_free_space(uint64_t write_pos, uint64_t size) const;
+    size_t available_data(uint64_t read_pos, size_t wanted) const;
+
+    // 多生产者模式
+    bool write_record(const void* data, size_t size);
+    bool reserve_record(size_t size, WriteSlot& slot);
+    void commit_record(const WriteSlot& slot, size_t size);
+    static uint64_t record_span(size_t size) {
+        return (sizeof(RecordHeader) + size + RECORD_ALIGNMENT - 1) & ~uint64_t(RECORD_ALIGNMENT - 1);
+    }
+    RecordHeader* record_at(uint64_t pos) const;
+    // 从 pos 起找下一条已提交的记录；不越过 start 之后一整圈 (之后的内容是尚未清零的本批已读记录)
+    bool next_record(uint64_t start, uint64_t& pos, const RecordHeader*& record) const;
+    void release_records(uint64_t from, uint64_t to);
+
+    // 通知与等待
+    bool has_data() const;
+    bool can_write(size_t size) const;
+    void signal_data_ready();
+    void signal_space_available();
+    template<typename Condition>
+    bool wait_on(RingBufferWaitWord* word, CrossProcessEvent* event, Condition condition, int timeout_ms);
 
     // 内存屏障
-    void acquire_barrier();
-    void release_barrier();
+    void acquire_barrier() const;
+    void release_barrier() const;
 
 private:
     Config config_;
@@ -133,28 +333,145 @@ private:
     void* mapped_memory_{nullptr};
     size_t mapped_size_{0};
 
-    // 头部和缓冲区指针
+    // 头部和缓冲区指针 (header_ 指向元数据，v1/v2 相同)
     RingBufferHeader* header_{nullptr};
+    std::atomic<uint64_t>* write_pos_{nullptr};
+    std::atomic<uint64_t>* read_pos_{nullptr};
+    RingBufferPeerInfo* producer_info_{nullptr};  // v2 头部才有
+    RingBufferPeerInfo* consumer_info_{nullptr};
     uint8_t* buffer_{nullptr};
+    bool mirrored_{false};       // 数据区后紧跟着它的第二份映射
+    bool huge_page_backed_{false};
+    bool power_of_two_{false};   // 容量为 2 的幂时用掩码代替取模
+    uint64_t index_mask_{0};
 
-    // 跨进程同步事件
+    // 生产者缓存的读位置、消费者缓存的写位置；多生产者模式下生产者可能并发更新
+    mutable std::atomic<uint64_t> cached_read_pos_{0};
+    mutable std::atomic<uint64_t> cached_write_pos_{0};
+
+    // 跨进程同步：futex 字 (v2 头部，Linux) 或命名事件
+    RingBufferWaitWord* data_ready_word_{nullptr};
+    RingBufferWaitWord* space_available_word_{nullptr};
+    std::atomic<int> spin_budget_{0};  // 多生产者可能在多个线程里同时等待空间
+    std::atomic<bool> waits_cancelled_{false};
     std::unique_ptr<CrossProcessEvent> data_ready_event_;
     std::unique_ptr<CrossProcessEvent> space_available_event_;
 
     // 常量
     static constexpr uint32_t MAGIC_NUMBER = 0x42525446;  // "BRTF"
-    static constexpr size_t HEADER_SIZE = sizeof(RingBufferHeader);
+    static constexpr uint32_t HEADER_VERSION_V1 = 1;
+    static constexpr uint32_t HEADER_VERSION = 2;
+    static constexpr size_t HEADER_SIZE_V1 = sizeof(RingBufferHeader);
+    static constexpr size_t HEADER_SIZE = sizeof(RingBufferHeaderV2);
+    static constexpr uint8_t HEADER_FLAG_MIRRORED = 0x1;  // 数据区从页边界开始，各进程都做镜像映射
+    static constexpr uint8_t HEADER_FLAG_RECORDS = 0x2;   // 按记录读写
     static constexpr size_t ALIGNMENT = 64;  // 缓存行对齐
+    static constexpr size_t RECORD_ALIGNMENT = 8;
+    static constexpr uint32_t PADDING_LENGTH = 0xFFFFFFFF;
 };
 
+template<typename Handler>
+size_t RingBuffer::consume(size_t max_count, Handler&& handler) {
+    if (!initialized_ || !config_.record_framing) {
+        return 0;
+    }
+
+    uint64_t start = get_read_position();
+    uint64_t pos = start;
+    size_t count = 0;
+    const RecordHeader* record = nullptr;
+    while (count < max_count && next_record(start, pos, record)) {
+        handler(reinterpret_cast<const uint8_t*>(record + 1), static_cast<size_t>(record->length));
+        pos += record->span.load(std::memory_order_relaxed);
+        ++count;
+    }
+
+    // 回绕填充也在这里一并归还
+    if (pos != start) {
+        release_records(start, pos);
+    }
+    return count;
+}
+
+template<typename SizeOf, typename Encoder>
+size_t RingBuffer::write_batch(size_t count, SizeOf&& size_of, Encoder&& encode) {
+    if (!initialized_ || !config_.record_framing || count == 0) {
+        return 0;
+    }
+
+    const uint64_t ring_size = config_.buffer_size;
+    const size_t max_record = get_max_record_size();
+    const bool multi_producer = config_.producer_mode == ProducerMode::MULTI;
+
+    // 先确定能放下的前 n 条 (含回绕填充) 和整段的结束位置；多生产者用一次 CAS 预留整段
+    uint64_t tail = write_pos_->load(std::memory_order_relaxed);
+    uint64_t end = tail;
+    size_t n = 0;
+    for (;;) {
+        end = tail;
+        n = 0;
+        while (n < count) {
+            size_t size = size_of(n);
+            if (size == 0 || size > max_record) {
+                break;
+            }
+            uint64_t span = record_span(size);
+            uint64_t to_end = ring_size - buffer_offset(end);
+            uint64_t padding = (!mirrored_ && span > to_end) ? to_end : 0;
+            if (!has_free_space(tail, end + padding + span - tail)) {
+                break;
+            }
+            end += padding + span;
+            ++n;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        if (!multi_producer ||
+            write_pos_->compare_exchange_weak(tail, end, std::memory_order_relaxed, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // 逐条编码；多生产者每条记录仍以 release 写入 span 提交，单生产者最后发布一次写位置
+    uint64_t pos = tail;
+    for (size_t i = 0; i < n; ++i) {
+        size_t size = size_of(i);
+        uint64_t span = record_span(size);
+        uint64_t to_end = ring_size - buffer_offset(pos);
+        if (!mirrored_ && span > to_end) {
+            RecordHeader* filler = record_at(pos);
+            filler->length = PADDING_LENGTH;
+            filler->span.store(static_cast<uint32_t>(to_end), std::memory_order_release);
+            pos += to_end;
+        }
+        RecordHeader* record = record_at(pos);
+        encode(i, reinterpret_cast<uint8_t*>(record + 1));
+        record->length = static_cast<uint32_t>(size);
+        record->span.store(static_cast<uint32_t>(span),
+                           multi_producer ? std::memory_order_release : std::memory_order_relaxed);
+        pos += span;
+    }
+
+    if (!multi_producer) {
+        set_write_position(end);
+    }
+    signal_data_ready();
+    return n;
+}
+
 // 工厂方法创建环形缓冲区
 class RingBufferFactory {
 public:
-    static std::unique_ptr<RingBuffer> create_producer(const std::string& name, size_t buffer_size = 1024 * 1024);
+    static std::unique_ptr<RingBuffer> create_producer(const std::string& name, size_t buffer_size = 1024 * 1024,
+                                                       ProducerMode producer_mode = ProducerMode::SINGLE);
     static std::unique_ptr<RingBuffer> create_consumer(const std::string& name, size_t buffer_size = 1024 * 1024);
     static bool remove_ring_buffer(const std::string& name);
 };
 
+// 把当前线程绑定到指定 CPU (忙轮询的消费者线程用)；不支持的平台返回 false
+bool pin_current_thread(int cpu);
+
 // 数据序列化助手
 template<typename T>
 bool write_data(RingBuffer& buffer, const T& data) {
@@ -164,7 +481,7 @@ bool write_data(RingBuffer& buffer, const T& data) {
 template<typename T>
 bool read_data(RingBuffer& buffer, T& data) {
     size_t bytes_read = 0;
-    return buffer.read(&data, sizeof(T), bytes_read) && bytes_read == sizeof(T));
+    return buffer.read(&data, sizeof(T), bytes_read) && bytes_read == sizeof(T);
 }
 
 } // namespace shared_memory
@@ -0,0 +1,63 @@
+#include "ring_stream_writer.h"
+
+namespace bitrpc {
+namespace shared_memory {
+
+RingStreamWriter::RingStreamWriter(RingBuffer& ring, size_t expected_size)
+    : ring_(ring), resource_(slot_), writer_(&resource_) {
+    if (expected_size > 0 && ring_.reserve(expected_size, slot_)) {
+        writer_.reserve(slot_.size);
+    } else {
+        slot_ = WriteSlot{};
+    }
+}
+
+RingStreamWriter::~RingStreamWriter() {
+    if (!committed_) {
+        abandon();
+    }
+}
+
+bool RingStreamWriter::commit() {
+    if (committed_) {
+        return false;
+    }
+    committed_ = true;
+
+    if (is_zero_copy()) {
+        return ring_.commit(slot_, writer_.size());
+    }
+
+    // 超出预计大小：放弃预留，按普通写入发送
+    abandon();
+    return writer_.size() > 0 && ring_.write(writer_.data(), writer_.size());
+}
+
+void RingStreamWriter::abandon() {
+    if (slot_.data != nullptr) {
+        ring_.commit(slot_, 0);
+        slot_ = WriteSlot{};
+    }
+}
+
+void* RingStreamWriter::SlotResource::do_allocate(size_t bytes, size_t alignment) {
+    if (handed_out_ == nullptr && slot_.data != nullptr && bytes <= slot_.size) {
+        handed_out_ = slot_.data;
+        return handed_out_;
+    }
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void RingStreamWriter::SlotResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    // 共享内存由环形缓冲区管理
+    if (p != handed_out_) {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+}
+
+bool RingStreamWriter::SlotResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace shared_memory
+} // namespace bitrpc
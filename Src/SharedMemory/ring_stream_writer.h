@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ring_buffer.h"
+#include "serialization.h"
+#include <memory_resource>
+
+namespace bitrpc {
+namespace shared_memory {
+
+// 把 BitRPC 消息直接序列化进环形缓冲区
+// 构造时按预计大小 reserve，StreamWriter 的存储就是这段共享内存，commit 只发布不拷贝；
+// 实际大小超过预计 (或预留失败) 时 StreamWriter 改用堆内存，commit 退回普通 write
+class RingStreamWriter {
+public:
+    RingStreamWriter(RingBuffer& ring, size_t expected_size);
+    ~RingStreamWriter();  // 未提交时放弃预留
+
+    RingStreamWriter(const RingStreamWriter&) = delete;
+    RingStreamWriter& operator=(const RingStreamWriter&) = delete;
+
+    StreamWriter& writer() { return writer_; }
+    // 数据仍在预留的共享内存中 (commit 时零拷贝)
+    bool is_zero_copy() const { return slot_.data != nullptr && writer_.data() == slot_.data; }
+
+    bool commit();
+
+private:
+    // 第一次分配交出预留的共享内存，其余分配交给堆
+    class SlotResource : public std::pmr::memory_resource {
+    public:
+        explicit SlotResource(const WriteSlot& slot) : slot_(slot) {}
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        const WriteSlot& slot_;
+        void* handed_out_{nullptr};  // 放弃预留后 slot_ 被清空，释放时仍要认出这块内存
+    };
+
+    void abandon();
+
+    RingBuffer& ring_;
+    WriteSlot slot_;
+    SlotResource resource_;
+    StreamWriter writer_;
+    bool committed_{false};
+};
+
+} // namespace shared_memory
+} // namespace bitrpc
@@ -5,6 +5,24 @@
 namespace bitrpc {
 namespace shared_memory {
 
+namespace {
+
+// 接收函数复用每个线程的消息对象，负载容量会停留在收到过的最大消息。
+// 超过这个大小的负载 (例如经块池传递的大消息) 用完即释放，常见的小消息仍然不分配内存
+constexpr size_t SCRATCH_PAYLOAD_LIMIT = 64 * 1024;
+
+// 在接收函数返回时释放过大的负载
+struct ReleaseLargePayload {
+    SharedMemoryMessage& message;
+    ~ReleaseLargePayload() {
+        if (message.get_payload_size() > SCRATCH_PAYLOAD_LIMIT) {
+            message = SharedMemoryMessage();
+        }
+    }
+};
+
+} // namespace
+
 // 全局错误状态
 static std::string last_error;
 static std::mutex error_mutex;
@@ -21,13 +39,27 @@ const char* RB_GetLastError() {
 
 // C风格API实现
 RingBufferHandle RB_CreateProducer(const char* name, size_t buffer_size) {
+    return RB_CreateProducerEx(name, buffer_size, 0);
+}
+
+RingBufferHandle RB_CreateConsumer(const char* name, size_t buffer_size) {
+    return RB_CreateConsumerEx(name, buffer_size, 0);
+}
+
+RingBufferHandle RB_CreateProducerEx(const char* name, size_t buffer_size, int flags) {
     if (!name) {
         RB_SetLastError("Invalid name parameter");
         return nullptr;
     }
 
     try {
-        auto buffer = std::make_unique<RingBuffer>(RingBuffer::Config(name));
+        RingBuffer::Config config(name);
+        config.buffer_size = buffer_size;
+        if (flags & RB_FLAG_MULTI_PRODUCER) {
+            config.producer_mode = ProducerMode::MULTI;
+        }
+        config.mirror_mapping = (flags & RB_FLAG_MIRROR_MAPPING) != 0;
+        auto buffer = std::make_unique<RingBuffer>(config);
         if (!buffer->create(RingBuffer::CreateMode::CREATE_OR_OPEN)) {
             RB_SetLastError("Failed to create ring buffer");
             return nullptr;
@@ -39,18 +71,24 @@ RingBufferHandle RB_CreateProducer(const char* name, size_t buffer_size) {
     }
 }
 
-RingBufferHandle RB_CreateConsumer(const char* name, size_t buffer_size) {
+RingBufferHandle RB_CreateConsumerEx(const char* name, size_t buffer_size, int flags) {
     if (!name) {
         RB_SetLastError("Invalid name parameter");
         return nullptr;
     }
 
     try {
-        auto buffer = std::make_unique<RingBuffer>(RingBuffer::Config(name));
+        RingBuffer::Config config(name);
+        config.buffer_size = buffer_size;
+        auto buffer = std::make_unique<RingBuffer>(config);
         if (!buffer->create(RingBuffer::CreateMode::OPEN_ONLY)) {
             RB_SetLastError("Failed to open ring buffer");
             return nullptr;
         }
+        if ((flags & RB_FLAG_MULTI_PRODUCER) && buffer->get_producer_mode() != ProducerMode::MULTI) {
+            RB_SetLastError("Ring buffer is not in multi-producer mode");
+            return nullptr;
+        }
         return buffer.release();
     } catch (const std::exception& e) {
         RB_SetLastError(e.what());
@@ -144,6 +182,10 @@ int RB_IsConnected(RingBufferHandle handle) {
 
 // 共享内存管理器C API
 SharedMemoryManagerHandle SMM_CreateProducer(const char* name, size_t buffer_size) {
+    return SMM_CreateProducerEx(name, buffer_size, 0);
+}
+
+SharedMemoryManagerHandle SMM_CreateProducerEx(const char* name, size_t buffer_size, int flags) {
     if (!name) {
         RB_SetLastError("Invalid name parameter");
         return nullptr;
@@ -152,6 +194,10 @@ SharedMemoryManagerHandle SMM_CreateProducer(const char* name, size_t buffer_siz
     try {
         auto config = SharedMemoryManager::Config(name);
         config.buffer_size = buffer_size;
+        if (flags & RB_FLAG_MULTI_PRODUCER) {
+            config.producer_mode = ProducerMode::MULTI;
+        }
+        config.mirror_mapping = (flags & RB_FLAG_MIRROR_MAPPING) != 0;
         auto manager = std::make_unique<SharedMemoryManager>(config);
         if (!manager->start_producer()) {
             RB_SetLastError("Failed to start producer");
@@ -173,6 +219,7 @@ SharedMemoryManagerHandle SMM_CreateConsumer(const char* name, size_t buffer_siz
     try {
         auto config = SharedMemoryManager::Config(name);
         config.buffer_size = buffer_size;
+        config.consumer_worker = false;  // 由 SMM_ReceiveMessage 取消息
         auto manager = std::make_unique<SharedMemoryManager>(config);
         if (!manager->start_consumer()) {
             RB_SetLastError("Failed to start consumer");
@@ -216,7 +263,9 @@ int SMM_ReceiveMessage(SharedMemoryManagerHandle handle, void* buffer, size_t bu
 
     try {
         auto* manager = static_cast<SharedMemoryManager*>(handle);
-        SharedMemoryMessage message;
+        // 每个线程复用同一个消息对象，负载容量足够后不再分配内存 (大负载除外，见 SCRATCH_PAYLOAD_LIMIT)
+        thread_local SharedMemoryMessage message;
+        ReleaseLargePayload release{message};
         if (!manager->receive_message(message, timeout_ms)) {
             return 0;
         }
@@ -250,9 +299,37 @@ int SMM_IsRunning(SharedMemoryManagerHandle handle) {
     }
 }
 
+int SMM_SendHeartbeat(SharedMemoryManagerHandle handle) {
+    if (!handle) {
+        return 0;
+    }
+
+    try {
+        auto* manager = static_cast<SharedMemoryManager*>(handle);
+        return manager->send_heartbeat() ? 1 : 0;
+    } catch (const std::exception& e) {
+        RB_SetLastError(e.what());
+        return 0;
+    }
+}
+
+int SMM_IsPeerAlive(SharedMemoryManagerHandle handle) {
+    if (!handle) {
+        return 0;
+    }
+
+    try {
+        auto* manager = static_cast<SharedMemoryManager*>(handle);
+        return manager->is_peer_alive() ? 1 : 0;
+    } catch (const std::exception& e) {
+        RB_SetLastError(e.what());
+        return 0;
+    }
+}
+
 // C++封装类实现
-SharedMemoryProducer::SharedMemoryProducer(const std::string& name, size_t buffer_size)
-    : name_(name), buffer_size_(buffer_size) {
+SharedMemoryProducer::SharedMemoryProducer(const std::string& name, size_t buffer_size, ProducerMode producer_mode)
+    : name_(name), buffer_size_(buffer_size), producer_mode_(producer_mode) {
 }
 
 SharedMemoryProducer::~SharedMemoryProducer() {
@@ -267,6 +344,7 @@ bool SharedMemoryProducer::connect() {
     try {
         auto config = SharedMemoryManager::Config(name_);
         config.buffer_size = buffer_size_;
+        config.producer_mode = producer_mode_;
         manager_ = std::make_unique<SharedMemoryManager>(config);
 
         if (!manager_->start_producer()) {
@@ -334,16 +412,7 @@ size_t SharedMemoryProducer::send_batch(const std::vector<std::vector<uint8_t>>&
         return 0;
     }
 
-    size_t sent_count = 0;
-    for (const auto& data : data_batch) {
-        if (send(data)) {
-            sent_count++;
-        } else {
-            break;
-        }
-    }
-
-    return sent_count;
+    return manager_->send_batch(MessageType::DATA, data_batch);
 }
 
 size_t SharedMemoryProducer::send_message_batch(const std::vector<SharedMemoryMessage>& messages) {
@@ -375,9 +444,8 @@ bool SharedMemoryProducer::is_full() const {
     return get_free_space() == 0;
 }
 
-const SharedMemoryManager::Statistics& SharedMemoryProducer::get_statistics() const {
-    static SharedMemoryManager::Statistics empty_stats;
-    return is_connected() ? manager_->get_statistics() : empty_stats;
+SharedMemoryManager::Statistics SharedMemoryProducer::get_statistics() const {
+    return is_connected() ? manager_->get_statistics() : SharedMemoryManager::Statistics{};
 }
 
 void SharedMemoryProducer::reset_statistics() {
@@ -395,6 +463,10 @@ bool SharedMemoryProducer::send_heartbeat() {
     return manager_->send_heartbeat();
 }
 
+bool SharedMemoryProducer::is_consumer_alive() const {
+    return is_connected() && manager_->is_peer_alive();
+}
+
 std::string SharedMemoryProducer::get_last_error() const {
     return last_error_;
 }
@@ -424,6 +496,7 @@ bool SharedMemoryConsumer::connect() {
     try {
         auto config = SharedMemoryManager::Config(name_);
         config.buffer_size = buffer_size_;
+        config.consumer_worker = false;  // receive* 由调用方取消息，处理器在取出时调用
         manager_ = std::make_unique<SharedMemoryManager>(config);
 
         if (!manager_->start_consumer()) {
@@ -456,7 +529,9 @@ bool SharedMemoryConsumer::receive(std::vector<uint8_t>& data, int timeout_ms) {
         return false;
     }
 
-    SharedMemoryMessage message;
+    // 每个线程复用同一个消息对象；data 的容量也由调用方复用
+    thread_local SharedMemoryMessage message;
+    ReleaseLargePayload release{message};
     if (manager_->receive_message(message, timeout_ms)) {
         data.assign(message.get_payload(), message.get_payload() + message.get_payload_size());
         return true;
@@ -466,9 +541,15 @@ bool SharedMemoryConsumer::receive(std::vector<uint8_t>& data, int timeout_ms) {
 }
 
 bool SharedMemoryConsumer::receive_string(std::string& str, int timeout_ms) {
-    std::vector<uint8_t> data;
-    if (receive(data, timeout_ms)) {
-        str.assign(data.begin(), data.end());
+    if (!is_connected()) {
+        set_error("Not connected");
+        return false;
+    }
+
+    thread_local SharedMemoryMessage message;
+    ReleaseLargePayload release{message};
+    if (manager_->receive_message(message, timeout_ms)) {
+        str.assign(reinterpret_cast<const char*>(message.get_payload()), message.get_payload_size());
         return true;
     }
     return false;
@@ -480,7 +561,8 @@ bool SharedMemoryConsumer::peek(std::vector<uint8_t>& data) const {
         return false;
     }
 
-    SharedMemoryMessage message;
+    thread_local SharedMemoryMessage message;
+    ReleaseLargePayload release{message};
     if (manager_->peek_message(message)) {
         data.assign(message.get_payload(), message.get_payload() + message.get_payload_size());
         return true;
@@ -568,9 +650,8 @@ bool SharedMemoryConsumer::is_full() const {
     return get_free_space() == 0;
 }
 
-const SharedMemoryManager::Statistics& SharedMemoryConsumer::get_statistics() const {
-    static SharedMemoryManager::Statistics empty_stats;
-    return is_connected() ? manager_->get_statistics() : empty_stats;
+SharedMemoryManager::Statistics SharedMemoryConsumer::get_statistics() const {
+    return is_connected() ? manager_->get_statistics() : SharedMemoryManager::Statistics{};
 }
 
 void SharedMemoryConsumer::reset_statistics() {
@@ -589,7 +670,11 @@ bool SharedMemoryConsumer::wait_for_heartbeat(int timeout_ms) {
 }
 
 uint64_t SharedMemoryConsumer::get_last_heartbeat_time() const {
-    return 0; // 简化实现
+    return is_connected() ? manager_->get_last_heartbeat_time() : 0;
+}
+
+bool SharedMemoryConsumer::is_producer_alive() const {
+    return is_connected() && manager_->is_peer_alive();
 }
 
 bool SharedMemoryConsumer::clear_buffer() {
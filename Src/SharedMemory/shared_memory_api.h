@@ -13,8 +13,16 @@ extern "C" {
     // 环形缓冲区API
     typedef void* RingBufferHandle;
 
+    // RB_CreateProducerEx / RB_CreateConsumerEx / SMM_CreateProducerEx 的标志位
+    enum {
+        RB_FLAG_MULTI_PRODUCER = 0x1,  // 多生产者记录模式；消费者传入时要求缓冲区确实是该模式
+        RB_FLAG_MIRROR_MAPPING = 0x2   // 数据区镜像映射 (仅创建时生效)；buffer_size 须为 2 的幂且是页大小的倍数
+    };
+
     RingBufferHandle RB_CreateProducer(const char* name, size_t buffer_size);
     RingBufferHandle RB_CreateConsumer(const char* name, size_t buffer_size);
+    RingBufferHandle RB_CreateProducerEx(const char* name, size_t buffer_size, int flags);
+    RingBufferHandle RB_CreateConsumerEx(const char* name, size_t buffer_size, int flags);
     void RB_Close(RingBufferHandle handle);
 
     int RB_Write(RingBufferHandle handle, const void* data, size_t size);
@@ -27,12 +35,16 @@ extern "C" {
     typedef void* SharedMemoryManagerHandle;
 
     SharedMemoryManagerHandle SMM_CreateProducer(const char* name, size_t buffer_size);
+    SharedMemoryManagerHandle SMM_CreateProducerEx(const char* name, size_t buffer_size, int flags);
     SharedMemoryManagerHandle SMM_CreateConsumer(const char* name, size_t buffer_size);
     void SMM_Destroy(SharedMemoryManagerHandle handle);
 
     int SMM_SendMessage(SharedMemoryManagerHandle handle, int message_type, const void* data, size_t size);
     int SMM_ReceiveMessage(SharedMemoryManagerHandle handle, void* buffer, size_t buffer_size, size_t* bytes_read, int timeout_ms);
     int SMM_IsRunning(SharedMemoryManagerHandle handle);
+    // 心跳和对端存活检查经缓冲区头部，不占用数据区
+    int SMM_SendHeartbeat(SharedMemoryManagerHandle handle);
+    int SMM_IsPeerAlive(SharedMemoryManagerHandle handle);
 
     // 工具函数
     void RB_SetLastError(const char* error);
@@ -42,7 +54,9 @@ extern "C" {
 // C++封装类
 class SharedMemoryProducer {
 public:
-    explicit SharedMemoryProducer(const std::string& name, size_t buffer_size = 1024 * 1024);
+    // 多个生产者共用一个缓冲区时，创建方需使用 ProducerMode::MULTI
+    explicit SharedMemoryProducer(const std::string& name, size_t buffer_size = 1024 * 1024,
+                                  ProducerMode producer_mode = ProducerMode::SINGLE);
     ~SharedMemoryProducer();
 
     // 禁用拷贝
@@ -75,11 +89,12 @@ public:
     bool is_full() const;
 
     // 统计信息
-    const SharedMemoryManager::Statistics& get_statistics() const;
+    SharedMemoryManager::Statistics get_statistics() const;
     void reset_statistics();
 
-    // 心跳
+    // 心跳 (写入缓冲区头部) 和消费者存活检查
     bool send_heartbeat();
+    bool is_consumer_alive() const;
 
     // 错误处理
     std::string get_last_error() const;
@@ -88,6 +103,7 @@ public:
 private:
     std::string name_;
     size_t buffer_size_;
+    ProducerMode producer_mode_;
     std::unique_ptr<SharedMemoryManager> manager_;
     mutable std::string last_error_;
 
@@ -121,7 +137,7 @@ public:
     size_t receive_batch(std::vector<std::vector<uint8_t>>& data_batch, size_t max_count, int timeout_ms = -1);
     size_t receive_message_batch(std::vector<SharedMemoryMessage>& messages, size_t max_count, int timeout_ms = -1);
 
-    // 消息处理
+    // 消息处理：消费者不启动工作线程，处理器在 receive* 取出消息时调用
     void register_handler(MessageType type, std::function<bool(const SharedMemoryMessage&)> handler);
     void unregister_handler(MessageType type);
 
@@ -133,12 +149,13 @@ public:
     bool is_full() const;
 
     // 统计信息
-    const SharedMemoryManager::Statistics& get_statistics() const;
+    SharedMemoryManager::Statistics get_statistics() const;
     void reset_statistics();
 
     // 心跳和健康检查
     bool wait_for_heartbeat(int timeout_ms = 2000);
-    uint64_t get_last_heartbeat_time() const;
+    uint64_t get_last_heartbeat_time() const;  // 单调时钟纳秒，0 表示还没有
+    bool is_producer_alive() const;
 
     // 缓冲区管理
     bool clear_buffer();
@@ -229,8 +246,9 @@ private:
 
 // 便捷工厂函数
 inline std::unique_ptr<SharedMemoryProducer> create_producer(
-    const std::string& name, size_t buffer_size = 1024 * 1024) {
-    auto producer = std::make_unique<SharedMemoryProducer>(name, buffer_size);
+    const std::string& name, size_t buffer_size = 1024 * 1024,
+    ProducerMode producer_mode = ProducerMode::SINGLE) {
+    auto producer = std::make_unique<SharedMemoryProducer>(name, buffer_size, producer_mode);
     if (producer->connect()) {
         return producer;
     }
@@ -22,6 +22,10 @@ except:
     except:
         raise RuntimeError("Cannot load shared memory native library")
 
+# RB_CreateProducerEx / RB_CreateConsumerEx / SMM_CreateProducerEx 的标志位
+RB_FLAG_MULTI_PRODUCER = 0x1
+RB_FLAG_MIRROR_MAPPING = 0x2
+
 # 定义消息类型
 class MessageType(IntEnum):
     DATA = 1
@@ -77,7 +81,7 @@ class SharedMemoryMessage:
 
         self.message_type = message_type
         self.payload = payload or b''
-        self.timestamp = int(time.time() * 1000)  # 毫秒时间戳
+        self.timestamp = time.monotonic_ns()  # 单调时钟纳秒时间戳，与 C++ 端一致
         self.flags = MessageFlags.NONE
 
     def serialize(self) -> bytes:
@@ -128,6 +132,8 @@ class SharedMemoryMessage:
 
 # 定义C函数接口
 class NativeMethods:
+    _lib = _lib
+
     # 环形缓冲区API
     _lib.RB_CreateProducer.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
     _lib.RB_CreateProducer.restype = ctypes.c_void_p
@@ -135,6 +141,12 @@ class NativeMethods:
     _lib.RB_CreateConsumer.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
     _lib.RB_CreateConsumer.restype = ctypes.c_void_p
 
+    _lib.RB_CreateProducerEx.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.c_int]
+    _lib.RB_CreateProducerEx.restype = ctypes.c_void_p
+
+    _lib.RB_CreateConsumerEx.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.c_int]
+    _lib.RB_CreateConsumerEx.restype = ctypes.c_void_p
+
     _lib.RB_Close.argtypes = [ctypes.c_void_p]
     _lib.RB_Close.restype = None
 
@@ -157,6 +169,9 @@ class NativeMethods:
     _lib.SMM_CreateProducer.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
     _lib.SMM_CreateProducer.restype = ctypes.c_void_p
 
+    _lib.SMM_CreateProducerEx.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.c_int]
+    _lib.SMM_CreateProducerEx.restype = ctypes.c_void_p
+
     _lib.SMM_CreateConsumer.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
     _lib.SMM_CreateConsumer.restype = ctypes.c_void_p
 
@@ -172,6 +187,12 @@ class NativeMethods:
     _lib.SMM_IsRunning.argtypes = [ctypes.c_void_p]
     _lib.SMM_IsRunning.restype = ctypes.c_int
 
+    _lib.SMM_SendHeartbeat.argtypes = [ctypes.c_void_p]
+    _lib.SMM_SendHeartbeat.restype = ctypes.c_int
+
+    _lib.SMM_IsPeerAlive.argtypes = [ctypes.c_void_p]
+    _lib.SMM_IsPeerAlive.restype = ctypes.c_int
+
     # 错误处理
     _lib.RB_SetLastError.argtypes = [ctypes.c_char_p]
     _lib.RB_SetLastError.restype = None
@@ -247,15 +268,18 @@ class RingBuffer:
 
 # 共享内存生产者
 class SharedMemoryProducer(RingBuffer):
-    def __init__(self, name: str, buffer_size: int = 1024 * 1024):
+    def __init__(self, name: str, buffer_size: int = 1024 * 1024, multi_producer: bool = False):
+        """multi_producer: 多个生产者共用一个缓冲区 (由创建方决定，之后打开的生产者沿用)"""
         super().__init__(name, buffer_size)
+        self.multi_producer = multi_producer
 
     def connect(self) -> bool:
         """连接到共享内存"""
         if self.is_connected:
             return True
 
-        self._handle = NativeMethods._lib.RB_CreateProducer(self.name, self.buffer_size)
+        flags = RB_FLAG_MULTI_PRODUCER if self.multi_producer else 0
+        self._handle = NativeMethods._lib.RB_CreateProducerEx(self.name, self.buffer_size, flags)
         return self.is_connected
 
     def send(self, data: bytes) -> bool:
@@ -385,9 +409,10 @@ class SharedMemoryConsumer(RingBuffer):
 
 # 高级共享内存管理器
 class SharedMemoryManager:
-    def __init__(self, name: str, buffer_size: int = 1024 * 1024):
+    def __init__(self, name: str, buffer_size: int = 1024 * 1024, multi_producer: bool = False):
         self.name = name.encode('utf-8')
         self.buffer_size = buffer_size
+        self.multi_producer = multi_producer
         self._handle = None
         self._disposed = False
         self._is_producer = False
@@ -407,7 +432,8 @@ class SharedMemoryManager:
         if self.is_running:
             return True
 
-        self._handle = NativeMethods._lib.SMM_CreateProducer(self.name, self.buffer_size)
+        flags = RB_FLAG_MULTI_PRODUCER if self.multi_producer else 0
+        self._handle = NativeMethods._lib.SMM_CreateProducerEx(self.name, self.buffer_size, flags)
         self._is_producer = True
         return self.is_running
 
@@ -431,6 +457,11 @@ class SharedMemoryManager:
             return False
         return NativeMethods._lib.SMM_IsRunning(self._handle) != 0
 
+    @property
+    def is_peer_alive(self) -> bool:
+        """对端进程是否仍然存在 (按缓冲区头部中的 pid 检查)"""
+        return self.is_running and NativeMethods._lib.SMM_IsPeerAlive(self._handle) != 0
+
     @property
     def is_producer(self) -> bool:
         """是否为生产者"""
@@ -489,8 +520,8 @@ class SharedMemoryManager:
             return None
 
     def send_heartbeat(self) -> bool:
-        """发送心跳"""
-        return self.send_message_data(MessageType.HEARTBEAT, b'')
+        """发送心跳 (写入缓冲区头部，不经过数据区)"""
+        return self.is_running and NativeMethods._lib.SMM_SendHeartbeat(self._handle) != 0
 
     def get_last_error(self) -> str:
         """获取最后错误"""
@@ -499,9 +530,10 @@ class SharedMemoryManager:
 # 工厂方法
 class SharedMemoryFactory:
     @staticmethod
-    def create_producer(name: str, buffer_size: int = 1024 * 1024) -> Optional[SharedMemoryProducer]:
+    def create_producer(name: str, buffer_size: int = 1024 * 1024,
+                        multi_producer: bool = False) -> Optional[SharedMemoryProducer]:
         """创建生产者"""
-        producer = SharedMemoryProducer(name, buffer_size)
+        producer = SharedMemoryProducer(name, buffer_size, multi_producer)
         if producer.connect():
             return producer
         return None
@@ -603,9 +635,10 @@ class TypedSharedMemoryConsumer:
         return result
 
 # 便利函数
-def create_producer(name: str, buffer_size: int = 1024 * 1024) -> Optional[SharedMemoryProducer]:
+def create_producer(name: str, buffer_size: int = 1024 * 1024,
+                    multi_producer: bool = False) -> Optional[SharedMemoryProducer]:
     """创建生产者的便利函数"""
-    return SharedMemoryFactory.create_producer(name, buffer_size)
+    return SharedMemoryFactory.create_producer(name, buffer_size, multi_producer)
 
 def create_consumer(name: str, buffer_size: int = 1024 * 1024) -> Optional[SharedMemoryConsumer]:
     """创建消费者的便利函数"""
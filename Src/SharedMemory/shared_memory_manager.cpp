@@ -6,6 +6,19 @@
 namespace bitrpc {
 namespace shared_memory {
 
+namespace {
+constexpr size_t WORKER_BATCH_SIZE = 64;  // 消费者工作线程每次最多取出的消息数
+constexpr std::chrono::milliseconds HEARTBEAT_POLL_INTERVAL(10);  // wait_for_heartbeat 检查头部的间隔
+constexpr uint64_t BUFFER_USAGE_SAMPLE_INTERVAL = 64;  // 每个统计分片每收发这么多条消息读一次缓冲区占用
+
+// 当前线程使用的统计分片：线程第一次更新统计时轮流分配
+size_t statistics_shard(size_t shard_count) {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed);
+    return shard % shard_count;
+}
+}
+
 // SharedMemoryMessage实现
 std::atomic<uint32_t> SharedMemoryMessage::next_id_(1);
 
@@ -17,8 +30,7 @@ SharedMemoryMessage::SharedMemoryMessage(MessageType type, const void* data, siz
     header_.message_id = next_id_.fetch_add(1);
     header_.message_type = static_cast<uint32_t>(type);
     header_.payload_size = static_cast<uint32_t>(size);
-    header_.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    header_.timestamp = now_timestamp();
     header_.flags = 0;
 
     if (data && size > 0) {
@@ -26,6 +38,31 @@ SharedMemoryMessage::SharedMemoryMessage(MessageType type, const void* data, siz
     }
 }
 
+void SharedMemoryMessage::encode_to(uint8_t* out, uint32_t id, MessageType type, uint64_t timestamp,
+                                    const void* data, size_t size) {
+    MessageHeader header;
+    header.message_id = id;
+    header.message_type = static_cast<uint32_t>(type);
+    header.payload_size = static_cast<uint32_t>(size);
+    header.timestamp = timestamp;
+    header.flags = 0;
+    std::memset(header.reserved, 0, sizeof(header.reserved));
+    std::memcpy(out, &header, sizeof(MessageHeader));
+    if (size > 0) {
+        std::memcpy(out + sizeof(MessageHeader), data, size);
+    }
+}
+
+uint32_t SharedMemoryMessage::allocate_ids(size_t count) {
+    return next_id_.fetch_add(static_cast<uint32_t>(count));
+}
+
+uint64_t SharedMemoryMessage::now_timestamp() {
+    // steady_clock 在 Linux 上是 CLOCK_MONOTONIC、在 Windows 上是 QPC，都是系统范围的时钟
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void SharedMemoryMessage::set_payload(const void* data, size_t size) {
     header_.payload_size = static_cast<uint32_t>(size);
     if (data && size > 0) {
@@ -49,6 +86,13 @@ std::vector<uint8_t> SharedMemoryMessage::serialize() const {
     return data;
 }
 
+void SharedMemoryMessage::serialize_to(uint8_t* out) const {
+    std::memcpy(out, &header_, sizeof(MessageHeader));
+    if (!payload_.empty()) {
+        std::memcpy(out + sizeof(MessageHeader), payload_.data(), payload_.size());
+    }
+}
+
 bool SharedMemoryMessage::deserialize(const uint8_t* data, size_t size) {
     if (size < sizeof(MessageHeader)) {
         return false;
@@ -62,8 +106,13 @@ bool SharedMemoryMessage::deserialize(const uint8_t* data, size_t size) {
         return false;
     }
 
-    // 读取负载
-    payload_.assign(data + sizeof(MessageHeader), data + size);
+    // 读取负载 (只取头部声明的长度，后面的字节不属于这条消息)。
+    // 反复接收到同一个对象时复用容量，容量不够时按倍数增长，很快就不再分配
+    const uint8_t* payload = data + sizeof(MessageHeader);
+    if (payload_.capacity() < header_.payload_size) {
+        payload_.reserve(std::max<size_t>(header_.payload_size, payload_.capacity() * 2));
+    }
+    payload_.assign(payload, payload + header_.payload_size);
 
     return true;
 }
@@ -82,17 +131,32 @@ bool SharedMemoryManager::start_producer() {
     }
 
     // 创建环形缓冲区
-    ring_buffer_ = std::make_unique<RingBuffer>(RingBuffer::Config(config_.instance_name));
+    ring_buffer_ = std::make_unique<RingBuffer>(make_ring_config());
     if (!ring_buffer_->create(RingBuffer::CreateMode::CREATE_OR_OPEN)) {
         return false;
     }
 
+    // 创建块池
+    if (config_.slab_block_size > 0 && config_.slab_block_count > 0) {
+        SlabPool::Config slab_config(config_.instance_name);
+        slab_config.block_size = config_.slab_block_size;
+        slab_config.block_count = config_.slab_block_count;
+        slab_pool_ = std::make_unique<SlabPool>(slab_config);
+        if (!slab_pool_->create()) {
+            slab_pool_.reset();
+            ring_buffer_->close();
+            ring_buffer_.reset();
+            return false;
+        }
+        slab_pool_ptr_.store(slab_pool_.get(), std::memory_order_release);
+    }
+
     running_ = true;
     is_producer_ = true;
 
     // 启动工作线程
     worker_thread_ = std::make_unique<std::thread>(&SharedMemoryManager::worker_thread, this);
-    heartbeat_thread_ = std::make_unique<std::thread>(&SharedMemoryManager::heartbeat_thread, this);
+    start_heartbeat();
 
     return true;
 }
@@ -103,7 +167,7 @@ bool SharedMemoryManager::start_consumer() {
     }
 
     // 创建环形缓冲区
-    ring_buffer_ = std::make_unique<RingBuffer>(RingBuffer::Config(config_.instance_name));
+    ring_buffer_ = std::make_unique<RingBuffer>(make_ring_config());
     if (!ring_buffer_->create(RingBuffer::CreateMode::OPEN_ONLY)) {
         return false;
     }
@@ -111,9 +175,14 @@ bool SharedMemoryManager::start_consumer() {
     running_ = true;
     is_consumer_ = true;
 
-    // 启动工作线程
-    worker_thread_ = std::make_unique<std::thread>(&SharedMemoryManager::worker_thread, this);
-    heartbeat_thread_ = std::make_unique<std::thread>(&SharedMemoryManager::heartbeat_thread, this);
+    // 生产者启用了块池时提前打开，生产者 stop 删除块池后仍能读取缓冲区中残留的块消息
+    slab_pool();
+
+    // 推模式启动工作线程；拉模式由调用方取消息
+    if (config_.consumer_worker) {
+        worker_thread_ = std::make_unique<std::thread>(&SharedMemoryManager::worker_thread, this);
+    }
+    start_heartbeat();
 
     return true;
 }
@@ -124,22 +193,36 @@ void SharedMemoryManager::stop() {
     }
 
     running_ = false;
-    heartbeat_active_ = false;
 
-    // 停止环形缓冲区
-    if (ring_buffer_) {
-        ring_buffer_->close();
+    // 先停心跳定时器，等待正在执行的回调结束后才能关闭缓冲区
+    if (heartbeat_timer_.valid()) {
+        TimerService::coarse().cancel_and_wait(heartbeat_timer_);
+        heartbeat_timer_ = TimerHandle();
     }
 
-    // 等待线程结束
+    // 唤醒正在等待的接收者，再等待工作线程结束：它可能正在缓冲区头部的等待字上休眠，关闭缓冲区会解除映射
+    if (ring_buffer_) {
+        ring_buffer_->cancel_waits();
+    }
     if (worker_thread_ && worker_thread_->joinable()) {
         worker_thread_->join();
     }
-    if (heartbeat_thread_ && heartbeat_thread_->joinable()) {
-        heartbeat_thread_->join();
+
+    // 停止环形缓冲区
+    if (ring_buffer_) {
+        ring_buffer_->detach_peer(own_role());
+        ring_buffer_->close();
     }
 
     ring_buffer_.reset();
+    slab_pool_ptr_.store(nullptr, std::memory_order_release);
+    // 生产者删除自己创建的块池 (已打开的消费者不受影响)；多生产者模式下其它生产者可能还在使用
+    bool remove_slab = is_producer_ && slab_pool_ && config_.auto_cleanup &&
+                       config_.producer_mode == ProducerMode::SINGLE;
+    slab_pool_.reset();
+    if (remove_slab) {
+        SlabPool::remove(config_.instance_name);
+    }
     is_producer_ = false;
     is_consumer_ = false;
 }
@@ -149,26 +232,38 @@ bool SharedMemoryManager::send_message(const SharedMemoryMessage& message) {
         return false;
     }
 
+    // 超过上限的消息在启用块池时经块池传递
+    if (message.total_size() > config_.max_message_size && slab_pool_ptr_.load(std::memory_order_acquire)) {
+        return send_via_slab(message);
+    }
+
     // 验证消息
     if (!validate_message(message)) {
         return false;
     }
 
-    // 序列化消息
-    auto serialized = serialize_message(message);
-    if (serialized.empty()) {
+    // 检查消息大小限制
+    size_t total_size = message.total_size();
+    if (total_size > config_.max_message_size) {
         return false;
     }
 
-    // 检查消息大小限制
-    if (serialized.size() > config_.max_message_size) {
-        return false;
+    // 直接序列化进共享内存；预留失败 (如未镜像映射时跨越缓冲区末尾) 时序列化后普通写入
+    bool success = false;
+    {
+        auto lock = lock_send();
+        WriteSlot slot;
+        if (ring_buffer_->reserve(total_size, slot)) {
+            message.serialize_to(slot.data);
+            success = ring_buffer_->commit(slot, total_size);
+        } else {
+            auto serialized = serialize_message(message);
+            success = ring_buffer_->write(serialized.data(), serialized.size());
+        }
     }
 
-    // 写入环形缓冲区
-    bool success = ring_buffer_->write(serialized.data(), serialized.size());
     if (success) {
-        update_statistics(true, serialized.size());
+        update_statistics(true, total_size);
     }
 
     return success;
@@ -179,37 +274,58 @@ bool SharedMemoryManager::send_message(MessageType type, const void* data, size_
     return send_message(message);
 }
 
-bool SharedMemoryManager::receive_message(SharedMemoryMessage& message, int timeout_ms) {
-    if (!running_ || !ring_buffer_) {
+bool SharedMemoryManager::allocate_block(size_t size, SlabBlock& block) {
+    SlabPool* pool = slab_pool_ptr_.load(std::memory_order_acquire);
+    return running_ && pool && pool->allocate(size, block);
+}
+
+bool SharedMemoryManager::send_block(MessageType type, const SlabBlock& block, size_t length) {
+    if (!running_ || !ring_buffer_ || length > block.capacity) {
         return false;
     }
 
-    // 等待数据
-    if (!ring_buffer_->wait_for_data(timeout_ms)) {
+    SharedMemoryMessage message(type, nullptr, 0);
+    if (!send_slab_descriptor(message.get_header(), SlabDescriptor{block.offset, length})) {
         return false;
     }
+    update_statistics(true, sizeof(MessageHeader) + length);
+    return true;
+}
+
+void SharedMemoryManager::free_block(const SlabBlock& block) {
+    if (SlabPool* pool = slab_pool_ptr_.load(std::memory_order_acquire)) {
+        pool->free(block);
+    }
+}
 
-    // 读取数据
-    std::vector<uint8_t> buffer(config_.max_message_size);
-    size_t bytes_read = 0;
+bool SharedMemoryManager::receive_message(SharedMemoryMessage& message, int timeout_ms) {
+    return pull_allowed() && receive_one(message, timeout_ms);
+}
 
-    if (!ring_buffer_->peek(buffer.data(), buffer.size(), bytes_read)) {
+bool SharedMemoryManager::receive_one(SharedMemoryMessage& message, int timeout_ms) {
+    if (!running_ || !ring_buffer_) {
         return false;
     }
 
-    if (bytes_read == 0) {
+    // 每条记录就是一条消息，直接从共享内存反序列化
+    ReadView view;
+    if (!acquire_record(view, timeout_ms)) {
         return false;
     }
 
-    // 反序列化消息
-    if (!deserialize_message(buffer.data(), bytes_read, message)) {
+    uint64_t now = SharedMemoryMessage::now_timestamp();
+    bool valid = deserialize_message(view.data, view.size, message);
+    size_t bytes_read = view.size;
+    // 无法解析的记录也要归还，否则后面的消息都会被卡住
+    ring_buffer_->release(view);
+    valid = valid && load_slab_payload(message, true);
+
+    if (!valid) {
         return false;
     }
 
-    // 跳过已读取的数据
-    ring_buffer_->skip(bytes_read);
-
     update_statistics(false, bytes_read);
+    record_queue_latency(message.get_timestamp(), now);
 
     // 处理消息
     if (is_consumer_) {
@@ -220,23 +336,68 @@ bool SharedMemoryManager::receive_message(SharedMemoryMessage& message, int time
 }
 
 bool SharedMemoryManager::peek_message(SharedMemoryMessage& message) const {
-    if (!running_ || !ring_buffer_) {
+    if (!running_ || !ring_buffer_ || !pull_allowed()) {
         return false;
     }
 
-    // 查看数据
-    std::vector<uint8_t> buffer(config_.max_message_size);
-    size_t bytes_read = 0;
-
-    if (!ring_buffer_->peek(buffer.data(), buffer.size(), bytes_read)) {
+    // 查看数据 (不 release 即不消费)
+    ReadView view;
+    if (ring_buffer_->is_record_framed() ? !ring_buffer_->acquire(view) : !acquire_stream_message(view)) {
         return false;
     }
 
-    if (bytes_read == 0) {
-        return false;
+    return deserialize_message(view.data, view.size, message) && load_slab_payload(message, false);
+}
+
+// 连续的普通消息 (总大小不超过 max_message_size) 用 RingBuffer::write_batch 一次写入；
+// size_of 返回 0 或超过上限的消息交给 send_one 单独发送 (经块池或失败)。
+// size_of/encode/send_one 的下标都是整批中的序号
+template<typename SizeOf, typename Encoder, typename SendOne>
+size_t SharedMemoryManager::send_coalesced(size_t count, SizeOf&& size_of, Encoder&& encode, SendOne&& send_one) {
+    auto batchable = [&](size_t i) {
+        size_t size = size_of(i);
+        return size > 0 && size <= config_.max_message_size;
+    };
+
+    size_t sent = 0;
+    while (sent < count) {
+        // 旧版本的字节流缓冲区和不能合并的消息逐条发送
+        if (!ring_buffer_->is_record_framed() || !batchable(sent)) {
+            if (!send_one(sent)) {
+                break;
+            }
+            ++sent;
+            continue;
+        }
+
+        size_t run = 1;
+        while (sent + run < count && batchable(sent + run)) {
+            ++run;
+        }
+
+        size_t bytes = 0;
+        size_t written = 0;
+        {
+            auto lock = lock_send();
+            written = ring_buffer_->write_batch(
+                run,
+                [&](size_t i) { return size_of(sent + i); },
+                [&](size_t i, uint8_t* out) {
+                    encode(sent + i, out);
+                    bytes += size_of(sent + i);
+                });
+        }
+        if (written > 0) {
+            update_statistics(true, bytes, written);
+        }
+
+        sent += written;
+        if (written < run) {
+            break;  // 缓冲区已满
+        }
     }
 
-    return deserialize_message(buffer.data(), bytes_read, message);
+    return sent;
 }
 
 size_t SharedMemoryManager::send_messages(const std::vector<SharedMemoryMessage>& messages) {
@@ -244,49 +405,90 @@ size_t SharedMemoryManager::send_messages(const std::vector<SharedMemoryMessage>
         return 0;
     }
 
-    size_t sent_count = 0;
-    for (const auto& message : messages) {
-        if (send_message(message)) {
-            sent_count++;
-        } else {
-            break;  // 发送失败，停止发送
-        }
+    return send_coalesced(
+        messages.size(),
+        [&](size_t i) { return validate_message(messages[i]) ? messages[i].total_size() : 0; },
+        [&](size_t i, uint8_t* out) { messages[i].serialize_to(out); },
+        [&](size_t i) { return send_message(messages[i]); });
+}
+
+size_t SharedMemoryManager::send_batch(MessageType type, const std::vector<std::vector<uint8_t>>& payloads) {
+    if (!running_ || !ring_buffer_ || payloads.empty()) {
+        return 0;
     }
 
-    return sent_count;
+    // 整批共用一个时间戳，ID 一次分配
+    uint64_t timestamp = SharedMemoryMessage::now_timestamp();
+    uint32_t first_id = SharedMemoryMessage::allocate_ids(payloads.size());
+    return send_coalesced(
+        payloads.size(),
+        [&](size_t i) { return sizeof(MessageHeader) + payloads[i].size(); },
+        [&](size_t i, uint8_t* out) {
+            SharedMemoryMessage::encode_to(out, first_id + static_cast<uint32_t>(i), type, timestamp,
+                                           payloads[i].data(), payloads[i].size());
+        },
+        [&](size_t i) { return send_message(type, payloads[i].data(), payloads[i].size()); });
 }
 
 size_t SharedMemoryManager::receive_messages(std::vector<SharedMemoryMessage>& messages, size_t max_count, int timeout_ms) {
-    if (!running_ || !ring_buffer_ || max_count == 0) {
-        return 0;
+    size_t count = pull_allowed() ? receive_into(messages, max_count, timeout_ms) : 0;
+    messages.erase(messages.begin() + count, messages.end());
+    return count;
+}
+
+bool SharedMemoryManager::acquire_message(MessageView& view, int timeout_ms) {
+    if (!running_ || !ring_buffer_ || !pull_allowed() || !acquire_record(view.record, timeout_ms)) {
+        return false;
     }
+    uint64_t now = SharedMemoryMessage::now_timestamp();
 
-    messages.clear();
-    messages.reserve(max_count);
+    // 无法解析的记录直接归还
+    if (view.record.size < sizeof(MessageHeader) ||
+        reinterpret_cast<const MessageHeader*>(view.record.data)->payload_size > view.record.size - sizeof(MessageHeader)) {
+        ring_buffer_->release(view.record);
+        return false;
+    }
 
-    auto start_time = std::chrono::steady_clock::now();
+    view.header = reinterpret_cast<const MessageHeader*>(view.record.data);
+    view.payload = view.record.data + sizeof(MessageHeader);
+    view.payload_size = view.header->payload_size;
 
-    for (size_t i = 0; i < max_count; ++i) {
-        // 计算剩余超时时间
-        int remaining_timeout = timeout_ms;
-        if (timeout_ms > 0) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start_time).count();
-            remaining_timeout = timeout_ms - static_cast<int>(elapsed);
-            if (remaining_timeout <= 0) {
-                break;
-            }
+    // 块消息：payload 直接指向块池中的数据
+    if (view.has_flag(MessageFlags::SLAB_HANDLE)) {
+        SlabPool* pool = slab_pool();
+        const uint8_t* data = nullptr;
+        if (view.payload_size == sizeof(SlabDescriptor)) {
+            std::memcpy(&view.slab, view.payload, sizeof(SlabDescriptor));
+            data = pool ? pool->resolve(view.slab) : nullptr;
         }
-
-        SharedMemoryMessage message;
-        if (receive_message(message, remaining_timeout)) {
-            messages.push_back(std::move(message));
-        } else {
-            break;
+        if (data == nullptr) {
+            std::cerr << "SharedMemoryManager: invalid slab descriptor in " << config_.instance_name << std::endl;
+            ring_buffer_->release(view.record);
+            return false;
         }
+        view.payload = data;
+        view.payload_size = view.slab.length;
     }
+    update_statistics(false, view.record.size);
+    record_queue_latency(view.get_timestamp(), now);
+
+    if (view.get_type() == MessageType::HEARTBEAT) {
+        record_heartbeat(view.get_timestamp());
+    }
+    return true;
+}
 
-    return messages.size();
+void SharedMemoryManager::release_message(const MessageView& view) {
+    // 先读出标志再归还记录，记录归还后 header 可能被覆盖
+    bool slab = view.header != nullptr && view.has_flag(MessageFlags::SLAB_HANDLE);
+    if (ring_buffer_) {
+        ring_buffer_->release(view.record);
+    }
+    if (slab) {
+        if (SlabPool* pool = slab_pool()) {
+            pool->free(view.slab.offset);
+        }
+    }
 }
 
 void SharedMemoryManager::register_handler(MessageType type, MessageHandler handler) {
@@ -315,44 +517,90 @@ bool SharedMemoryManager::clear_buffer() {
     }
 
     ring_buffer_->close();
-    ring_buffer_ = std::make_unique<RingBuffer>(RingBuffer::Config(config_.instance_name));
+    ring_buffer_ = std::make_unique<RingBuffer>(make_ring_config());
     return ring_buffer_->create(RingBuffer::CreateMode::CREATE_OR_OPEN);
 }
 
 bool SharedMemoryManager::send_heartbeat() {
-    return send_message(MessageType::HEARTBEAT, nullptr, 0);
+    if (!running_ || !ring_buffer_) {
+        return false;
+    }
+    ring_buffer_->heartbeat(own_role());
+    return true;
 }
 
 bool SharedMemoryManager::wait_for_heartbeat(int timeout_ms) {
-    auto start_time = std::chrono::steady_clock::now();
-
-    while (true) {
-        // 检查是否有最近的心跳
-        if (last_heartbeat_.load() > 0) {
-            auto last_heartbeat_time = std::chrono::milliseconds(last_heartbeat_.load());
-            auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch());
-            auto elapsed = now - last_heartbeat_time;
-
-            if (elapsed.count() < timeout_ms) {
-                return true;
-            }
+    if (!running_ || !ring_buffer_) {
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    int64_t window_ns = int64_t(timeout_ms) * 1000000;
+
+    // 头部心跳没有跨进程通知，按 HEARTBEAT_POLL_INTERVAL 轮询；心跳消息由 record_heartbeat 提前唤醒
+    std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+    for (;;) {
+        // 进程已退出时不再看它最后的心跳
+        RingPeerStatus peer = ring_buffer_->get_peer_status(peer_role());
+        if (peer.pid != 0 && !peer.alive) {
+            return false;
+        }
+        uint64_t last = std::max(peer.heartbeat_ns, last_heartbeat_.load());
+        if (last != 0 && static_cast<int64_t>(SharedMemoryMessage::now_timestamp() - last) < window_ns) {
+            return true;
         }
 
-        // 检查超时
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start_time).count();
-        if (elapsed >= timeout_ms) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
             return false;
         }
+        heartbeat_received_.wait_until(lock, std::min(deadline, now + HEARTBEAT_POLL_INTERVAL));
+    }
+}
+
+bool SharedMemoryManager::is_peer_alive() const {
+    return running_ && ring_buffer_ && ring_buffer_->is_peer_alive(peer_role());
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+RingPeerStatus SharedMemoryManager::get_peer_status() const {
+    return running_ && ring_buffer_ ? ring_buffer_->get_peer_status(peer_role()) : RingPeerStatus{};
+}
+
+uint64_t SharedMemoryManager::get_last_heartbeat_time() const {
+    return std::max(get_peer_status().heartbeat_ns, last_heartbeat_.load());
+}
+
+SharedMemoryManager::Statistics SharedMemoryManager::get_statistics() const {
+    Statistics stats;
+    for (const auto& shard : stats_shards_) {
+        stats.messages_sent += shard.messages_sent.load(std::memory_order_relaxed);
+        stats.messages_received += shard.messages_received.load(std::memory_order_relaxed);
+        stats.bytes_sent += shard.bytes_sent.load(std::memory_order_relaxed);
+        stats.bytes_received += shard.bytes_received.load(std::memory_order_relaxed);
+        stats.errors += shard.errors.load(std::memory_order_relaxed);
+        stats.buffer_high_water = std::max(stats.buffer_high_water, shard.buffer_high_water.load(std::memory_order_relaxed));
+    }
+
+    uint64_t total_messages = stats.messages_sent + stats.messages_received;
+    if (total_messages > 0) {
+        stats.avg_message_size = static_cast<double>(stats.bytes_sent + stats.bytes_received) / total_messages;
     }
+    stats.buffer_high_water = std::max<uint64_t>(stats.buffer_high_water, get_used_space());
+    stats.queue_latency = queue_latency_.snapshot();
+    return stats;
 }
 
 void SharedMemoryManager::reset_statistics() {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    stats_ = Statistics{};
+    // 与并发的更新之间不保证原子，重置瞬间的少量计数可能保留
+    for (auto& shard : stats_shards_) {
+        shard.messages_sent.store(0, std::memory_order_relaxed);
+        shard.messages_received.store(0, std::memory_order_relaxed);
+        shard.bytes_sent.store(0, std::memory_order_relaxed);
+        shard.bytes_received.store(0, std::memory_order_relaxed);
+        shard.errors.store(0, std::memory_order_relaxed);
+        shard.buffer_high_water.store(0, std::memory_order_relaxed);
+    }
+    queue_latency_.reset();
 }
 
 // 私有方法实现
@@ -363,32 +611,43 @@ void SharedMemoryManager::worker_thread() {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     } else if (is_consumer_) {
-        // 消费者工作线程处理消息
+        if (config_.worker_cpu >= 0 && !pin_current_thread(config_.worker_cpu)) {
+            std::cerr << "SharedMemoryManager: failed to pin worker thread to CPU " << config_.worker_cpu << std::endl;
+        }
+
+        // 消费者工作线程批量处理消息 (消息已在 receive_messages 中处理)
+        // 不限时等待，stop() 通过 cancel_waits 唤醒
+        // 批次中的消息对象反复使用，稳定后不再分配内存
+        std::vector<SharedMemoryMessage> batch;
         while (running_) {
-            SharedMemoryMessage message;
-            if (receive_message(message, 100)) {
-                // 消息已在receive_message中处理
-            }
+            receive_into(batch, WORKER_BATCH_SIZE, -1);
         }
     }
 }
 
-void SharedMemoryManager::heartbeat_thread() {
-    heartbeat_active_ = true;
-
-    while (running_ && heartbeat_active_) {
-        if (is_producer_) {
-            send_heartbeat();
-        }
+void SharedMemoryManager::start_heartbeat() {
+    // 在头部登记本进程，对端据此检查存活；之后定时器回调里发送心跳并重新设定自己
+    ring_buffer_->attach_peer(own_role());
+    std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+    heartbeat_timer_ = TimerService::coarse().schedule(
+        std::chrono::milliseconds(config_.heartbeat_interval_ms), [this]() { heartbeat_tick(); });
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(config_.heartbeat_interval_ms));
+void SharedMemoryManager::heartbeat_tick() {
+    // heartbeat_timer_ 在 start_heartbeat 中赋值后才能使用
+    std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+    if (!running_) {
+        return;
     }
+
+    send_heartbeat();
+    TimerService::coarse().restart(heartbeat_timer_, std::chrono::milliseconds(config_.heartbeat_interval_ms));
 }
 
 bool SharedMemoryManager::process_message(const SharedMemoryMessage& message) {
     // 更新心跳时间戳
     if (message.get_type() == MessageType::HEARTBEAT) {
-        last_heartbeat_.store(message.get_timestamp());
+        record_heartbeat(message.get_timestamp());
         return true;
     }
 
@@ -408,25 +667,271 @@ bool SharedMemoryManager::process_message(const SharedMemoryMessage& message) {
     return true;  // 没有处理器也认为是成功的
 }
 
-void SharedMemoryManager::update_statistics(bool sent, size_t bytes) {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
+void SharedMemoryManager::record_heartbeat(uint64_t timestamp) {
+    {
+        std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+        last_heartbeat_.store(timestamp);
+    }
+    heartbeat_received_.notify_all();
+}
+
+size_t SharedMemoryManager::receive_into(std::vector<SharedMemoryMessage>& pool, size_t max_count, int timeout_ms) {
+    if (!running_ || !ring_buffer_ || max_count == 0) {
+        return 0;
+    }
+
+    // 字节流缓冲区只能逐条读取
+    if (!ring_buffer_->is_record_framed()) {
+        if (pool.empty()) {
+            pool.emplace_back();
+        }
+        return receive_one(pool[0], timeout_ms) ? 1 : 0;
+    }
+
+    if (!ring_buffer_->wait_for_data(timeout_ms)) {
+        return 0;
+    }
+
+    // 一次取出所有已到达的消息，只发布一次读位置、通知一次生产者。
+    // pool 中已有的消息对象直接覆盖 (负载容量保留)，不够时才追加。
+    // 这一批消息在此刻之前都已到达，停留时间共用一次取时
+    uint64_t now = SharedMemoryMessage::now_timestamp();
+    size_t count = 0;
+    size_t bytes = 0;
+    ring_buffer_->consume(max_count, [&](const uint8_t* data, size_t size) {
+        if (count == pool.size()) {
+            pool.emplace_back();
+        }
+        if (deserialize_message(data, size, pool[count]) && load_slab_payload(pool[count], true)) {
+            record_queue_latency(pool[count].get_timestamp(), now);
+            bytes += size;
+            ++count;
+        }
+    });
+    if (count > 0) {
+        update_statistics(false, bytes, count);
+    }
+
+    // 空间归还之后再交给处理器
+    if (is_consumer_) {
+        for (size_t i = 0; i < count; ++i) {
+            process_message(pool[i]);
+        }
+    }
 
+    return count;
+}
+
+void SharedMemoryManager::update_statistics(bool sent, size_t bytes, size_t messages) {
+    StatisticsShard& shard = stats_shards_[statistics_shard(STATISTICS_SHARDS)];
+    uint64_t before = 0;
     if (sent) {
-        stats_.messages_sent++;
-        stats_.bytes_sent += bytes;
+        before = shard.messages_sent.fetch_add(messages, std::memory_order_relaxed);
+        shard.bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
     } else {
-        stats_.messages_received++;
-        stats_.bytes_received += bytes;
+        before = shard.messages_received.fetch_add(messages, std::memory_order_relaxed);
+        shard.bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+        // 一批取出的字节在取出之前都在缓冲区里，不必读取生产者的位置
+        raise_high_water(shard.buffer_high_water, bytes);
     }
 
-    // 计算平均消息大小
-    uint64_t total_messages = stats_.messages_sent + stats_.messages_received;
-    if (total_messages > 0) {
-        stats_.avg_message_size = static_cast<double>(stats_.bytes_sent + stats_.bytes_received) / total_messages;
+    // 读取占用要访问双方的位置，按消息数稀疏采样
+    if (before / BUFFER_USAGE_SAMPLE_INTERVAL != (before + messages) / BUFFER_USAGE_SAMPLE_INTERVAL) {
+        raise_high_water(shard.buffer_high_water, get_used_space());
+    }
+}
+
+void SharedMemoryManager::raise_high_water(std::atomic<uint64_t>& peak, uint64_t used) {
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (used > current && !peak.compare_exchange_weak(current, used, std::memory_order_relaxed)) {
+    }
+}
+
+void SharedMemoryManager::record_queue_latency(uint64_t timestamp, uint64_t now) {
+    // 没有时间戳或时间戳晚于当前时刻 (时钟不一致) 的消息不计入
+    if (timestamp != 0 && timestamp <= now) {
+        queue_latency_.record(now - timestamp);
+    }
+}
+
+bool SharedMemoryManager::pull_allowed() const {
+    // 推模式下工作线程独占读端，调用方再取消息会和它争抢同一条记录
+    if (is_consumer_ && config_.consumer_worker) {
+        if (!pull_rejected_.exchange(true)) {
+            std::cerr << "SharedMemoryManager: " << config_.instance_name
+                      << " is drained by its worker thread; set Config::consumer_worker = false to receive directly"
+                      << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemoryManager::acquire_record(ReadView& view, int timeout_ms) {
+    if (ring_buffer_->is_record_framed()) {
+        return ring_buffer_->wait_for_data(timeout_ms) && ring_buffer_->acquire(view);
     }
 
-    // 更新缓冲区使用情况
-    buffer_usage_.store(get_used_space());
+    // 字节流：写入方可能分几次写完一条消息，有数据但不完整时让出 CPU 再检查
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+    for (;;) {
+        int remaining = timeout_ms;
+        if (timeout_ms >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            remaining = static_cast<int>(std::max<int64_t>(left.count(), 0));
+        }
+        if (!ring_buffer_->wait_for_data(remaining)) {
+            return false;
+        }
+        if (acquire_stream_message(view)) {
+            return true;
+        }
+        if (!running_ || (timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline)) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool SharedMemoryManager::acquire_stream_message(ReadView& view) const {
+    ReadView head;
+    if (!ring_buffer_->acquire(head)) {
+        return false;
+    }
+
+    size_t available = ring_buffer_->get_used_space();
+    MessageHeader header;
+    size_t peeked = 0;
+    if (available < sizeof(MessageHeader) ||
+        !ring_buffer_->peek(&header, sizeof(MessageHeader), peeked) || peeked < sizeof(MessageHeader)) {
+        return false;
+    }
+
+    // 长度超过容量说明字节流已损坏，无法重新对齐：把当前连续的数据整段交给调用方，解析失败后丢弃
+    size_t total = sizeof(MessageHeader) + header.payload_size;
+    if (total > ring_buffer_->get_capacity()) {
+        view = head;
+        return true;
+    }
+    if (available < total) {
+        return false;
+    }
+
+    // 只取这一条消息；未镜像映射时跨越缓冲区末尾的消息先拷贝出来
+    view = head;
+    if (head.size < total) {
+        stream_scratch_.resize(total);
+        if (!ring_buffer_->peek(stream_scratch_.data(), total, peeked) || peeked < total) {
+            return false;
+        }
+        view.data = stream_scratch_.data();
+    }
+    view.size = total;
+    view.end = view.begin + total;
+    return true;
+}
+
+RingBuffer::Config SharedMemoryManager::make_ring_config() const {
+    RingBuffer::Config ring_config(config_.instance_name);
+    ring_config.buffer_size = config_.buffer_size;
+    ring_config.producer_mode = config_.producer_mode;
+    ring_config.mirror_mapping = config_.mirror_mapping;
+    ring_config.wait_strategy = config_.wait_strategy;
+    ring_config.spin_iterations = config_.spin_iterations;
+    ring_config.yield_iterations = config_.yield_iterations;
+    ring_config.huge_pages = config_.huge_pages;
+    ring_config.prefault = config_.prefault;
+    ring_config.lock_memory = config_.lock_memory;
+    ring_config.numa_node = config_.numa_node;
+    // 每条消息一条记录，消费者不会把相邻的消息合并
+    ring_config.record_framing = true;
+    return ring_config;
+}
+
+std::unique_lock<std::mutex> SharedMemoryManager::lock_send() {
+    // 多生产者缓冲区本身支持并发写入，不加锁
+    std::unique_lock<std::mutex> lock(send_mutex_, std::defer_lock);
+    if (ring_buffer_->get_producer_mode() == ProducerMode::SINGLE) {
+        lock.lock();
+    }
+    return lock;
+}
+
+SlabPool* SharedMemoryManager::slab_pool() const {
+    SlabPool* pool = slab_pool_ptr_.load(std::memory_order_acquire);
+    if (pool || !is_consumer_) {
+        return pool;
+    }
+
+    // 消费者在收到第一条块消息时打开生产者创建的块池
+    std::lock_guard<std::mutex> lock(slab_mutex_);
+    if (!slab_pool_) {
+        auto opened = std::make_unique<SlabPool>(SlabPool::Config(config_.instance_name));
+        if (!opened->open()) {
+            return nullptr;
+        }
+        slab_pool_ = std::move(opened);
+        slab_pool_ptr_.store(slab_pool_.get(), std::memory_order_release);
+    }
+    return slab_pool_.get();
+}
+
+bool SharedMemoryManager::send_via_slab(const SharedMemoryMessage& message) {
+    if (!message.is_valid()) {
+        return false;
+    }
+
+    SlabBlock block;
+    if (!allocate_block(message.get_payload_size(), block)) {
+        return false;
+    }
+    if (message.get_payload_size() > 0) {
+        std::memcpy(block.data, message.get_payload(), message.get_payload_size());
+    }
+
+    if (!send_slab_descriptor(message.get_header(), SlabDescriptor{block.offset, message.get_payload_size()})) {
+        free_block(block);
+        return false;
+    }
+    update_statistics(true, message.total_size());
+    return true;
+}
+
+bool SharedMemoryManager::send_slab_descriptor(MessageHeader header, const SlabDescriptor& descriptor) {
+    header.payload_size = sizeof(SlabDescriptor);
+    header.flags |= static_cast<uint8_t>(MessageFlags::SLAB_HANDLE);
+
+    uint8_t record[sizeof(MessageHeader) + sizeof(SlabDescriptor)];
+    std::memcpy(record, &header, sizeof(MessageHeader));
+    std::memcpy(record + sizeof(MessageHeader), &descriptor, sizeof(SlabDescriptor));
+    auto lock = lock_send();
+    return ring_buffer_->write(record, sizeof(record));
+}
+
+bool SharedMemoryManager::load_slab_payload(SharedMemoryMessage& message, bool release_block) const {
+    if (!message.has_flag(MessageFlags::SLAB_HANDLE)) {
+        return true;
+    }
+
+    // 把块中的数据取回消息，并归还块 (peek 时不归还)
+    SlabDescriptor descriptor;
+    SlabPool* pool = slab_pool();
+    const uint8_t* data = nullptr;
+    if (message.get_payload_size() == sizeof(SlabDescriptor)) {
+        std::memcpy(&descriptor, message.get_payload(), sizeof(SlabDescriptor));
+        data = pool ? pool->resolve(descriptor) : nullptr;
+    }
+    if (data == nullptr) {
+        std::cerr << "SharedMemoryManager: invalid slab descriptor in " << config_.instance_name << std::endl;
+        return false;
+    }
+
+    message.set_payload(data, descriptor.length);
+    message.clear_flag(MessageFlags::SLAB_HANDLE);
+    if (release_block) {
+        pool->free(descriptor.offset);
+    }
+    return true;
 }
 
 bool SharedMemoryManager::validate_message(const SharedMemoryMessage& message) const {
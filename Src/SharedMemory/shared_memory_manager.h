@@ -1,6 +1,10 @@
 #pragma once
 
+#include "latency_histogram.h"
 #include "ring_buffer.h"
+#include "slab_pool.h"
+#include "timer_wheel.h"
+#include <condition_variable>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
@@ -16,7 +20,7 @@ struct MessageHeader {
     uint32_t message_id{0};     // 消息ID
     uint32_t message_type{0};   // 消息类型
     uint32_t payload_size{0};   // 负载大小
-    uint64_t timestamp{0};      // 时间戳
+    uint64_t timestamp{0};      // 时间戳 (单调时钟纳秒，同一主机上跨进程可比)
     uint8_t flags{0};           // 标志位
     uint8_t reserved[3];        // 保留
 };
@@ -37,7 +41,8 @@ enum class MessageFlags : uint8_t {
     URGENT = 0x01,
     COMPRESSED = 0x02,
     ENCRYPTED = 0x04,
-    LAST_FRAGMENT = 0x08
+    LAST_FRAGMENT = 0x08,
+    SLAB_HANDLE = 0x10     // 负载是 SlabDescriptor，实际数据在块池中
 };
 
 // 共享内存消息
@@ -52,6 +57,7 @@ public:
     uint32_t get_id() const { return header_.message_id; }
     uint64_t get_timestamp() const { return header_.timestamp; }
     uint32_t get_payload_size() const { return header_.payload_size; }
+    const MessageHeader& get_header() const { return header_; }
     const uint8_t* get_payload() const { return payload_.data(); }
     uint8_t* get_mutable_payload() { return payload_.data(); }
 
@@ -59,10 +65,17 @@ public:
     void set_type(MessageType type) { header_.message_type = static_cast<uint32_t>(type); }
     void set_payload(const void* data, size_t size);
     void set_flag(MessageFlags flag) { header_.flags |= static_cast<uint8_t>(flag); }
+    void clear_flag(MessageFlags flag) { header_.flags &= static_cast<uint8_t>(~static_cast<uint8_t>(flag)); }
     bool has_flag(MessageFlags flag) const { return (header_.flags & static_cast<uint8_t>(flag)) != 0; }
 
+    // 不经过消息对象，直接把一条消息编码到 out (sizeof(MessageHeader) + size 字节)；批量发送时使用
+    static void encode_to(uint8_t* out, uint32_t id, MessageType type, uint64_t timestamp, const void* data, size_t size);
+    static uint32_t allocate_ids(size_t count);  // 返回连续 count 个消息 ID 中的第一个
+    static uint64_t now_timestamp();             // 消息时间戳 (单调时钟纳秒)
+
     // 序列化/反序列化
     std::vector<uint8_t> serialize() const;
+    void serialize_to(uint8_t* out) const;  // 写入 total_size() 字节
     bool deserialize(const uint8_t* data, size_t size);
 
     // 工具方法
@@ -75,16 +88,55 @@ private:
     static std::atomic<uint32_t> next_id_;
 };
 
+// 共享内存中一条消息的视图：header/payload 直接指向缓冲区 (经块池传递的消息 payload 指向块)，
+// release_message 之前有效
+struct MessageView {
+    const MessageHeader* header{nullptr};
+    const uint8_t* payload{nullptr};
+    size_t payload_size{0};
+    ReadView record;      // 归还时使用
+    SlabDescriptor slab;  // 归还时使用
+
+    MessageType get_type() const { return static_cast<MessageType>(header->message_type); }
+    uint32_t get_id() const { return header->message_id; }
+    uint64_t get_timestamp() const { return header->timestamp; }
+    size_t get_payload_size() const { return payload_size; }
+    bool has_flag(MessageFlags flag) const { return (header->flags & static_cast<uint8_t>(flag)) != 0; }
+};
+
 // 共享内存管理器
 class SharedMemoryManager {
 public:
     // 配置
     struct Config {
-        size_t buffer_size{1024 * 1024};  // 缓冲区大小
+        size_t buffer_size{1024 * 1024};  // 缓冲区大小 (按记录读写，须为 8 的倍数)
         size_t max_message_size{64 * 1024};  // 最大消息大小
         std::string instance_name;     // 实例名称
         bool auto_cleanup{true};       // 自动清理
         int heartbeat_interval_ms{1000};  // 心跳间隔
+        // MULTI 允许多个进程/线程同时向同一缓冲区发送，每条消息是一条独立记录
+        ProducerMode producer_mode{ProducerMode::SINGLE};
+        // 数据区镜像映射 (见 RingBuffer::Config::mirror_mapping)
+        bool mirror_mapping{false};
+        // 接收等待策略 (见 RingBuffer::Config)；低延迟场景用 BUSY_POLL 并把工作线程绑定到独占的 CPU
+        WaitStrategy wait_strategy{WaitStrategy::ADAPTIVE};
+        int spin_iterations{2048};
+        int yield_iterations{-1};
+        int worker_cpu{-1};            // 消费者工作线程绑定的 CPU，-1 表示不绑定
+        // 消费者工作线程：true (推模式) 时 start_consumer 启动工作线程，把到达的消息交给已注册的处理器，
+        // 此时 receive_message/receive_messages/acquire_message/peek_message 直接返回 false。
+        // false (拉模式) 时不启动，由调用方在一个线程里用上述接口取消息，处理器在取出时调用
+        bool consumer_worker{true};
+        // 内存选项 (见 RingBuffer::Config)：大页、预取、mlock、NUMA 节点
+        HugePagePolicy huge_pages{HugePagePolicy::NONE};
+        bool prefault{false};
+        bool lock_memory{false};
+        int numa_node{-1};
+        // 块池 (生产者创建，消费者在启动或收到第一条块消息时打开)：两者都大于 0 时启用。
+        // 超过 max_message_size 的消息经块池传递，环形缓冲区中只有描述符；处理器和 receive_message
+        // 收到的负载仍从块中拷回消息对象，只有 acquire_message 原地读取
+        size_t slab_block_size{0};
+        size_t slab_block_count{0};
 
         Config(const std::string& name = "BitRPC_SharedMemory")
             : instance_name(name) {}
@@ -108,11 +160,29 @@ public:
     // 消息发送/接收
     bool send_message(const SharedMemoryMessage& message);
     bool send_message(MessageType type, const void* data, size_t size);
+    // 以下接收接口只能在拉模式 (Config::consumer_worker = false) 下使用，且同一时刻只能有一个线程调用。
+    // message 的负载容量会被复用，同一个对象反复接收时不再分配内存
     bool receive_message(SharedMemoryMessage& message, int timeout_ms = -1);
     bool peek_message(SharedMemoryMessage& message) const;
 
+    // 零拷贝接收：view 指向共享内存，处理完后必须 release_message，在此之前不要再取消息。
+    // 不经过已注册的处理器 (心跳仍会被记录)
+    bool acquire_message(MessageView& view, int timeout_ms = -1);
+    void release_message(const MessageView& view);
+
+    // 经块池发送：allocate_block 取得一块共享内存，写入后 send_block 只把描述符写入环形缓冲区，
+    // 块由接收方归还。send_block 失败时块仍归调用方，可重试或 free_block
+    bool allocate_block(size_t size, SlabBlock& block);
+    bool send_block(MessageType type, const SlabBlock& block, size_t length);
+    void free_block(const SlabBlock& block);
+
     // 批量操作
+    // 连续的消息一次预留空间、直接编码进缓冲区，只发布一次写位置、通知一次消费者；
+    // 经块池传递的大消息逐条发送。遇到无效消息或缓冲区已满时停止，返回发送的条数
     size_t send_messages(const std::vector<SharedMemoryMessage>& messages);
+    size_t send_batch(MessageType type, const std::vector<std::vector<uint8_t>>& payloads);
+    // 等待至有消息到达，然后一次取出最多 max_count 条已到达的消息 (不再等满 max_count 条)。
+    // messages 中已有的消息对象会被复用，返回后 messages.size() 等于取出的条数
     size_t receive_messages(std::vector<SharedMemoryMessage>& messages, size_t max_count, int timeout_ms = -1);
 
     // 消息处理器注册
@@ -124,7 +194,7 @@ public:
     bool is_producer() const { return is_producer_; }
     bool is_consumer() const { return is_consumer_; }
     size_t get_pending_count() const { return pending_count_; }
-    size_t get_buffer_usage() const { return buffer_usage_; }
+    size_t get_buffer_usage() const { return get_used_space(); }
 
     // 统计信息
     struct Statistics {
@@ -134,14 +204,28 @@ public:
         uint64_t bytes_received{0};
         uint64_t errors{0};
         double avg_message_size{0.0};
+        // 本端观察到的缓冲区占用峰值 (字节)：每个统计分片每 64 条消息读一次占用，
+        // 再加上接收时每批取出的字节数和查询时的占用，是近似值
+        uint64_t buffer_high_water{0};
+        // 消息在队列中的停留时间 (纳秒)：从发送方创建消息到接收方取出，接收方记录
+        LatencyHistogram::Snapshot queue_latency;
     };
 
-    const Statistics& get_statistics() const { return stats_; }
+    // 计数按线程分片、以 relaxed 原子累加，收发路径不加锁；这里汇总成一份快照
+    Statistics get_statistics() const;
     void reset_statistics();
 
     // 心跳和健康检查
+    // 心跳和 pid 写在缓冲区头部 (RingBuffer::attach_peer/heartbeat)，数据区只传数据。
+    // 生产者和消费者的心跳都由共享的粗粒度定时器 (TimerService::coarse) 发送，不占用线程
     bool send_heartbeat();
+    // 等待对端 (消费者等生产者，生产者等消费者) 在最近 timeout_ms 内有心跳；对端进程已退出时立即返回 false。
+    // 旧版本生产者经缓冲区发送的心跳消息同样有效
     bool wait_for_heartbeat(int timeout_ms = 2000);
+    // 对端进程是否仍然存在 (按头部中的 pid 检查，不等待)
+    bool is_peer_alive() const;
+    RingPeerStatus get_peer_status() const;
+    uint64_t get_last_heartbeat_time() const;  // 对端最近一次心跳 (单调时钟纳秒)，0 表示还没有
 
     // 缓冲区管理
     size_t get_free_space() const;
@@ -151,9 +235,30 @@ public:
 private:
     // 内部方法
     void worker_thread();
-    void heartbeat_thread();
+    void start_heartbeat();
+    void heartbeat_tick();
+    RingPeer own_role() const { return is_producer_ ? RingPeer::PRODUCER : RingPeer::CONSUMER; }
+    RingPeer peer_role() const { return is_producer_ ? RingPeer::CONSUMER : RingPeer::PRODUCER; }
+    void record_heartbeat(uint64_t timestamp);
+    size_t receive_into(std::vector<SharedMemoryMessage>& pool, size_t max_count, int timeout_ms);
+    bool receive_one(SharedMemoryMessage& message, int timeout_ms);
+    bool pull_allowed() const;
     bool process_message(const SharedMemoryMessage& message);
-    void update_statistics(bool sent, size_t bytes);
+    void update_statistics(bool sent, size_t bytes, size_t messages = 1);
+    void raise_high_water(std::atomic<uint64_t>& peak, uint64_t used);
+    void record_queue_latency(uint64_t timestamp, uint64_t now);
+    template<typename SizeOf, typename Encoder, typename SendOne>
+    size_t send_coalesced(size_t count, SizeOf&& size_of, Encoder&& encode, SendOne&& send_one);
+    RingBuffer::Config make_ring_config() const;
+    std::unique_lock<std::mutex> lock_send();
+    SlabPool* slab_pool() const;
+    bool send_via_slab(const SharedMemoryMessage& message);
+    bool send_slab_descriptor(MessageHeader header, const SlabDescriptor& descriptor);
+    bool load_slab_payload(SharedMemoryMessage& message, bool release_block) const;
+    // 取出下一条消息所在的记录：按记录缓冲区每条记录一条消息；
+    // 字节流缓冲区 (RB_Write 写入、不按记录) 按 MessageHeader 切出一条完整消息
+    bool acquire_record(ReadView& view, int timeout_ms);
+    bool acquire_stream_message(ReadView& view) const;
 
     // 消息处理
     bool validate_message(const SharedMemoryMessage& message) const;
@@ -163,27 +268,47 @@ private:
 private:
     Config config_;
     std::unique_ptr<RingBuffer> ring_buffer_;
+    // 块池：生产者在 start_producer 中创建，消费者按需打开
+    mutable std::unique_ptr<SlabPool> slab_pool_;
+    mutable std::atomic<SlabPool*> slab_pool_ptr_{nullptr};
+    mutable std::mutex slab_mutex_;
     std::atomic<bool> running_{false};
     std::atomic<bool> is_producer_{false};
     std::atomic<bool> is_consumer_{false};
+    // 单生产者缓冲区同一时刻只能有一个写入方：调用方从多个线程发送时在这里串行化
+    std::mutex send_mutex_;
+    // 字节流缓冲区中跨越末尾的消息拷贝到这里再交给调用方 (只有消费者线程使用)
+    mutable std::vector<uint8_t> stream_scratch_;
+    mutable std::atomic<bool> pull_rejected_{false};  // 推模式下调用接收接口的错误只打印一次
 
     // 线程
     std::unique_ptr<std::thread> worker_thread_;
-    std::unique_ptr<std::thread> heartbeat_thread_;
 
     // 消息处理器
     std::unordered_map<MessageType, MessageHandler> handlers_;
     std::mutex handlers_mutex_;
 
+    // 统计：每个线程固定累加其中一个分片，分片各占一个缓存行
+    struct alignas(RING_BUFFER_CACHE_LINE) StatisticsShard {
+        std::atomic<uint64_t> messages_sent{0};
+        std::atomic<uint64_t> messages_received{0};
+        std::atomic<uint64_t> bytes_sent{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> buffer_high_water{0};
+    };
+    static constexpr size_t STATISTICS_SHARDS = 16;
+    StatisticsShard stats_shards_[STATISTICS_SHARDS];
+    LatencyHistogram queue_latency_;
+
     // 同步
-    mutable std::mutex stats_mutex_;
-    Statistics stats_;
     std::atomic<size_t> pending_count_{0};
-    std::atomic<size_t> buffer_usage_{0};
 
-    // 心跳
+    // 心跳 (last_heartbeat_ 只记录经缓冲区收到的心跳消息)
     std::atomic<uint64_t> last_heartbeat_{0};
-    std::atomic<bool> heartbeat_active_{false};
+    std::mutex heartbeat_mutex_;
+    std::condition_variable heartbeat_received_;
+    TimerHandle heartbeat_timer_;
 };
 
 // 多实例管理器
@@ -208,9 +333,11 @@ private:
 
 // 便捷工厂函数
 inline std::shared_ptr<SharedMemoryManager> create_producer_manager(
-    const std::string& name, size_t buffer_size = 1024 * 1024) {
+    const std::string& name, size_t buffer_size = 1024 * 1024,
+    ProducerMode producer_mode = ProducerMode::SINGLE) {
     auto config = SharedMemoryManager::Config(name);
     config.buffer_size = buffer_size;
+    config.producer_mode = producer_mode;
     auto manager = std::make_shared<SharedMemoryManager>(config);
 
     if (manager->start_producer()) {
@@ -0,0 +1,315 @@
+#include "slab_pool.h"
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace bitrpc {
+namespace shared_memory {
+
+namespace {
+
+constexpr uint32_t BLOCK_FREE = 0;
+constexpr uint32_t BLOCK_ALLOCATED = 1;
+constexpr std::chrono::seconds INITIALIZE_WAIT(1);  // 等待另一方完成初始化的时长
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t make_head(uint64_t tag, uint32_t link) {
+    return (tag << 32) | link;
+}
+
+} // namespace
+
+SlabPool::SlabPool(const Config& config) : config_(config) {
+}
+
+SlabPool::~SlabPool() {
+    close();
+}
+
+bool SlabPool::create() {
+    if (header_) {
+        return true;
+    }
+
+    if (config_.block_size == 0 || config_.block_count == 0 || config_.block_count >= UINT32_MAX) {
+        std::cerr << "SlabPool: block_size and block_count must be positive" << std::endl;
+        return false;
+    }
+
+    const size_t block_size = align_up(config_.block_size, BLOCK_ALIGNMENT);
+    const size_t block_count = config_.block_count;
+    block_size_ = block_size;
+    block_count_ = block_count;
+    bool existed = false;
+    if (!map(true, &existed)) {
+        close();
+        if (!existed) {
+            std::cerr << "SlabPool: failed to create " << config_.name << std::endl;
+            return false;
+        }
+        return open_existing(block_size, block_count);
+    }
+
+    header_->initialized.store(0, std::memory_order_release);
+    header_->magic_number = MAGIC_NUMBER;
+    header_->version = VERSION;
+    header_->block_size = block_size_;
+    header_->block_count = static_cast<uint32_t>(block_count_);
+    header_->data_offset = static_cast<uint64_t>(data_ - static_cast<uint8_t*>(mapped_memory_));
+
+    // 所有块串成空闲链表，序号小的在前
+    for (uint32_t i = 0; i < block_count_; ++i) {
+        entry(i)->state.store(BLOCK_FREE, std::memory_order_relaxed);
+        entry(i)->next.store(i + 1 < block_count_ ? i + 2 : 0, std::memory_order_relaxed);
+    }
+    uint64_t tag = (header_->free_head.load(std::memory_order_relaxed) >> 32) + 1;
+    header_->free_head.store(make_head(tag, 1), std::memory_order_relaxed);
+    header_->free_blocks.store(static_cast<uint32_t>(block_count_), std::memory_order_relaxed);
+    header_->initialized.store(1, std::memory_order_release);
+    return true;
+}
+
+bool SlabPool::open() {
+    if (header_) {
+        return true;
+    }
+
+    if (!map(false) || !attach(true)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SlabPool::open_existing(size_t block_size, size_t block_count) {
+    // 已存在的块池可能正被其它生产者使用，不能重新初始化 (会作废它们已分配和在途的块)。
+    // 创建方可能还在初始化，稍等后再打开
+    auto deadline = std::chrono::steady_clock::now() + INITIALIZE_WAIT;
+    while (!map(false) || !attach(false)) {
+        close();
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::cerr << "SlabPool: pool " << config_.name << " exists but is not initialized" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (block_size_ != block_size || block_count_ != block_count) {
+        std::cerr << "SlabPool: pool " << config_.name << " already exists with " << block_count_ << " blocks of "
+                  << block_size_ << " bytes, expected " << block_count << " of " << block_size << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SlabPool::attach(bool report) {
+    if (header_->magic_number != MAGIC_NUMBER || header_->version != VERSION ||
+        header_->initialized.load(std::memory_order_acquire) != 1) {
+        if (report) {
+            std::cerr << "SlabPool: invalid pool " << config_.name << std::endl;
+        }
+        return false;
+    }
+
+    block_size_ = header_->block_size;
+    block_count_ = header_->block_count;
+    size_t required = header_->data_offset + block_size_ * block_count_;
+#ifndef _WIN32
+    if (mapped_size_ < required) {
+        if (report) {
+            std::cerr << "SlabPool: pool " << config_.name << " is truncated" << std::endl;
+        }
+        return false;
+    }
+#endif
+    (void)required;
+    data_ = static_cast<uint8_t*>(mapped_memory_) + header_->data_offset;
+    return true;
+}
+
+void SlabPool::close() {
+    if (mapped_memory_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapped_memory_);
+#else
+        munmap(mapped_memory_, mapped_size_);
+#endif
+        mapped_memory_ = nullptr;
+    }
+#ifdef _WIN32
+    if (file_mapping_ != nullptr) {
+        CloseHandle(file_mapping_);
+        file_mapping_ = nullptr;
+    }
+#else
+    if (file_descriptor_ != -1) {
+        ::close(file_descriptor_);
+        file_descriptor_ = -1;
+    }
+#endif
+
+    header_ = nullptr;
+    data_ = nullptr;
+}
+
+bool SlabPool::allocate(size_t size, SlabBlock& block) {
+    if (!header_ || size > block_size_) {
+        return false;
+    }
+
+    // Treiber 栈出栈；链表头带版本号，块被取走又放回时 CAS 会失败
+    uint64_t head = header_->free_head.load(std::memory_order_acquire);
+    uint32_t index = 0;
+    for (;;) {
+        uint32_t link = static_cast<uint32_t>(head);
+        if (link == 0) {
+            return false;
+        }
+        index = link - 1;
+        uint32_t next = entry(index)->next.load(std::memory_order_relaxed);
+        if (header_->free_head.compare_exchange_weak(head, make_head((head >> 32) + 1, next),
+                                                     std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    entry(index)->state.store(BLOCK_ALLOCATED, std::memory_order_relaxed);
+    header_->free_blocks.fetch_sub(1, std::memory_order_relaxed);
+
+    block.offset = uint64_t(index) * block_size_;
+    block.data = data_ + block.offset;
+    block.capacity = block_size_;
+    return true;
+}
+
+bool SlabPool::free(uint64_t offset) {
+    uint32_t index = 0;
+    if (!header_ || !block_index(offset, index)) {
+        return false;
+    }
+
+    uint32_t expected = BLOCK_ALLOCATED;
+    if (!entry(index)->state.compare_exchange_strong(expected, BLOCK_FREE, std::memory_order_acq_rel)) {
+        std::cerr << "SlabPool: block at offset " << offset << " is not allocated" << std::endl;
+        return false;
+    }
+
+    push_free(index);
+    return true;
+}
+
+const uint8_t* SlabPool::resolve(const SlabDescriptor& descriptor) const {
+    uint32_t index = 0;
+    if (!header_ || !block_index(descriptor.offset, index) || descriptor.length > block_size_ ||
+        entry(index)->state.load(std::memory_order_acquire) != BLOCK_ALLOCATED) {
+        return nullptr;
+    }
+    return data_ + descriptor.offset;
+}
+
+size_t SlabPool::get_free_blocks() const {
+    return header_ ? header_->free_blocks.load(std::memory_order_relaxed) : 0;
+}
+
+bool SlabPool::remove(const std::string& name) {
+#ifdef _WIN32
+    (void)name;
+    return true;
+#else
+    std::string shm_name = "/BitRPC_Slab_" + name;
+    return shm_unlink(shm_name.c_str()) == 0;
+#endif
+}
+
+bool SlabPool::map(bool create, bool* existed) {
+    // 布局：头部、块表、按页对齐的数据区
+    size_t data_offset = align_up(sizeof(SlabPoolHeader) + block_count_ * sizeof(SlabBlockEntry), BLOCK_ALIGNMENT);
+
+#ifdef _WIN32
+    std::string mapping_name = "Local\\BitRPC_Slab_" + config_.name;
+    if (create) {
+        mapped_size_ = data_offset + block_size_ * block_count_;
+        file_mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                           static_cast<DWORD>(uint64_t(mapped_size_) >> 32),
+                                           static_cast<DWORD>(mapped_size_), mapping_name.c_str());
+    } else {
+        file_mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mapping_name.c_str());
+    }
+    if (file_mapping_ == nullptr) {
+        return false;
+    }
+    if (create && GetLastError() == ERROR_ALREADY_EXISTS) {
+        *existed = true;
+        return false;
+    }
+    mapped_memory_ = MapViewOfFile(file_mapping_, FILE_MAP_ALL_ACCESS, 0, 0, create ? mapped_size_ : 0);
+    if (mapped_memory_ == nullptr) {
+        return false;
+    }
+#else
+    std::string shm_name = "/BitRPC_Slab_" + config_.name;
+    // 创建时用 O_EXCL，只有新建的一方初始化
+    file_descriptor_ = shm_open(shm_name.c_str(), (create ? O_CREAT | O_EXCL : 0) | O_RDWR, 0666);
+    if (file_descriptor_ == -1) {
+        if (create && errno == EEXIST) {
+            *existed = true;
+        }
+        return false;
+    }
+
+    if (create) {
+        mapped_size_ = data_offset + block_size_ * block_count_;
+        if (ftruncate(file_descriptor_, static_cast<off_t>(mapped_size_)) == -1) {
+            return false;
+        }
+    } else {
+        struct stat st;
+        if (fstat(file_descriptor_, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(SlabPoolHeader)) {
+            return false;
+        }
+        mapped_size_ = static_cast<size_t>(st.st_size);
+    }
+
+    mapped_memory_ = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor_, 0);
+    if (mapped_memory_ == MAP_FAILED) {
+        mapped_memory_ = nullptr;
+        return false;
+    }
+#endif
+
+    header_ = static_cast<SlabPoolHeader*>(mapped_memory_);
+    if (create) {
+        data_ = static_cast<uint8_t*>(mapped_memory_) + data_offset;
+    }
+    return true;
+}
+
+SlabBlockEntry* SlabPool::entry(uint32_t index) const {
+    auto* base = reinterpret_cast<uint8_t*>(header_) + sizeof(SlabPoolHeader);
+    return reinterpret_cast<SlabBlockEntry*>(base) + index;
+}
+
+bool SlabPool::block_index(uint64_t offset, uint32_t& index) const {
+    if (offset % block_size_ != 0 || offset / block_size_ >= block_count_) {
+        return false;
+    }
+    index = static_cast<uint32_t>(offset / block_size_);
+    return true;
+}
+
+void SlabPool::push_free(uint32_t index) {
+    header_->free_blocks.fetch_add(1, std::memory_order_relaxed);
+    uint64_t head = header_->free_head.load(std::memory_order_relaxed);
+    do {
+        entry(index)->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!header_->free_head.compare_exchange_weak(head, make_head((head >> 32) + 1, index + 1),
+                                                       std::memory_order_release, std::memory_order_relaxed));
+}
+
+} // namespace shared_memory
+} // namespace bitrpc
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ring_buffer.h"
+
+namespace bitrpc {
+namespace shared_memory {
+
+// 共享内存块池：与环形缓冲区并列的一段共享内存，划分为固定大小的块。
+// 大负载 (如数 MB 的图像帧) 写入块中，环形缓冲区里只传递 SlabDescriptor；
+// 消费者原地读取后把块归还到无锁空闲链表，负载既不经过环形缓冲区拷贝，也不需要增大缓冲区
+
+// 块在池中的位置，可跨进程传递
+struct SlabDescriptor {
+    uint64_t offset{0};  // 块相对数据区起点的偏移 (块大小的整数倍)
+    uint64_t length{0};  // 有效负载长度
+};
+
+// 生产者分配到的块
+struct SlabBlock {
+    uint8_t* data{nullptr};  // 可直接写入的共享内存
+    size_t capacity{0};      // 块大小
+    uint64_t offset{0};      // 内部使用，同 SlabDescriptor::offset
+};
+
+// 块池头部，后面依次是 block_count 个块表项和 (按页对齐的) 数据区
+struct SlabPoolHeader {
+    alignas(RING_BUFFER_CACHE_LINE) uint32_t magic_number{0};
+    uint32_t version{0};
+    uint64_t block_size{0};
+    uint32_t block_count{0};
+    std::atomic<uint32_t> initialized{0};
+    uint64_t data_offset{0};
+    // 空闲链表头：高 32 位为版本号 (防 ABA)，低 32 位为块序号 + 1，0 表示链表为空
+    alignas(RING_BUFFER_CACHE_LINE) std::atomic<uint64_t> free_head{0};
+    std::atomic<uint32_t> free_blocks{0};
+};
+
+// 块表项
+struct SlabBlockEntry {
+    std::atomic<uint32_t> next{0};   // 空闲链表中下一块的序号 + 1
+    std::atomic<uint32_t> state{0};  // 0 空闲，1 已分配；用于发现重复释放和无效描述符
+};
+
+class SlabPool {
+public:
+    struct Config {
+        size_t block_size{4 * 1024 * 1024};  // 块大小，向上取整到页大小；打开方以头部为准
+        size_t block_count{8};               // 块数量
+        std::string name;
+
+        Config(const std::string& pool_name = "BitRPC_Slab")
+            : name(pool_name) {}
+    };
+
+    explicit SlabPool(const Config& config = Config{});
+    ~SlabPool();
+
+    // 禁用拷贝
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // 创建方新建并初始化块池；块池已存在时 (如另一个多生产者) 直接打开，不重新初始化，
+    // 此时块大小和数量必须与已有的一致。打开方使用已存在的块池
+    bool create();
+    bool open();
+    void close();
+
+    // 分配一个能容纳 size 字节的块，没有空闲块时返回 false。任何一方都可以分配和释放
+    bool allocate(size_t size, SlabBlock& block);
+    bool free(const SlabBlock& block) { return free(block.offset); }
+    bool free(uint64_t offset);
+
+    // 描述符 <-> 共享内存
+    SlabDescriptor describe(const SlabBlock& block, size_t length) const { return SlabDescriptor{block.offset, length}; }
+    // 校验描述符 (对齐、范围、块已分配) 后返回负载地址，无效时返回 nullptr
+    const uint8_t* resolve(const SlabDescriptor& descriptor) const;
+
+    // 状态查询
+    bool is_open() const { return header_ != nullptr; }
+    size_t get_block_size() const { return block_size_; }
+    size_t get_block_count() const { return block_count_; }
+    size_t get_free_blocks() const;
+    std::string get_name() const { return config_.name; }
+
+    static bool remove(const std::string& name);
+
+private:
+    bool map(bool create, bool* existed = nullptr);  // create 时已存在则置 *existed 并返回 false
+    bool attach(bool report);  // 校验已映射的头部并取出布局
+    bool open_existing(size_t block_size, size_t block_count);
+    SlabBlockEntry* entry(uint32_t index) const;
+    bool block_index(uint64_t offset, uint32_t& index) const;
+    void push_free(uint32_t index);
+
+    Config config_;
+    SlabPoolHeader* header_{nullptr};
+    uint8_t* data_{nullptr};
+    size_t block_size_{0};
+    size_t block_count_{0};
+    void* mapped_memory_{nullptr};
+    size_t mapped_size_{0};
+#ifdef _WIN32
+    HANDLE file_mapping_{nullptr};
+#else
+    int file_descriptor_{-1};
+#endif
+
+    static constexpr uint32_t MAGIC_NUMBER = 0x42535342;  // "BSSB"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t BLOCK_ALIGNMENT = 4096;  // 块和数据区按页对齐
+};
+
+} // namespace shared_memory
+} // namespace bitrpc